@@ -0,0 +1,131 @@
+#pragma once
+
+/*
+ * C interface of the minefield engine, built as the minefield.capi shared library.
+ *
+ * A batch owns any number of independent games on boards of the same configuration. Every call steps all of
+ * them one round using placement and guess arrays owned by the caller, and board state is read through
+ * pointers into the engine's own storage, so nothing is copied on the way out.
+ *
+ * ABI rules: handles are opaque, every struct starts with struct_size so fields can only be appended,
+ * and enum values are fixed integers. MF_API_VERSION_MAJOR changes only when one of these rules is broken,
+ * and it is also the SOVERSION of the library.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MF_API_VERSION_MAJOR 1
+#define MF_API_VERSION_MINOR 0
+#define MF_API_VERSION ((MF_API_VERSION_MAJOR << 16) | MF_API_VERSION_MINOR)
+
+#if defined(_WIN32)
+#if defined(minefield_capi_EXPORTS)
+#define MF_API __declspec(dllexport)
+#else
+#define MF_API __declspec(dllimport)
+#endif
+#else
+#define MF_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    typedef enum mf_status
+    {
+        MF_OK = 0,
+        MF_INVALID_ARGUMENT = 1, /* null pointer, bad size or a game index out of range */
+        MF_INVALID_MOVE = 2,     /* wrong count, a cell outside the board, disabled or listed twice */
+        MF_GAME_OVER = 3,        /* the game was already decided; its round is skipped */
+        MF_OUT_OF_MEMORY = 4
+    } mf_status;
+
+    typedef enum mf_outcome
+    {
+        MF_ONGOING = 0,
+        MF_DRAW = 1,
+        MF_FIRST_SEAT_WINS = 2,
+        MF_SECOND_SEAT_WINS = 3
+    } mf_outcome;
+
+    /* bits of every cell word; each one is a bitplane of the board */
+    enum
+    {
+        MF_CELL_DISABLED = 0x01,
+        MF_CELL_HAS_MINE = 0x02,
+        MF_CELL_WAS_GUESSED = 0x04,
+        MF_CELL_SELF_DETONATED = 0x08,
+        MF_CELL_HAD_COLLISION = 0x10
+    };
+
+    typedef struct mf_batch mf_batch;
+
+    typedef struct mf_batch_config
+    {
+        uint32_t struct_size; /* sizeof(mf_batch_config) */
+        uint32_t width;
+        uint32_t height;
+        uint32_t mines;
+        uint32_t games;
+    } mf_batch_config;
+
+    typedef struct mf_position
+    {
+        uint32_t column;
+        uint32_t row;
+    } mf_position;
+
+    /* One round of one game. Each seat places min(its remaining mines, free cells) mines and guesses
+       min(the opponent's remaining mines, free cells left after collisions) cells; call
+       mf_batch_expected_counts for both numbers. */
+    typedef struct mf_round_input
+    {
+        uint32_t struct_size; /* sizeof(mf_round_input) */
+        const mf_position *mines[2];
+        const mf_position *guesses[2];
+        uint32_t mine_count[2];
+        uint32_t guess_count[2];
+    } mf_round_input;
+
+    typedef struct mf_round_result
+    {
+        uint32_t struct_size; /* sizeof(mf_round_result), set by the caller */
+        int32_t status; /* mf_status of this game's round */
+        int32_t outcome; /* mf_outcome after the round */
+        uint32_t remaining_mines[2];
+        uint32_t hits[2]; /* opponent mines found by each seat */
+        uint32_t collisions;
+    } mf_round_result;
+
+    /* read-only view of a board; cells stay valid until the batch is destroyed */
+    typedef struct mf_board_view
+    {
+        uint32_t struct_size; /* sizeof(mf_board_view), set by the caller */
+        const uint32_t *cells; /* column-major: cell (column, row) is cells[column * height + row] */
+        uint32_t width;
+        uint32_t height;
+    } mf_board_view;
+
+    MF_API uint32_t mf_api_version(void);
+
+    MF_API mf_status mf_batch_create(const mf_batch_config *config, mf_batch **batch);
+    MF_API void mf_batch_destroy(mf_batch *batch);
+
+    /* mine and guess counts expected from each seat in the next round; collisions can only lower the guesses */
+    MF_API mf_status mf_batch_expected_counts(const mf_batch *batch, uint32_t game, uint32_t mine_count[2], uint32_t max_guess_count[2]);
+
+    /* Plays one round of games [first, first + count) with inputs[i] for game first + i. Every game gets its
+       result even when another one fails; the call returns the first failing status. Mines are checked
+       before anything changes, guesses once collisions are known, so a game failing with MF_INVALID_MOVE
+       keeps its state from the start of the round. Both arrays are walked with the struct_size of their first
+       element as the stride, so callers built against another minor version pass their own layout. */
+    MF_API mf_status mf_batch_step(mf_batch *batch, uint32_t first, uint32_t count, const mf_round_input *inputs, mf_round_result *results);
+
+    MF_API mf_status mf_batch_board(const mf_batch *batch, uint32_t game, mf_board_view *view);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,203 @@
+#pragma once
+
+#include "minefield/engine/archive.h"
+#include "minefield/engine/sim.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Map-reduce over replay archives. An analysis maps every game, read in place from its decoded block, into a
+// partial state of the worker holding the block, and partial states reduce into the result in any order.
+// Blocks are dealt out in epochs: every worker starts an epoch on its own contiguous run of blocks and steals
+// single blocks from the fullest run once its own is done. After each epoch the partial states are reduced,
+// progress is reported and, given a checkpoint path, the result so far is saved, so a run that stopped resumes
+// at the first epoch it had not finished.
+namespace analysis
+{
+    template <typename StateT>
+    struct Analysis
+    {
+        std::function<void(StateT &, const archive::ReplayView &)> map;
+        std::function<void(StateT &, const StateT &)> reduce; // must not depend on the order of the games
+
+        // only needed for checkpoints
+        std::function<void(const StateT &, std::string &)> save;
+        std::function<bool(StateT &, const char *&, const char *)> load;
+    };
+
+    struct Progress
+    {
+        std::uint64_t blocksDone = 0;
+        std::uint64_t blocks = 0;
+        std::uint64_t games = 0;  // mapped in this run
+        std::uint64_t resumedBlocks = 0; // done by an earlier run
+        std::uint64_t steals = 0;
+        double seconds = 0.0;
+    };
+
+    struct Settings
+    {
+        unsigned int workers = 1;
+        std::uint64_t epochBlocks = 1024;
+        std::string checkpoint; // empty for none
+        std::function<void(const Progress &)> onProgress;
+    };
+
+    // Each worker owns a contiguous run of the epoch's blocks and takes them from the front. Thieves take from
+    // the front of the longest other run; owner and thieves claim blocks with the same atomic cursor.
+    class BlockQueues
+    {
+    public:
+        BlockQueues(std::uint64_t first, std::uint64_t last, unsigned int workers);
+
+        bool take(unsigned int worker, std::uint64_t &block);
+        std::uint64_t getSteals() const;
+
+    private:
+        struct alignas(64) Run
+        {
+            std::atomic<std::uint64_t> next{0};
+            std::uint64_t end = 0;
+        };
+
+        std::vector<Run> runs;
+        std::atomic<std::uint64_t> steals{0};
+    };
+
+    // the blocks done and the saved result of an earlier run over the same archive
+    bool readCheckpoint(const std::string &path, const archive::Reader &reader, std::uint64_t &blocksDone, std::string &state);
+    bool writeCheckpoint(const std::string &path, const archive::Reader &reader, std::uint64_t blocksDone, const std::string &state);
+
+    template <typename StateT>
+    bool run(const archive::Reader &reader, const Analysis<StateT> &analysis, const Settings &settings, StateT &result)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const bool checkpoints = !settings.checkpoint.empty() && analysis.save && analysis.load;
+        const unsigned int workers = std::max(settings.workers, 1U);
+        Progress progress;
+        progress.blocks = reader.blockCount();
+
+        std::string saved;
+        if (checkpoints && readCheckpoint(settings.checkpoint, reader, progress.blocksDone, saved))
+        {
+            const char *cursor = saved.data();
+            if (!analysis.load(result, cursor, saved.data() + saved.size()))
+            {
+                return false;
+            }
+            progress.resumedBlocks = progress.blocksDone;
+        }
+
+        sim::WorkerPool pool(workers);
+        std::vector<StateT> partial(workers);
+        std::atomic<std::uint64_t> games{0};
+        std::atomic<bool> failed{false};
+        while (progress.blocksDone < progress.blocks && !failed)
+        {
+            const std::uint64_t last = std::min(progress.blocks, progress.blocksDone + std::max<std::uint64_t>(settings.epochBlocks, 1));
+            BlockQueues queues(progress.blocksDone, last, workers);
+            for (unsigned int w = 0; w < workers; ++w)
+            {
+                pool.submit([&, w]
+                    {
+                        std::string raw;
+                        archive::ReplayView view;
+                        std::uint64_t block = 0;
+                        while (queues.take(w, block))
+                        {
+                            if (!reader.readRaw(static_cast<std::size_t>(block), raw))
+                            {
+                                failed = true;
+                                return;
+                            }
+                            const char *cursor = raw.data();
+                            const char *end = raw.data() + raw.size();
+                            std::uint64_t mapped = 0;
+                            while (cursor != end)
+                            {
+                                if (!view.parse(cursor, end))
+                                {
+                                    failed = true;
+                                    return;
+                                }
+                                analysis.map(partial[w], view);
+                                mapped++;
+                            }
+                            games += mapped;
+                        }
+                    });
+            }
+            pool.wait();
+            if (failed)
+            {
+                break;
+            }
+            for (auto &state : partial)
+            {
+                analysis.reduce(result, state);
+                state = StateT{};
+            }
+
+            progress.blocksDone = last;
+            progress.games = games;
+            progress.steals += queues.getSteals();
+            progress.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (checkpoints)
+            {
+                saved.clear();
+                analysis.save(result, saved);
+                writeCheckpoint(settings.checkpoint, reader, progress.blocksDone, saved);
+            }
+            if (settings.onProgress)
+            {
+                settings.onProgress(progress);
+            }
+        }
+        return !failed;
+    }
+
+    // ready-made analyses
+
+    // guesses and hits of each seat by round number
+    struct HitsByRound
+    {
+        std::vector<std::uint64_t> guesses[2];
+        std::vector<std::uint64_t> hits[2]; // guesses on a mine of the opponent that survived the collisions
+    };
+    Analysis<HitsByRound> hitsByRound();
+    std::ostream &operator<<(std::ostream &stream, const HitsByRound &state);
+
+    // where each seat places its mines, per board size
+    struct Heatmap
+    {
+        std::map<std::pair<unsigned int, unsigned int>, std::vector<std::uint64_t>> cells[2]; // column-major counts
+    };
+    Analysis<Heatmap> heatmap();
+    std::ostream &operator<<(std::ostream &stream, const Heatmap &state);
+
+    // habits of each strategy, whatever seat it played
+    struct Fingerprint
+    {
+        struct Habits
+        {
+            std::uint64_t games = 0;
+            std::uint64_t guesses = 0;
+            std::uint64_t ownMineGuesses = 0; // guesses on a cell holding one of its own mines
+            std::uint64_t mines = 0;
+            std::uint64_t edgeMines = 0; // placed on the border of the board
+            std::uint64_t wins = 0;
+        };
+        Habits strategies[2]; // by CpuStrategy
+    };
+    Analysis<Fingerprint> fingerprint();
+    std::ostream &operator<<(std::ostream &stream, const Fingerprint &state);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "minefield/engine/sim.h"
+
+#include <cstddef>
+#include <vector>
+
+// Exact outcome of Random-vs-Random games. With both CPUs choosing uniformly among free cells and mines
+// re-placed every round, the future only depends on (free cells, remaining mines of each seat), so a
+// dynamic program over that compressed state replaces Monte Carlo estimates of the baseline.
+namespace analytic
+{
+    struct OutcomeDistribution
+    {
+        double firstSeatWins = 0.0;
+        double draws = 0.0;
+        double secondSeatWins = 0.0;
+        double expectedRounds = 0.0;
+    };
+
+    // binomial coefficient as a double; k stays small (bounded by the mine count) so the product is exact enough
+    double choose(unsigned int n, unsigned int k);
+
+    class RandomGameSolver
+    {
+    public:
+        RandomGameSolver(unsigned int cells, unsigned int mines);
+
+        // outcome from the start of a round with the given free cells and remaining mines
+        OutcomeDistribution solve(unsigned int freeCells, unsigned int mines1, unsigned int mines2);
+
+    private:
+        void addTransition(OutcomeDistribution &into, double probability, unsigned int freeCells, unsigned int mines1, unsigned int mines2);
+        std::size_t index(unsigned int freeCells, unsigned int mines1, unsigned int mines2) const;
+
+        unsigned int cells;
+        unsigned int mines;
+        std::vector<OutcomeDistribution> memo;
+        std::vector<bool> known;
+    };
+
+    OutcomeDistribution randomGameOutcome(const sim::GameConfig &config);
+}
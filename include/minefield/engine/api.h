@@ -0,0 +1,81 @@
+#pragma once
+
+#include "minefield/engine/handoff.h"
+#include "minefield/engine/json.h"
+#include "minefield/engine/session.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// Local JSON API over the session games, one request and one reply per line:
+//   {"op":"create","width":8,"height":8,"mines":3}       -> {"ok":true,"game":1,...}
+//   {"op":"round","game":1,"mines":[[[c,r],...],[...]],"guesses":[[...],[...]]}
+//   {"op":"state","game":1}, {"op":"board","game":1}, {"op":"close","game":1}, {"op":"shutdown"}
+// Positions are [column,row] pairs starting at 0, lists are given per seat. Replies to games carry the
+// outcome ("ongoing", "draw", "first" or "second"), the remaining mines and the counts expected next round.
+// A bot playing many games at once batches them, one message per step for all of its games:
+//   {"op":"create",...,"count":1000}                     -> {"ok":true,"games":[{"game":1,...},...]}
+//   {"op":"rounds","rounds":[{"game":1,"mines":...,"guesses":...},...]} -> {"ok":true,"results":[...]}
+//   {"op":"close","games":[1,2,...]}                     -> {"ok":true,"closed":2}
+// Results come in request order, each one what a single round request would have answered. Every round
+// commits on its own: a round that runs out of memory fails alone, and as it may have been applied in part,
+// its game is closed.
+namespace api
+{
+    class Handler
+    {
+    public:
+        static constexpr std::size_t kMaxTokens = 1 << 16;      // kept for every request
+        static constexpr std::size_t kMaxBatchTokens = 1 << 22; // grown up to for long batches
+        static constexpr unsigned int kMaxBatchGames = 1 << 16; // created by one request
+        static constexpr std::uint64_t kMaxRequestCells = std::uint64_t{1} << 26; // on all boards created by one request
+        static constexpr std::uint64_t kMaxLiveCells = std::uint64_t{1} << 28;    // on all boards the server holds, unless given
+
+        explicit Handler(std::uint64_t maxLiveCells = kMaxLiveCells);
+
+        // handles the request held in line, which is modified in place; false once shutdown was requested.
+        // The reply is reserved before any game changes, so it never runs out of memory half-written. Other
+        // requests running out of memory are answered with an error and leave the games as they were.
+        bool handle(char *line, std::size_t length, json::Writer &reply);
+
+        // every live game with its board, seats and outcome, for a server taking over from this one
+        void save(handoff::ImageWriter &image) const;
+        bool restore(handoff::ImageReader &image);
+        std::size_t gameCount() const;
+
+    private:
+        bool dispatch(char *line, std::size_t length, json::Writer &reply);
+        bool readPositions(const json::Document &request, std::uint32_t lists, std::size_t offset, std::uint32_t counts[2]);
+        void playRound(const json::Document &request, std::uint32_t object, std::uint64_t id, session::Game &game, json::Writer &reply);
+        void writeState(json::Writer &reply, std::uint64_t id, const session::Game &game) const;
+        void writeState(json::Writer &reply, std::uint64_t id, const session::Game &game, const std::uint32_t mines[2], const std::uint32_t guesses[2]) const;
+
+        std::map<std::uint64_t, session::Game> games;
+        std::uint64_t nextGame = 1;
+        std::uint64_t maxLiveCells;
+        std::uint64_t liveCells = 0; // on the boards of every game held
+        session::CellMarks marks;
+        std::vector<json::Token> tokens;
+        std::vector<Position> positions; // mines and guesses of the request being handled, reused
+    };
+
+#ifndef _WIN32
+    struct ServerReport
+    {
+        std::uint64_t connections = 0;
+        std::uint64_t requests = 0;
+        std::uint64_t resumedGames = 0;    // taken over from the previous server
+        std::uint64_t resumedClients = 0;
+        double pauseMilliseconds = 0;      // from asking for the handoff to serving again
+        bool handedOff = false;            // a successor took over instead of a shutdown
+    };
+
+    // Serves every client connecting to address until one of them sends a shutdown request, or until a newer
+    // server connects to handoff::channelPath(address) and takes the listener, the clients and the games over.
+    // With takeover set, this server is that newer one and starts from what the running server hands over.
+    bool serve(const std::string &address, ServerReport &report, bool takeover = false);
+#endif
+}
@@ -0,0 +1,258 @@
+#pragma once
+
+#include "minefield/engine/sim.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Replay archives: games are serialized into compact records (varints, cells as column * height + row),
+// grouped into blocks and every block is entropy coded on its own with rANS under an order-1 model, the
+// probability of each byte given the byte before it. The model is the archive's dictionary: trained once on
+// sample games, stored in the header, and shared by every block, so even a block of one game codes well.
+// A directory after the blocks gives each block's place and first game for random access.
+//
+// File layout, integers little-endian:
+//   "MFRA" version dictionary | blocks | directory: one BlockInfo per block | directory offset, blocks, games, "MFRA"
+namespace archive
+{
+    constexpr std::uint32_t kMagic = 0x4152464D; // "MFRA"
+    constexpr std::uint32_t kVersion = 1;
+    constexpr unsigned int kDefaultBlockReplays = 256;
+
+    // integer encodings of archives and their catalogs: LEB128 varints and fixed-width little-endian fields
+    void putVarint(std::string &out, std::uint64_t value);
+    bool getVarint(const char *&cursor, const char *end, std::uint64_t &value);
+    bool getVarint(const char *&cursor, const char *end, std::uint64_t max, unsigned int &value);
+
+    template <typename T>
+    void putFixed(std::string &out, T value)
+    {
+        for (std::size_t i = 0; i < sizeof(T); ++i)
+        {
+            out.push_back(static_cast<char>(static_cast<std::uint64_t>(value) >> (8 * i)));
+        }
+    }
+
+    template <typename T>
+    bool getFixed(const char *&cursor, const char *end, T &value)
+    {
+        if (static_cast<std::size_t>(end - cursor) < sizeof(T))
+        {
+            return false;
+        }
+        std::uint64_t number = 0;
+        for (std::size_t i = 0; i < sizeof(T); ++i)
+        {
+            number |= static_cast<std::uint64_t>(static_cast<std::uint8_t>(*cursor++)) << (8 * i);
+        }
+        value = static_cast<T>(number);
+        return true;
+    }
+
+    // a whole file mapped read-only, so readers only fault in the pages they look at
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+        ~MappedFile();
+
+        bool open(const std::string &path);
+        const char *data() const;
+        std::size_t size() const;
+
+    private:
+        void close();
+
+        const char *base = nullptr;
+        std::size_t length = 0;
+#ifdef _WIN32
+        std::string contents; // read whole where there is no mmap
+#endif
+    };
+
+    // The positions of one list inside a record, decoded while they are iterated. Only valid for a record
+    // that ReplayView::parse accepted, and only as long as the decoded block lives.
+    class PositionList
+    {
+    public:
+        class Iterator
+        {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = Position;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Position *;
+            using reference = const Position &;
+
+            Iterator(const char *cursor, std::uint32_t left, unsigned int height);
+
+            const Position &operator*() const;
+            Iterator &operator++();
+            bool operator==(const Iterator &other) const;
+            bool operator!=(const Iterator &other) const;
+
+        private:
+            void decode();
+
+            const char *cursor;
+            std::uint32_t left;
+            unsigned int height;
+            Position position;
+        };
+
+        PositionList() = default;
+        PositionList(const char *data, std::uint32_t count, unsigned int height);
+
+        std::uint32_t size() const;
+        bool empty() const;
+        Iterator begin() const;
+        Iterator end() const;
+
+    private:
+        const char *data = nullptr;
+        std::uint32_t count = 0;
+        unsigned int height = 1;
+    };
+
+    struct RoundView
+    {
+        PositionList mines1;
+        PositionList mines2;
+        PositionList guesses1;
+        PositionList guesses2;
+    };
+
+    // A record read in place: the fixed fields are copied out and the rounds point into the decoded block,
+    // so scanning games allocates nothing once rounds has grown to the longest game.
+    struct ReplayView
+    {
+        sim::GameConfig config;
+        sim::Seat first;
+        sim::Seat second;
+        sim::GameResult result;
+        std::vector<RoundView> rounds;
+
+        // checks the whole record at cursor and moves past it; false on a malformed record
+        bool parse(const char *&cursor, const char *end);
+        void copyTo(sim::GameReplay &replay) const;
+    };
+
+    // appends the record of replay to out
+    void encodeReplay(const sim::GameReplay &replay, std::string &out);
+    // reads one record at cursor and advances it; false on a malformed record
+    bool decodeReplay(const char *&cursor, const char *end, sim::GameReplay &replay);
+
+    class Dictionary
+    {
+    public:
+        static constexpr unsigned int kScaleBits = 12; // symbol frequencies of a context add up to 1 << kScaleBits
+
+        Dictionary(); // every byte equally likely in every context
+
+        // byte statistics of the samples' records; every byte keeps a nonzero frequency, so any data still codes
+        static Dictionary train(const std::vector<sim::GameReplay> &samples);
+
+        void compress(const std::string &raw, std::string &out) const;
+        bool decompress(const char *data, std::size_t size, std::size_t rawSize, std::string &out) const;
+
+        void save(std::string &out) const;
+        bool load(const char *&cursor, const char *end);
+
+        unsigned int trainedContexts() const;
+
+    private:
+        static constexpr unsigned int kScale = 1U << kScaleBits;
+
+        void setContext(unsigned int context, const std::array<std::uint16_t, 256> &frequencies);
+
+        struct Code
+        {
+            std::uint16_t frequency = 0;
+            std::uint16_t start = 0; // cumulative frequency before the symbol
+        };
+
+        const Code &code(unsigned int context, unsigned int symbol) const;
+
+        std::vector<Code> codes; // 256 per context
+        std::array<std::uint32_t, 256> table{}; // where each context's slots begin in symbols; 0 holds the uniform one
+        std::vector<std::uint8_t> symbols; // kScale slots per table, the symbol owning each slot
+    };
+
+    struct BlockInfo
+    {
+        std::uint64_t offset = 0;
+        std::uint64_t firstReplay = 0;
+        std::uint32_t replays = 0;
+        std::uint32_t rawSize = 0;
+        std::uint32_t compressedSize = 0;
+    };
+
+    struct Stats
+    {
+        std::uint64_t replays = 0;
+        std::uint64_t blocks = 0;
+        std::uint64_t rawBytes = 0;
+        std::uint64_t compressedBytes = 0; // blocks only, without the header and directory
+
+        double ratio() const;
+    };
+
+    class Writer
+    {
+    public:
+        Writer(const std::string &path, const Dictionary &dictionary, unsigned int blockReplays = kDefaultBlockReplays);
+
+        bool add(const sim::GameReplay &replay);
+        // writes the last block and the directory; the archive is unreadable without it
+        bool finish();
+
+        const Stats &stats() const;
+
+    private:
+        bool flushBlock();
+
+        const Dictionary &dictionary;
+        unsigned int blockReplays;
+        std::ofstream file;
+        std::uint64_t offset = 0;
+        std::string raw;
+        std::string compressed;
+        unsigned int pending = 0;
+        std::vector<BlockInfo> directory;
+        Stats totals;
+    };
+
+    class Reader
+    {
+    public:
+        bool open(const std::string &path);
+
+        std::size_t blockCount() const;
+        std::uint64_t replayCount() const;
+        const BlockInfo &block(std::size_t index) const;
+        const Dictionary &getDictionary() const;
+
+        // the records of one block, decoded straight from the mapping without touching any other block; safe to
+        // call from many threads at once
+        bool readRaw(std::size_t index, std::string &raw) const;
+        bool readBlock(std::size_t index, std::vector<sim::GameReplay> &replays);
+        bool readReplay(std::uint64_t index, sim::GameReplay &replay);
+
+    private:
+        MappedFile file;
+        Dictionary dictionary;
+        std::vector<BlockInfo> directory;
+        std::uint64_t replays = 0;
+        std::string raw;
+    };
+
+    std::ostream &operator<<(std::ostream &stream, const Stats &stats);
+}
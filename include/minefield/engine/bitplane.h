@@ -0,0 +1,79 @@
+#pragma once
+
+#include "minefield/engine/board.h"
+#include "minefield/engine/sim.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Mine placement for many seats at once. Each plane holds one bit per cell in the board's column-major
+// order; a placement is a fetch_or into the owner plane of its seat and into the shared mine plane, and
+// the previous word returned by the latter tells whether someone got there first. The second seat to
+// reach a cell marks it in the collision plane, so once every placement has returned the planes hold
+// the same outcome whatever the interleaving was, without any lock.
+// Standalone: the two-seat games of sim and session place through game::* and partition::, which keep each
+// seat's mine list in the order the rules resolve it; these planes are for more seats than the engine plays.
+namespace bitplane
+{
+    enum class Placement
+    {
+        Placed,
+        Collision, // the cell already held another seat's mine
+        Duplicate, // the seat already placed a mine there
+        Invalid    // outside the board or disabled
+    };
+
+    class MinePlanes
+    {
+    public:
+        // takes the disabled cells of board, which must not change while mines are placed
+        MinePlanes(const Board &board, unsigned int seats);
+
+        // safe to call from any number of threads
+        Placement place(unsigned int seat, unsigned int col, unsigned int row);
+
+        // not thread-safe: clears the mine, owner and collision planes for the next round
+        void clear();
+
+        bool hasMine(unsigned int col, unsigned int row) const; // placed and not collided
+        bool collided(unsigned int col, unsigned int row) const;
+        bool owns(unsigned int seat, unsigned int col, unsigned int row) const;
+
+        unsigned int survivors(unsigned int seat) const;  // mines of seat that did not collide
+        unsigned int collisions(unsigned int seat) const; // mines of seat lost to collisions
+
+        // writes the round into board like game::detectAndRemoveCollisions does: surviving mines get HasMine,
+        // collided cells are disabled and flagged HadCollision
+        void applyTo(Board &board) const;
+
+        unsigned int getSeats() const;
+
+    private:
+        using Word = std::atomic<std::uint64_t>;
+
+        std::size_t cellIndex(unsigned int col, unsigned int row) const;
+        bool test(const Word *plane, std::size_t index) const;
+        unsigned int count(const Word *plane, const Word *mask, bool inverted) const;
+        Word *plane(std::size_t number) const;
+
+        unsigned int width;
+        unsigned int height;
+        unsigned int seats;
+        std::size_t words;
+        // planes back to back: disabled, mines, collisions, then one owner plane per seat
+        std::unique_ptr<Word[]> storage;
+    };
+
+    struct PlacementReport
+    {
+        std::uint64_t placed = 0;     // first on their cell, possibly collided with later
+        std::uint64_t collisions = 0; // arrived on a cell that already held a mine
+        std::uint64_t rejected = 0;   // duplicates and invalid cells
+    };
+
+    // places every seat's list, split into chunks of about chunkSize placements run on pool
+    PlacementReport placeAll(MinePlanes &planes, const std::vector<std::vector<Position>> &mines, sim::WorkerPool &pool, std::size_t chunkSize = 4096);
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "minefield/engine/cell.h"
+#include "minefield/engine/memory.h"
+
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+class Board
+{
+public:
+    static constexpr int kMaxSize = 4;
+    static constexpr int kMaxSimulationSize = 4096; // headless games are not bound by the interactive limit
+    static constexpr int kMinSize = 2;
+    static constexpr int kMaxMines = 5;
+    static constexpr int kMinMines = 1;
+
+    Board(unsigned int w, unsigned int h, unsigned int maxSize = kMaxSize);
+
+    unsigned int getWidth() const;
+    unsigned int getHeight() const;
+
+    bool isValidPosition(unsigned int col, unsigned int row) const;
+    bool isDisabled(unsigned int col, unsigned int row) const;
+    bool isValidMineCount(unsigned int count) const;
+
+    CellStatusFlags getCellStatus(unsigned int col, unsigned int row) const;
+    const CellStatusFlags *cells() const; // column-major, cell (col, row) at col * height + row
+
+    template <typename OnValidCellFnT>
+    void safeCellAccess(unsigned int col, unsigned int row, OnValidCellFnT onValidCell);
+
+private:
+    unsigned int width;
+    unsigned int height;
+    std::size_t cellIndex(unsigned int col, unsigned int row) const;
+
+    // column-major, one contiguous block so large boards can sit on huge pages
+    std::vector<CellStatusFlags, memory::HugePageAllocator<CellStatusFlags>> grid;
+};
+
+// cell accessors are the hot path of every simulation, so they stay inline
+inline std::size_t Board::cellIndex(unsigned int col, unsigned int row) const
+{
+    return static_cast<std::size_t>(col) * height + row;
+}
+
+inline unsigned int Board::getWidth() const
+{
+    return width;
+}
+
+inline unsigned int Board::getHeight() const
+{
+    return height;
+}
+
+inline bool Board::isValidPosition(unsigned int col, unsigned int row) const
+{
+    return (col < width && row < height);
+}
+
+inline bool Board::isDisabled(unsigned int col, unsigned int row) const
+{
+    if (!isValidPosition(col, row))
+    {
+        return false;
+    }
+    else
+    {
+        return hasFlag(grid[cellIndex(col, row)], CellStatusFlags::Disabled);
+    }
+}
+
+inline CellStatusFlags Board::getCellStatus(unsigned int col, unsigned int row) const
+{
+    if (!isValidPosition(col, row))
+    {
+        return CellStatusFlags::None;
+    }
+    return grid[cellIndex(col, row)];
+}
+
+inline const CellStatusFlags *Board::cells() const
+{
+    return grid.data();
+}
+
+template <typename OnValidCellFnT>
+void Board::safeCellAccess(unsigned int col, unsigned int row, OnValidCellFnT onValidCell)
+{
+    if (isValidPosition(col, row))
+    {
+        onValidCell(grid[cellIndex(col, row)]);
+    }
+}
+
+// board display
+char getSymbolForStatus(const CellStatusFlags status);
+std::ostream &operator<<(std::ostream &stream, const Board &board);
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+// Bounded concurrent cache for values derived from a canonical 64-bit state hash. It never locks: every
+// slot carries a version that is odd while a writer owns it, readers copy the value and retry nothing, a
+// lookup that races a writer simply counts as a miss. Slots are grouped in sets of kWays; a full set
+// evicts with the clock (second chance) policy, hits marking their slot as recently used. Keys are the
+// full hash, so distinct states only share an entry on a 64-bit collision.
+namespace cache
+{
+    struct Stats
+    {
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        std::uint64_t evictions = 0;
+
+        double hitRate() const
+        {
+            const std::uint64_t lookups = hits + misses;
+            return lookups ? static_cast<double>(hits) / lookups : 0.0;
+        }
+    };
+
+    template <typename ValueT>
+    class ClockCache
+    {
+        static_assert(std::is_trivially_copyable_v<ValueT>, "values are copied word by word");
+
+    public:
+        static constexpr std::size_t kWays = 8;
+        static constexpr std::size_t kShards = 64;
+
+        // capacity is rounded up to whole sets in every shard
+        explicit ClockCache(std::size_t capacity)
+            : setsPerShard(std::max<std::size_t>(1, (capacity + kShards * kWays - 1) / (kShards * kWays)))
+            , sets(new Set[kShards * setsPerShard])
+        {
+        }
+
+        bool find(std::uint64_t key, ValueT &value)
+        {
+            Shard &shard = shards[shardOf(key)];
+            Set &set = setOf(key);
+            for (std::size_t way = 0; way < kWays; ++way)
+            {
+                Slot &slot = set.slots[way];
+                if (slot.key.load(std::memory_order_relaxed) == key && slot.read(key, value))
+                {
+                    slot.referenced.store(true, std::memory_order_relaxed);
+                    shard.hits.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+            shard.misses.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        // best effort: gives up when another thread holds the chosen slot
+        void insert(std::uint64_t key, const ValueT &value)
+        {
+            Set &set = setOf(key);
+            Slot *victim = nullptr;
+            for (std::size_t way = 0; way < kWays && !victim; ++way)
+            {
+                Slot &slot = set.slots[way];
+                const std::uint32_t version = slot.version.load(std::memory_order_relaxed);
+                if (slot.key.load(std::memory_order_relaxed) == key || version == 0)
+                {
+                    victim = &slot;
+                }
+            }
+            bool evicting = false;
+            // second chance: referenced slots lose their bit and are passed over once
+            for (std::size_t step = 0; step < 2 * kWays && !victim; ++step)
+            {
+                Slot &slot = set.slots[set.hand.fetch_add(1, std::memory_order_relaxed) % kWays];
+                if (!slot.referenced.exchange(false, std::memory_order_relaxed))
+                {
+                    victim = &slot;
+                    evicting = true;
+                }
+            }
+            if (victim && victim->write(key, value) && evicting)
+            {
+                shards[shardOf(key)].evictions.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        Stats stats() const
+        {
+            Stats total;
+            for (const auto &shard : shards)
+            {
+                total.hits += shard.hits.load(std::memory_order_relaxed);
+                total.misses += shard.misses.load(std::memory_order_relaxed);
+                total.evictions += shard.evictions.load(std::memory_order_relaxed);
+            }
+            return total;
+        }
+
+        std::size_t capacity() const
+        {
+            return kShards * setsPerShard * kWays;
+        }
+
+    private:
+        static constexpr std::size_t kWords = (sizeof(ValueT) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+        struct Slot
+        {
+            std::atomic<std::uint32_t> version{0}; // 0: never written, odd: being written
+            std::atomic<bool> referenced{false};
+            std::atomic<std::uint64_t> key{0};
+            std::array<std::atomic<std::uint64_t>, kWords> words{};
+
+            bool read(std::uint64_t expected, ValueT &value) const
+            {
+                const std::uint32_t before = version.load(std::memory_order_acquire);
+                if (before == 0 || (before & 1))
+                {
+                    return false;
+                }
+                std::uint64_t copy[kWords];
+                for (std::size_t w = 0; w < kWords; ++w)
+                {
+                    copy[w] = words[w].load(std::memory_order_relaxed);
+                }
+                const bool sameKey = key.load(std::memory_order_relaxed) == expected;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (!sameKey || version.load(std::memory_order_relaxed) != before)
+                {
+                    return false;
+                }
+                std::memcpy(&value, copy, sizeof(ValueT));
+                return true;
+            }
+
+            bool write(std::uint64_t newKey, const ValueT &value)
+            {
+                std::uint32_t current = version.load(std::memory_order_relaxed);
+                if ((current & 1) || !version.compare_exchange_strong(current, current + 1, std::memory_order_acquire))
+                {
+                    return false;
+                }
+                std::atomic_thread_fence(std::memory_order_release);
+                std::uint64_t copy[kWords] = {};
+                std::memcpy(copy, &value, sizeof(ValueT));
+                key.store(newKey, std::memory_order_relaxed);
+                for (std::size_t w = 0; w < kWords; ++w)
+                {
+                    words[w].store(copy[w], std::memory_order_relaxed);
+                }
+                referenced.store(false, std::memory_order_relaxed);
+                // skips 0 on wrap-around, which marks a slot that was never written
+                const std::uint32_t next = (current + 2 == 0) ? 2 : current + 2;
+                version.store(next, std::memory_order_release);
+                return true;
+            }
+        };
+
+        struct alignas(64) Set
+        {
+            Slot slots[kWays];
+            std::atomic<std::uint32_t> hand{0};
+        };
+
+        // counters live apart so threads working on different shards do not share cache lines
+        struct alignas(64) Shard
+        {
+            std::atomic<std::uint64_t> hits{0};
+            std::atomic<std::uint64_t> misses{0};
+            std::atomic<std::uint64_t> evictions{0};
+        };
+
+        static std::size_t shardOf(std::uint64_t key)
+        {
+            return static_cast<std::size_t>(key >> 58) % kShards;
+        }
+
+        Set &setOf(std::uint64_t key)
+        {
+            return sets[shardOf(key) * setsPerShard + static_cast<std::size_t>(key % setsPerShard)];
+        }
+
+        std::size_t setsPerShard;
+        std::unique_ptr<Set[]> sets;
+        Shard shards[kShards];
+    };
+}
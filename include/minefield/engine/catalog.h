@@ -0,0 +1,120 @@
+#pragma once
+
+#include "minefield/engine/archive.h"
+#include "minefield/engine/sim.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Secondary indexes over a replay archive, kept in a catalog file next to it and read through a mapping:
+//   - a summary per block: min/max of rounds, collisions and mines, outcome counts, and a bloom filter over
+//     the block's categorical features (board width and height, mines, outcome, strategies)
+//   - an inverted index from each categorical feature to the ids of the games having it, delta coded
+// A query intersects the posting lists when one of them is selective and otherwise scans only the blocks
+// whose summary can match. Either way, only the archive blocks holding candidates are decoded, to check
+// the range conditions and to return the games.
+namespace catalog
+{
+    constexpr std::uint32_t kMagic = 0x4352464D; // "MFRC"
+    constexpr std::uint32_t kVersion = 1;
+    constexpr std::size_t kBloomWords = 8;
+
+    struct Features
+    {
+        unsigned int width = 0;
+        unsigned int height = 0;
+        unsigned int mines = 0;
+        unsigned int rounds = 0;
+        unsigned int collisions = 0; // cells where both seats placed a mine, over all rounds
+        sim::Outcome outcome = sim::Outcome::Draw;
+        CpuStrategy first = CpuStrategy::Random;
+        CpuStrategy second = CpuStrategy::Random;
+    };
+
+    Features featuresOf(const sim::GameReplay &replay);
+
+    // keys of the inverted index
+    enum class Feature : std::uint64_t
+    {
+        Width = 1,
+        Height,
+        Mines,
+        Outcome,
+        Strategies // first * 2 + second
+    };
+
+    std::uint64_t featureKey(Feature feature, std::uint64_t value);
+
+    struct BlockSummary
+    {
+        std::uint32_t minRounds = ~0U;
+        std::uint32_t maxRounds = 0;
+        std::uint32_t minCollisions = ~0U;
+        std::uint32_t maxCollisions = 0;
+        std::uint32_t minMines = ~0U;
+        std::uint32_t maxMines = 0;
+        std::uint32_t outcomes[3] = {0, 0, 0}; // games per sim::Outcome
+        std::uint64_t bloom[kBloomWords] = {};
+    };
+
+    // conditions a game must meet, all of them; kAny leaves a feature free
+    struct Query
+    {
+        static constexpr unsigned int kAny = ~0U;
+
+        unsigned int width = kAny;
+        unsigned int height = kAny;
+        unsigned int mines = kAny;
+        unsigned int outcome = kAny; // a sim::Outcome
+        unsigned int minRounds = 0;
+        unsigned int maxRounds = kAny;
+        unsigned int minCollisions = 0;
+        unsigned int maxCollisions = kAny;
+    };
+
+    struct Result
+    {
+        std::vector<std::uint64_t> games; // ids in archive order
+        bool usedPostings = false;
+        std::uint64_t candidates = 0; // games the indexes could not rule out
+        std::uint64_t blocksDecoded = 0;
+        std::uint64_t blocks = 0;
+    };
+
+    // reads every block of the archive once and writes its catalog to path
+    bool build(archive::Reader &reader, const std::string &path);
+
+    class Catalog
+    {
+    public:
+        bool open(const std::string &path);
+
+        std::uint64_t gameCount() const;
+        std::size_t blockCount() const;
+        BlockSummary summary(std::size_t block) const;
+
+        // ids of the games with the feature, empty when none has it
+        std::vector<std::uint64_t> postings(std::uint64_t key) const;
+        std::uint64_t postingCount(std::uint64_t key) const;
+
+        // the games of reader, the archive this catalog was built from, that match query
+        Result run(const Query &query, archive::Reader &reader) const;
+
+    private:
+        bool findKey(std::uint64_t key, std::uint64_t &count, std::uint64_t &offset) const;
+
+        archive::MappedFile file;
+        std::uint64_t games = 0;
+        std::uint64_t blocks = 0;
+        std::uint64_t keys = 0;
+        const char *summaries = nullptr;
+        const char *keyTable = nullptr;
+        const char *postingData = nullptr;
+        const char *end = nullptr;
+    };
+
+    std::ostream &operator<<(std::ostream &stream, const Result &result);
+}
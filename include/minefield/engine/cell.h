@@ -0,0 +1,51 @@
+#pragma once
+
+// cell types shared by every board, free of anything that allocates
+struct Position
+{
+    unsigned int column = 0;
+    unsigned int row = 0;
+};
+
+using CellFlagsType = unsigned int;
+
+enum class CellStatusFlags : CellFlagsType
+{
+    None = 0,
+    Disabled = 0x01,
+    HasMine = 0x02,
+    WasGuessed = 0x04,
+    SelfDetonated = 0x08,
+    HadCollision = 0x10
+};
+
+inline CellStatusFlags operator|(CellStatusFlags a, CellStatusFlags b)
+{
+    return static_cast<CellStatusFlags>(static_cast<CellFlagsType>(a) | static_cast<CellFlagsType>(b));
+}
+
+inline CellStatusFlags &operator|=(CellStatusFlags &a, CellStatusFlags b)
+{
+    a = a | b;
+    return a;
+}
+
+inline CellStatusFlags operator&(CellStatusFlags a, CellStatusFlags b)
+{
+    return static_cast<CellStatusFlags>(static_cast<CellFlagsType>(a) & static_cast<CellFlagsType>(b));
+}
+
+inline CellStatusFlags operator~(CellStatusFlags a)
+{
+    return static_cast<CellStatusFlags>(~static_cast<CellFlagsType>(a));
+}
+
+inline bool hasFlag(CellStatusFlags var, CellStatusFlags flag)
+{
+    using T = CellFlagsType;
+    if (flag == CellStatusFlags::None)
+    {
+        return (var == CellStatusFlags::None);
+    }
+    return (static_cast<T>(var) & static_cast<T>(flag)) == static_cast<T>(flag);
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#include "minefield/engine/archive.h"
+#include "minefield/engine/sim.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Game results stored by column for ad-hoc filters and group-by aggregations. Rows are cut into row groups,
+// each column of a group is one aligned array in the file, and the file is read through a mapping, so a
+// scan touches only the columns a query names. Every group keeps the min and max of each column: groups a
+// filter cannot match are skipped unread, and filters a whole group meets are not evaluated for it.
+// Inside a group, filters run over batches of rows as branch-free loops into a byte mask that the compiler
+// vectorizes; the surviving rows become a selection vector and only then are the group-by and aggregated
+// columns read, for those rows alone. Row groups are spread over threads.
+//
+// File layout, integers little-endian:
+//   "MFCT" version | row groups: one 64-byte aligned array per column | directory: one GroupInfo per group |
+//   directory offset, groups, rows, "MFCT"
+namespace columnar
+{
+    constexpr std::uint32_t kMagic = 0x5443464D; // "MFCT"
+    constexpr std::uint32_t kVersion = 1;
+    constexpr std::uint32_t kRowGroupRows = 1U << 16;
+    constexpr std::size_t kBatchRows = 1024; // rows filtered at once, small enough for the mask to stay in L1
+    constexpr std::size_t kMaxGroupColumns = 4;
+
+    enum class Column
+    {
+        Seed,   // seed of the first seat
+        Width,
+        Height,
+        Mines,
+        Rounds,
+        Winner, // a sim::Outcome
+        Collisions
+    };
+    constexpr std::size_t kColumns = 7;
+
+    const char *columnName(Column column);
+    bool parseColumn(const std::string &name, Column &column);
+
+    struct Row
+    {
+        std::uint64_t seed = 0;
+        std::uint32_t width = 0;
+        std::uint32_t height = 0;
+        std::uint32_t mines = 0;
+        std::uint32_t rounds = 0;
+        std::uint8_t winner = 0;
+        std::uint32_t collisions = 0;
+    };
+
+    Row rowOf(const sim::GameReplay &replay);
+
+    struct GroupInfo
+    {
+        std::uint64_t offset = 0;
+        std::uint32_t rows = 0;
+        std::array<std::uint64_t, kColumns> min{};
+        std::array<std::uint64_t, kColumns> max{};
+    };
+
+    class Writer
+    {
+    public:
+        explicit Writer(const std::string &path);
+
+        bool add(const Row &row);
+        // writes the last row group and the directory; the table is unreadable without it
+        bool finish();
+
+        std::uint64_t rowCount() const;
+
+    private:
+        template <typename T>
+        void writeColumn(const std::vector<T> &values);
+        bool flushGroup();
+
+        std::ofstream file;
+        std::uint64_t offset = 0;
+        std::uint64_t rows = 0;
+        std::vector<std::uint64_t> seeds;
+        std::vector<std::uint32_t> widths;
+        std::vector<std::uint32_t> heights;
+        std::vector<std::uint32_t> mines;
+        std::vector<std::uint32_t> rounds;
+        std::vector<std::uint8_t> winners;
+        std::vector<std::uint32_t> collisions;
+        std::vector<GroupInfo> directory;
+    };
+
+    // one row group as read from the mapping
+    struct RowGroup
+    {
+        std::uint32_t rows = 0;
+        const std::uint64_t *seed = nullptr;
+        const std::uint32_t *width = nullptr;
+        const std::uint32_t *height = nullptr;
+        const std::uint32_t *mines = nullptr;
+        const std::uint32_t *rounds = nullptr;
+        const std::uint8_t *winner = nullptr;
+        const std::uint32_t *collisions = nullptr;
+
+        std::uint64_t value(Column column, std::size_t row) const;
+    };
+
+    class Table
+    {
+    public:
+        bool open(const std::string &path);
+
+        std::uint64_t rowCount() const;
+        std::size_t groupCount() const;
+        const GroupInfo &info(std::size_t group) const;
+        RowGroup group(std::size_t index) const;
+
+    private:
+        archive::MappedFile file;
+        std::vector<GroupInfo> directory;
+        std::uint64_t rows = 0;
+    };
+
+    // min <= value <= max
+    struct Predicate
+    {
+        Column column = Column::Seed;
+        std::uint64_t min = 0;
+        std::uint64_t max = ~std::uint64_t{0};
+    };
+
+    // "mines>=3", "width=4", "rounds<10"; the operators are =, <, <=, > and >=
+    bool parsePredicate(const std::string &text, Predicate &predicate);
+
+    struct Query
+    {
+        std::vector<Predicate> where; // all of them must hold
+        std::vector<Column> groupBy;  // up to kMaxGroupColumns
+    };
+
+    struct Group
+    {
+        std::array<std::uint64_t, kMaxGroupColumns> key{}; // values of the group-by columns, in their order
+        std::uint64_t rows = 0;
+        std::uint64_t outcomes[3] = {0, 0, 0}; // rows per sim::Outcome
+        std::uint64_t rounds = 0;              // summed, for the mean
+        std::uint64_t collisions = 0;
+    };
+
+    struct Result
+    {
+        std::vector<Column> groupBy;
+        std::vector<Group> groups; // ordered by key
+        std::uint64_t rowsScanned = 0;
+        std::uint64_t rowsMatched = 0;
+        std::uint64_t groupsSkipped = 0; // row groups ruled out by their min and max
+        std::uint64_t rowGroups = 0;
+        double seconds = 0.0;
+    };
+
+    // false when the query groups by more than kMaxGroupColumns columns
+    bool run(const Table &table, const Query &query, unsigned int workers, Result &result);
+
+    std::ostream &operator<<(std::ostream &stream, const Result &result);
+}
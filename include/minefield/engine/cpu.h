@@ -0,0 +1,19 @@
+#pragma once
+
+#include "minefield/engine/board.h"
+#include "minefield/engine/player.h"
+#include "minefield/engine/rules.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cpu
+{
+    const char *strategyName(CpuStrategy strategy);
+    bool parseStrategy(const std::string &name, CpuStrategy &strategy);
+
+    // picks one free cell not yet in chosen; callers never ask for more cells than are free
+    Position choosePlacement(CpuStrategy strategy, const Player &self, const Board &board, const std::vector<Position> &chosen, std::uint64_t decisionSeed, bool antithetic);
+    Position chooseGuess(CpuStrategy strategy, const Player &self, const Board &board, const std::vector<Position> &chosen, std::uint64_t decisionSeed, bool antithetic);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "minefield/engine/board.h"
+#include "minefield/engine/sim.h"
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Exhaustive breadth-first search over the round start states (disabled cells, remaining mines) of a small
+// board. Every state of a level is expanded in parallel through every legal round: all placements of both
+// seats, then all guesses against what the collisions left, played by game::*. Each transition is checked
+// against the rule invariants below, and violations are reported with the path of states leading to them.
+// The rules never look at where a cell is, so states are stored up to relabeling cells, by their number of
+// disabled cells, in a dense table of atomics holding each state's parent. Rounds are enumerated by move
+// class, one representative each, and counted as the moves the class holds.
+namespace explore
+{
+    enum class Invariant
+    {
+        MineUnderflow,      // a seat lost more mines than it had, and the count was clamped at zero
+        RemainingMismatch,  // remaining mines differ from the losses counted from the positions
+        DisabledShrank,     // a disabled cell became free again
+        CollisionImbalance, // a collision did not remove exactly one mine of each seat
+        NoProgress,         // an unfinished round left the board unchanged, so the game could loop
+        Count
+    };
+
+    const char *invariantName(Invariant invariant);
+
+    struct Settings
+    {
+        sim::GameConfig config;
+        unsigned int workers = 1;
+        std::uint64_t maxMoveClasses = 200'000'000; // the search stops unfinished beyond this
+        unsigned int maxTraces = 5;
+    };
+
+    struct State
+    {
+        std::uint32_t disabled = 0; // bit col * height + row; states are played with the lowest cells disabled
+        unsigned int mines1 = 0;
+        unsigned int mines2 = 0;
+    };
+
+    struct Move
+    {
+        std::vector<Position> mines[2];
+        std::vector<Position> guesses[2];
+    };
+
+    struct Violation
+    {
+        Invariant invariant = Invariant::Count;
+        std::vector<State> trace; // from the first round to the state the move was played from
+        Move move;
+    };
+
+    struct Report
+    {
+        sim::GameConfig config;
+        bool complete = false;
+        std::uint64_t states = 0; // distinct up to relabeling cells
+        std::uint64_t moveClasses = 0; // rounds played by game::*
+        std::uint64_t transitions = 0; // legal rounds those classes stand for
+        unsigned int depth = 0; // rounds in the longest game
+        std::uint64_t finalStates[3] = {0, 0, 0}; // first seat ahead, draw, second seat ahead
+        std::array<std::uint64_t, static_cast<std::size_t>(Invariant::Count)> violations{};
+        std::vector<Violation> traces;
+    };
+
+    // boards up to Board::kMaxSize on each side
+    Report exploreStates(const Settings &settings);
+    std::ostream &operator<<(std::ostream &stream, const Report &report);
+}
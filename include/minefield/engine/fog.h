@@ -0,0 +1,67 @@
+#pragma once
+
+#include "minefield/engine/board.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// What each seat may know about a board: its own mines plus the public record of the game (disabled and
+// guessed cells, collisions, self-detonations and the mines guesses revealed). Every kind of information is
+// a bitplane in the board's column-major order, kept up to date cell by cell as rounds are played, so a
+// seat's view of a word of cells is an OR of public planes and its own plane; nothing is copied.
+namespace fog
+{
+    class Views
+    {
+    public:
+        static constexpr unsigned int kSpectator = ~0U; // sees the public record only
+
+        Views(const Board &board, unsigned int seats = 2);
+
+        // start of a round: forgets every seat's mines and the mines revealed by the last guesses
+        void beginRound();
+        void placeMines(unsigned int seat, const std::vector<Position> &mines);
+
+        // re-reads the public flags of cells from board after the rules changed them, and drops the mines
+        // the board no longer holds there
+        void refresh(const Board &board, const std::vector<Position> &cells);
+
+        // the cell as seat sees it: public flags, HasMine where seat has a mine or a guess revealed one
+        CellStatusFlags cellFor(unsigned int seat, unsigned int col, unsigned int row) const;
+        bool ownsMine(unsigned int seat, unsigned int col, unsigned int row) const;
+
+        // word level access for strategies: 64 cells starting at cell 64 * word
+        std::size_t getWords() const;
+        std::uint64_t freeCells(std::size_t word) const;
+        std::uint64_t ownMines(unsigned int seat, std::size_t word) const;
+        std::uint64_t safeGuesses(unsigned int seat, std::size_t word) const; // free and without an own mine
+
+        // board display as seat sees it, own mines shown as 'M'
+        void render(std::ostream &stream, unsigned int seat) const;
+
+    private:
+        enum Plane : std::size_t
+        {
+            kDisabled,
+            kGuessed,
+            kSelfDetonated,
+            kCollided,
+            kRevealed,
+            kFirstOwn // one plane per seat from here
+        };
+
+        std::size_t cellIndex(unsigned int col, unsigned int row) const;
+        bool test(std::size_t plane, std::size_t index) const;
+        void assign(std::size_t plane, std::size_t index, bool value);
+        std::uint64_t *planeWords(std::size_t plane);
+        const std::uint64_t *planeWords(std::size_t plane) const;
+
+        unsigned int width;
+        unsigned int height;
+        unsigned int seats;
+        std::size_t words;
+        std::vector<std::uint64_t> bits; // planes back to back
+    };
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "minefield/engine/board.h"
+#include "minefield/engine/player.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace game
+{
+    void collectPositions(Player &player, int count, Board &board, std::vector<Position> &targetList, const std::string &prompt, bool showCpuMessage, bool markMinesOnBoard = false);
+    void placeMines(Player &player, int quantity, Board &board);
+    void collectGuessesFromPlayer(Player &player, int opponentMines, Board &board);
+
+    void detectAndRemoveCollisions(Player &p1, Player &p2, Board &board, std::ostream &out = std::cout);
+    void clearMines(Board &board);
+    int countHits(const Player &defender, const std::vector<Position> &attacks);
+    int resolveSelfDetonation(Player &player, Board &board, std::ostream &out = std::cout);
+    void disableGuessedPositions(const std::vector<Position> &guesses, Board &board);
+
+    struct GuessTotals
+    {
+        unsigned int hits[2] = {0, 0};     // opponent mines hit by each player's guesses
+        unsigned int selfHits[2] = {0, 0}; // own mines each player guessed
+    };
+
+    // applies both players' guesses once mines and guesses are collected: hits, self-detonations and disabled cells.
+    // Same result as countHits, resolveSelfDetonation and disableGuessedPositions for each player, in one pass
+    // over the guesses against an index of the mines.
+    GuessTotals resolveGuesses(Player &p1, Player &p2, Board &board, std::ostream &out = std::cout);
+    bool checkGameEnd(const Player &p1, const Player &p2, std::ostream &out = std::cout);
+
+    void runMainLoop(Player &p1, Player &p2, Board &board);
+    bool chooseGameMode(bool &exitChosen);
+    int chooseMineCount(const Board &board);
+    bool askPlayAgain();
+}
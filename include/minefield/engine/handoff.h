@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Live handoff of a server to a newer process on the same machine. The old process writes everything it
+// holds into an image in shared memory and passes that memory, its listening socket and its client sockets
+// over a Unix socket (SCM_RIGHTS); the new process maps the image and carries on with the same sockets, so
+// clients only see a pause. The image is raw native-endian data meant for the same build on the same host.
+namespace handoff
+{
+    constexpr std::uint32_t kMagic = 0x4F48464D; // "MFHO"
+    constexpr std::uint32_t kVersion = 2; // 2: the unsent replies of every client
+
+    class ImageWriter
+    {
+    public:
+        template <typename T>
+        void value(T number)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            bytes(&number, sizeof(number));
+        }
+        void bytes(const void *data, std::size_t size);
+        void text(const std::string &value); // length first
+
+        const std::string &data() const;
+
+    private:
+        std::string image;
+    };
+
+    // reads an image in place; every read fails once it would run past the end
+    class ImageReader
+    {
+    public:
+        ImageReader(const char *data, std::size_t size);
+
+        template <typename T>
+        bool value(T &number)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            return bytes(&number, sizeof(number));
+        }
+        bool bytes(void *data, std::size_t size);
+        bool text(std::string &value);
+        const char *view(std::size_t size); // nullptr past the end
+
+    private:
+        const char *data;
+        std::size_t size;
+        std::size_t offset = 0;
+    };
+
+#ifndef _WIN32
+    // where a server on address waits for its successor
+    std::string channelPath(const std::string &address);
+
+    // shared memory holding image, unlinked already so only its descriptor keeps it; -1 on failure
+    int publish(const std::string &image);
+
+    // maps the shared memory behind fd read-only; unmap with release
+    const char *map(int fd, std::size_t &size);
+    void release(const char *data, std::size_t size);
+
+    // descriptors travel in batches, as the kernel limits how many one message may carry
+    bool sendDescriptors(int channel, const std::vector<int> &fds);
+    bool receiveDescriptors(int channel, std::vector<int> &fds);
+#endif
+}
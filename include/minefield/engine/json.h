@@ -0,0 +1,127 @@
+#pragma once
+
+#include "minefield/engine/board.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Minimal JSON for the local API. The writer streams into a fixed buffer and the parser works inside the
+// text it is given, so messages cost no more than the bytes they contain.
+namespace json
+{
+    // Streaming serializer with automatic commas. A queue-backed writer appends its buffer to the queue
+    // whenever it fills up and reuses it, so a reply waits there for a slow socket; a plain one fails once
+    // full. A queue that cannot grow fails the writer instead of throwing. Nesting is limited to 64 levels.
+    class Writer
+    {
+    public:
+        Writer(char *buffer, std::size_t capacity, std::string *queue = nullptr);
+
+        Writer &beginObject();
+        Writer &endObject();
+        Writer &beginArray();
+        Writer &endArray();
+        Writer &key(std::string_view name);
+        Writer &value(std::string_view text);
+        Writer &value(const char *text);
+        Writer &value(std::uint64_t number);
+        Writer &value(unsigned int number);
+        Writer &value(bool flag);
+
+        // a string written piecewise with put(); the caller escapes its content
+        Writer &beginString();
+        Writer &endString();
+
+        // makes room in the queue for bytes more of this message, so writing them cannot run out of memory
+        bool reserve(std::size_t bytes);
+
+        // ends the message with a newline and, for a queue, appends what is left; false if anything failed,
+        // in which case no part of the message stays in the queue
+        bool finish();
+        void reset(); // drops the message, including what was already appended to the queue
+
+        bool failed() const;
+        std::size_t size() const;
+        const char *data() const;
+
+        void put(char ch);
+        void put(const char *text, std::size_t length);
+
+    private:
+        void separate();
+        void escaped(std::string_view text);
+        bool flush();
+
+        char *buffer;
+        std::size_t capacity;
+        std::size_t used = 0;
+        std::string *queue;
+        std::size_t start = 0; // queue size before the message
+        bool error = false;
+        bool afterKey = false;
+        unsigned int depth = 0;
+        std::uint64_t hasElements = 0; // bit per nesting level
+    };
+
+    // "cells": one base-32 digit per cell holding its CellStatusFlags, column-major, read straight from the board
+    void writeBoard(Writer &writer, const Board &board);
+
+    enum class TokenType : std::uint8_t
+    {
+        Object,
+        Array,
+        String,
+        Number,
+        True,
+        False,
+        Null
+    };
+
+    // a value in the parsed text; containers are followed by their children, and end is the index after the subtree
+    struct Token
+    {
+        TokenType type = TokenType::Null;
+        std::uint32_t start = 0;
+        std::uint32_t length = 0;
+        std::uint32_t children = 0; // elements of an array, keys of an object
+        std::uint32_t end = 0;
+    };
+
+    // In-place parser over a caller-owned token array. Strings are unescaped inside the text, which must
+    // outlive the document. Object members are stored as a key token followed by its value.
+    class Document
+    {
+    public:
+        Document(Token *tokens, std::size_t capacity);
+
+        bool parse(char *text, std::size_t length);
+
+        std::uint32_t root() const;
+        const Token &token(std::uint32_t index) const;
+
+        // index of the value stored under key, or 0 when it is missing (the root is never a member)
+        std::uint32_t find(std::uint32_t object, std::string_view key) const;
+        std::uint32_t firstChild(std::uint32_t container) const;
+        std::uint32_t nextSibling(std::uint32_t index) const;
+
+        std::string_view string(std::uint32_t index) const;
+        bool number(std::uint32_t index, std::uint64_t &value) const;
+
+    private:
+        bool parseValue(std::size_t &position);
+        bool parseString(std::size_t &position, Token &token);
+        bool parseNumber(std::size_t &position, Token &token);
+        bool parseLiteral(std::size_t &position, std::string_view literal, TokenType type);
+        bool push(std::uint32_t &index);
+        void skipSpace(std::size_t &position) const;
+
+        Token *tokens;
+        std::size_t capacity;
+        std::size_t count = 0;
+        unsigned int depth = 0;
+        char *text = nullptr;
+        std::size_t length = 0;
+    };
+}
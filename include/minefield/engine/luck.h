@@ -0,0 +1,76 @@
+#pragma once
+
+#include "minefield/engine/board.h"
+#include "minefield/engine/cache.h"
+#include "minefield/engine/sim.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Skill versus luck after the fact. For every recorded round, the hits and mine losses each seat could
+// expect from the round's starting state under both strategies are compared with what actually happened.
+// Summed over a game, expected loss differentials (skill) plus the surprises (luck) add up to the final
+// mine margin.
+namespace luck
+{
+    struct RoundLuck
+    {
+        double expectedHits1 = 0.0;
+        double expectedHits2 = 0.0;
+        unsigned int actualHits1 = 0;
+        unsigned int actualHits2 = 0;
+        double expectedLoss1 = 0.0; // collisions, hits taken and self-detonations
+        double expectedLoss2 = 0.0;
+        unsigned int actualLoss1 = 0;
+        unsigned int actualLoss2 = 0;
+    };
+
+    struct GameLuck
+    {
+        sim::Outcome outcome = sim::Outcome::Draw;
+        double skill = 0.0; // expected mine losses of seat 2 minus seat 1, summed over rounds
+        double luck = 0.0;  // actual minus expected loss differential, so skill + luck is the final mine margin
+        std::vector<RoundLuck> rounds;
+    };
+
+    struct Expectation
+    {
+        double hits1 = 0.0;
+        double hits2 = 0.0;
+        double loss1 = 0.0;
+        double loss2 = 0.0;
+    };
+
+    // Expected hits and losses per round start state (disabled cells, remaining mines, strategies), sampled once and
+    // shared by every game being analyzed. States are keyed by a hash of their canonical form, the mirror image or
+    // rotation of the board with the smallest hash, and are sampled on that form with the hash as seed: results are
+    // reproducible whichever thread computes them first, and survive eviction unchanged.
+    class ExpectationCache
+    {
+    public:
+        static constexpr std::size_t kDefaultCapacity = 1 << 16;
+
+        explicit ExpectationCache(unsigned int samples, std::size_t capacity = kDefaultCapacity);
+
+        Expectation lookup(const Board &board, const sim::Seat &first, const sim::Seat &second, unsigned int mines1, unsigned int mines2);
+
+        cache::Stats stats() const;
+        double savedMilliseconds() const; // hits times the mean time spent sampling a miss
+
+    private:
+        Expectation sample(const Board &board, const sim::Seat &first, const sim::Seat &second, unsigned int mines1, unsigned int mines2, std::uint64_t seed) const;
+
+        unsigned int samples;
+        cache::ClockCache<Expectation> entries;
+        std::atomic<std::uint64_t> missNanoseconds{0};
+    };
+
+    // replays the recorded positions through the game rules and scores every round against its expectation
+    GameLuck analyzeGame(const sim::GameReplay &replay, ExpectationCache &cache);
+
+    std::vector<GameLuck> analyzeArchive(const std::vector<sim::GameReplay> &archive, ExpectationCache &cache, unsigned int workers);
+    std::ostream &operator<<(std::ostream &stream, const std::vector<GameLuck> &games);
+}
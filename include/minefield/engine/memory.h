@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Optional huge-page backing for large buffers (board storage, simulation arenas). When enabled, blocks of
+// at least kHugeThreshold bytes are mapped with MAP_HUGETLB, then with transparent huge pages via
+// madvise(MADV_HUGEPAGE), then fall back to the regular heap. A small header records how each block was
+// obtained, so toggling the setting never affects how existing blocks are released.
+namespace memory
+{
+    constexpr std::size_t kHugePageSize = 2 * 1024 * 1024;
+    constexpr std::size_t kHugeThreshold = kHugePageSize / 2;
+    constexpr std::size_t kHeaderSize = 64; // blocks start cache-line aligned, so the returned block is too
+
+    enum class Backing : std::uint32_t
+    {
+        Heap,
+        Transparent, // mmap + madvise(MADV_HUGEPAGE)
+        Explicit     // mmap(MAP_HUGETLB)
+    };
+
+    struct Counters
+    {
+        std::atomic<std::uint64_t> heap{0};
+        std::atomic<std::uint64_t> transparent{0};
+        std::atomic<std::uint64_t> explicitHuge{0};
+    };
+
+    std::atomic<bool> &hugePagesEnabled();
+    Counters &counters();
+
+    void *allocate(std::size_t bytes);
+    void deallocate(void *block);
+
+    template <typename T>
+    struct HugePageAllocator
+    {
+        using value_type = T;
+
+        HugePageAllocator() = default;
+
+        template <typename U>
+        HugePageAllocator(const HugePageAllocator<U> &)
+        {
+        }
+
+        T *allocate(std::size_t count)
+        {
+            return static_cast<T *>(memory::allocate(count * sizeof(T)));
+        }
+
+        void deallocate(T *block, std::size_t)
+        {
+            memory::deallocate(block);
+        }
+
+        template <typename U>
+        bool operator==(const HugePageAllocator<U> &) const
+        {
+            return true;
+        }
+
+        template <typename U>
+        bool operator!=(const HugePageAllocator<U> &) const
+        {
+            return false;
+        }
+    };
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// stream sockets shared by the shard coordinator and the JSON server: Unix socket paths or host:port for TCP
+#ifndef _WIN32
+namespace net
+{
+    bool isTcpAddress(const std::string &address, std::string &host, std::string &port);
+
+    // a listening socket or a connected one; -1 on failure
+    int openSocket(const std::string &address, bool listening);
+
+    bool setNonBlocking(int fd);
+
+    bool sendAll(int fd, const char *data, std::size_t size);
+    // sends what a non-blocking socket takes right now and drops it from buffer; false once the peer is gone
+    bool sendPending(int fd, std::string &buffer);
+    bool sendLine(int fd, const std::string &line);
+
+    // appends whatever one recv returns; false once the peer is gone
+    bool receive(int fd, std::string &buffer);
+    bool takeLine(std::string &buffer, std::string &line);
+}
+#endif
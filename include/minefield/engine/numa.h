@@ -0,0 +1,58 @@
+#pragma once
+
+#include "minefield/engine/shard.h"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// NUMA-aware parallel simulation. Each worker is pinned to a CPU of its node before it allocates anything,
+// so under the first-touch policy every Board and Player it creates lives in that node's memory. Workers
+// only share the chunk counter; their counters sit in separate cache lines and are merged per node, then
+// globally, once the run ends.
+namespace numa
+{
+    struct Topology
+    {
+        std::vector<std::vector<unsigned int>> nodes; // CPUs of every node
+        std::vector<unsigned int> ids;                // its number in sysfs; nodes need not be numbered densely
+    };
+
+    // "0-3,8,10-11" -> {0, 1, 2, 3, 8, 10, 11}
+    std::vector<unsigned int> parseCpuList(const std::string &list);
+
+    // reads the nodes listed online in Linux sysfs; anything else is treated as a single node holding every CPU
+    Topology detectTopology();
+
+    bool pinCurrentThread(unsigned int cpu);
+
+    struct NodeReport
+    {
+        unsigned int node = 0;
+        unsigned int workers = 0;
+        shard::Stats stats;
+    };
+
+    struct RunReport
+    {
+        std::vector<NodeReport> nodes;
+        shard::Stats total;
+        double seconds = 0.0;
+        bool pinned = true;
+
+        double gamesPerSecond() const
+        {
+            return (seconds > 0.0) ? total.games() / seconds : 0.0;
+        }
+    };
+
+    struct alignas(64) WorkerSlot
+    {
+        shard::Stats stats;
+        bool pinned = false;
+    };
+
+    // plays the job on workersPerNode workers on each of the first nodeCount nodes
+    RunReport run(const shard::Job &job, const Topology &topology, unsigned int nodeCount, unsigned int workersPerNode);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Whole-board passes split into contiguous chunks, one per hardware thread, the caller running the first.
+// Below kMinParallelCells the pass runs serially on the calling thread, so small boards pay nothing; the
+// threshold is well above the cost of starting the threads.
+namespace parallel
+{
+    constexpr std::size_t kMinParallelCells = std::size_t{1} << 20;
+
+    // chunks a pass over count items of cellsPerItem cells each is split into
+    inline unsigned int chunksFor(std::size_t count, std::size_t cellsPerItem)
+    {
+        if (count * cellsPerItem < kMinParallelCells)
+        {
+            return 1;
+        }
+        const std::size_t threads = std::max(std::thread::hardware_concurrency(), 1U);
+        return static_cast<unsigned int>(std::min(threads, count));
+    }
+
+    // calls onChunk(chunk, first, last) for every chunk of [0, count), concurrently above the threshold
+    template <typename ChunkFnT>
+    void forChunks(std::size_t count, std::size_t cellsPerItem, ChunkFnT onChunk)
+    {
+        const unsigned int chunks = chunksFor(count, cellsPerItem);
+        if (chunks == 1)
+        {
+            onChunk(0U, std::size_t{0}, count);
+            return;
+        }
+        std::vector<std::thread> threads;
+        for (unsigned int chunk = 1; chunk < chunks; ++chunk)
+        {
+            threads.emplace_back([&onChunk, chunk, chunks, count]{ onChunk(chunk, count * chunk / chunks, count * (chunk + 1) / chunks); });
+        }
+        onChunk(0U, std::size_t{0}, count / chunks);
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    // sums onChunk(first, last) over the chunks of [0, count)
+    template <typename T, typename ChunkFnT>
+    T sumChunks(std::size_t count, std::size_t cellsPerItem, ChunkFnT onChunk)
+    {
+        if (chunksFor(count, cellsPerItem) == 1)
+        {
+            return onChunk(std::size_t{0}, count);
+        }
+        std::vector<T> partial(chunksFor(count, cellsPerItem), T{});
+        forChunks(count, cellsPerItem, [&](unsigned int chunk, std::size_t first, std::size_t last){ partial[chunk] = onChunk(first, last); });
+        T total{};
+        for (const T &value : partial)
+        {
+            total += value;
+        }
+        return total;
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "minefield/engine/board.h"
+#include "minefield/engine/game.h"
+#include "minefield/engine/player.h"
+#include "minefield/engine/sim.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Round resolution for rounds far too large for the pairwise scans of game::*. Mines and guesses are
+// radix partitioned by cell index into contiguous tiles of the board, in parallel: each chunk of a list
+// counts its positions per tile, a prefix sum gives every chunk its slots, and the chunks scatter. Each
+// tile then sorts its own share and resolves it with merge joins, writing only to its own cells and to
+// its own counters, which are summed at the end. Players and board end up exactly as game::* leaves them;
+// every position must lie on the board.
+namespace partition
+{
+    class RoundResolver
+    {
+    public:
+        static constexpr std::size_t kSerialThreshold = 2048; // smaller rounds go through game::* directly
+
+        // tiles is rounded up to a power of two; buffers are kept between rounds
+        RoundResolver(sim::WorkerPool &pool, unsigned int tiles);
+
+        // game::detectAndRemoveCollisions, returning the number of collided cells
+        unsigned int detectAndRemoveCollisions(Player &p1, Player &p2, Board &board);
+
+        // game::resolveGuesses
+        game::GuessTotals resolveGuesses(Player &p1, Player &p2, Board &board);
+
+    private:
+        struct Entry
+        {
+            std::uint32_t cell;
+            std::uint32_t element; // index in the list the position came from
+        };
+
+        struct List
+        {
+            const std::vector<Position> *positions = nullptr;
+            std::vector<Entry> entries;
+            std::vector<std::size_t> histogram; // per chunk and tile, then each chunk's first slot
+            std::vector<std::size_t> offsets;   // first entry of every tile, plus the end
+            std::vector<std::uint8_t> dropped;  // per element: removed by the round
+        };
+
+        // per tile, kept on separate cache lines
+        struct alignas(64) Counters
+        {
+            unsigned int values[4];
+        };
+
+        void setup(const Board &board, std::size_t lists);
+        void scatter(const Board &board, std::size_t lists);
+        template <typename TileFnT>
+        void forEachTile(TileFnT onTile);
+        const Entry *begin(std::size_t list, unsigned int tile) const;
+        const Entry *end(std::size_t list, unsigned int tile) const;
+        unsigned int sum(std::size_t counter) const;
+        static void keepSurvivors(std::vector<Position> &positions, const std::vector<std::uint8_t> &dropped);
+
+        sim::WorkerPool &pool;
+        unsigned int tiles;
+        unsigned int shift = 0;
+        List lists[4];
+        std::vector<Counters> counters;
+    };
+
+    // game::detectAndRemoveCollisions and game::resolveGuesses for callers without a pool of their own, as
+    // sim::playGame and session::playRound: rounds below kSerialThreshold go to game::* directly, larger ones
+    // to a resolver of the calling thread on a pool shared by every caller and started on the first of them
+    unsigned int detectAndRemoveCollisions(Player &p1, Player &p2, Board &board);
+    game::GuessTotals resolveGuesses(Player &p1, Player &p2, Board &board);
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "minefield/engine/board.h"
+
+#include <string>
+#include <vector>
+
+struct Player
+{
+    bool isHuman = true;
+    std::string name = "Player";
+    unsigned int remainingMines = 0;
+    std::vector<Position> currentMines;
+    std::vector<Position> currentGuesses;
+};
+
+// a player holding mines and no positions yet; spelled out so callers need not list every member
+inline Player makePlayer(bool isHuman, const std::string &name, unsigned int mines)
+{
+    Player player;
+    player.isHuman = isHuman;
+    player.name = name;
+    player.remainingMines = mines;
+    return player;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+
+// hardware counters for the memory benchmarks
+namespace profiling
+{
+    // dTLB read misses (user space) of the constructing thread and of the threads it starts afterwards, through
+    // perf_event_open; valid() is false when the platform or the process permissions do not provide the counter.
+    // A thread's misses are counted once it has exited, so joined workers are in stop() and running ones are not.
+    class TlbMissCounter
+    {
+    public:
+        TlbMissCounter();
+        ~TlbMissCounter();
+        TlbMissCounter(const TlbMissCounter &) = delete;
+        TlbMissCounter &operator=(const TlbMissCounter &) = delete;
+
+        bool valid() const;
+        void start();
+        std::uint64_t stop();
+
+    private:
+        int fd = -1;
+    };
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+
+// The plain types of a game and the seed mixing every decision is derived from, shared by the engine and
+// the heap-free core; nothing here allocates.
+enum class CpuStrategy
+{
+    Random,  // uniform among free cells, same as utils::generateRandomPosition
+    Cautious // like Random, but never guesses a cell holding one of its own mines
+};
+
+namespace sim
+{
+    enum class Outcome
+    {
+        Draw,
+        FirstSeatWins,
+        SecondSeatWins
+    };
+
+    struct GameConfig
+    {
+        unsigned int width = 4;
+        unsigned int height = 4;
+        unsigned int mines = 3;
+    };
+
+    struct Seat
+    {
+        CpuStrategy strategy = CpuStrategy::Random;
+        std::uint64_t seed = 0;
+        bool antithetic = false;
+    };
+
+    struct GameResult
+    {
+        Outcome outcome = Outcome::Draw;
+        unsigned int rounds = 0;
+    };
+}
+
+namespace utils
+{
+    // splitmix64 finalizer: derives independent stream seeds from (base seed, index)
+    inline std::uint64_t mixSeed(std::uint64_t seed, std::uint64_t index)
+    {
+        std::uint64_t z = seed + (index + 1) * 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+}
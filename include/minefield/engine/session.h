@@ -0,0 +1,68 @@
+#pragma once
+
+#include "minefield/engine/board.h"
+#include "minefield/engine/player.h"
+#include "minefield/engine/sim.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Games driven round by round with positions chosen outside the engine, as the C API and the JSON server
+// play them. Rounds follow the rules of sim::playGame, but every position is validated first.
+namespace session
+{
+    struct Game
+    {
+        explicit Game(const sim::GameConfig &config);
+
+        Board board;
+        Player seats[2];
+        bool finished = false;
+        sim::Outcome outcome = sim::Outcome::Draw; // meaningful once finished
+    };
+
+    // Each seat places min(its remaining mines, free cells) mines and guesses min(the opponent's remaining
+    // mines, free cells) cells, both counted after this round's collisions.
+    struct RoundInput
+    {
+        const Position *mines[2] = {nullptr, nullptr};
+        const Position *guesses[2] = {nullptr, nullptr};
+        std::uint32_t mineCount[2] = {0, 0};
+        std::uint32_t guessCount[2] = {0, 0};
+    };
+
+    struct RoundResult
+    {
+        std::uint32_t hits[2] = {0, 0}; // opponent mines found by each seat
+        std::uint32_t collisions = 0;
+    };
+
+    enum class RoundStatus
+    {
+        Ok,
+        InvalidMove, // wrong count, a cell outside the board, disabled or listed twice
+        GameOver
+    };
+
+    // Per-cell stamps reused by every round: a cell is marked by a list when its stamp equals the one handed
+    // out for that list, so validation needs no clearing and no allocation once warm.
+    class CellMarks
+    {
+    public:
+        std::uint32_t fresh(std::size_t cells);
+        std::uint32_t &operator[](std::size_t cell);
+
+    private:
+        std::vector<std::uint32_t> stamps;
+        std::uint32_t current = 0;
+    };
+
+    // mine counts for the next round and the guess counts before collisions lower them
+    void expectedCounts(const Game &game, std::uint32_t mineCount[2], std::uint32_t maxGuessCount[2]);
+
+    // checks the whole round against the state before it, so a rejected round leaves the game untouched
+    RoundStatus validateRound(const Game &game, const RoundInput &input, CellMarks &marks, std::uint32_t &collisions);
+
+    RoundStatus playRound(Game &game, const RoundInput &input, CellMarks &marks, RoundResult &result);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "minefield/engine/sim.h"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Simulation sharded over worker processes. A coordinator splits the game indices into ranges and hands
+// them out over a socket; workers only receive the address, play their ranges and send back integer
+// counters. Every game is seeded by its index and counters merge exactly, so the totals are identical to a
+// single-process run whatever the worker count, and ranges held by a worker that disconnects are reissued.
+// Addresses are Unix socket paths locally or host:port for TCP, which is all that changes on real nodes.
+namespace shard
+{
+    struct Job
+    {
+        sim::GameConfig config;
+        CpuStrategy first = CpuStrategy::Random;
+        CpuStrategy second = CpuStrategy::Random;
+        std::uint64_t seed = 0;
+        std::uint64_t games = 0;
+    };
+
+    struct Stats
+    {
+        std::uint64_t wins = 0; // first seat
+        std::uint64_t draws = 0;
+        std::uint64_t losses = 0;
+        std::uint64_t rounds = 0;
+
+        void merge(const Stats &other)
+        {
+            wins += other.wins;
+            draws += other.draws;
+            losses += other.losses;
+            rounds += other.rounds;
+        }
+
+        std::uint64_t games() const
+        {
+            return wins + draws + losses;
+        }
+    };
+
+    Stats playRange(const Job &job, std::uint64_t first, std::uint64_t count);
+    std::ostream &operator<<(std::ostream &stream, const Stats &stats);
+
+#ifndef _WIN32
+    struct CoordinatorReport
+    {
+        Stats stats;
+        unsigned int reissued = 0;
+        unsigned int respawned = 0;
+    };
+
+    // Serves ranges of rangeSize games until every game of the job has been reported. Local worker
+    // processes that die are replaced; external workers may connect at any time.
+    bool coordinate(const Job &job, const std::string &address, unsigned int processes, std::uint64_t rangeSize, const char *executable, CoordinatorReport &report);
+
+    // worker process: receives the job and ranges from the coordinator until it says DONE
+    int work(const std::string &address);
+#endif
+}
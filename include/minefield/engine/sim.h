@@ -0,0 +1,296 @@
+#pragma once
+
+#include "minefield/engine/board.h"
+#include "minefield/engine/cpu.h"
+#include "minefield/engine/player.h"
+#include "minefield/engine/rules.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// headless CPU-vs-CPU games for strategy evaluation
+namespace sim
+{
+    Board makeBoard(const GameConfig &config);
+
+    // CPU counterpart of game::collectPositions. The count is capped by the free cells left, where the
+    // interactive loop would spin forever. Decision seeds depend on (round, phase, pick) only, so games
+    // sharing a seat seed stay coupled even after their choices diverge.
+    void collectCpuPositions(const Seat &seat, Player &player, unsigned int count, Board &board, unsigned int round, std::vector<Position> &targetList, bool markMinesOnBoard);
+
+    Outcome outcomeOf(const Player &p1, const Player &p2);
+
+    // one recorded round: positions as the seats chose them, before collisions removed any mine
+    struct RoundRecord
+    {
+        std::vector<Position> mines1;
+        std::vector<Position> mines2;
+        std::vector<Position> guesses1;
+        std::vector<Position> guesses2;
+    };
+
+    struct GameReplay
+    {
+        GameConfig config;
+        Seat first;
+        Seat second;
+        GameResult result;
+        std::vector<RoundRecord> rounds;
+    };
+
+    // placement, collision and guessing phases of one round; the caller resolves the guesses
+    void placeAndGuess(const Seat &first, const Seat &second, Player &p1, Player &p2, Board &board, unsigned int round, RoundRecord *record);
+
+    // Plays one silent game with the same rules as game::runMainLoop. A board with no free cells left
+    // ends the game and the seat holding more mines wins. Rounds are recorded into replay when given.
+    GameResult playGame(const GameConfig &config, const Seat &first, const Seat &second, GameReplay *replay = nullptr);
+
+    // 1 for a win, 0.5 for a draw, 0 for a loss, seen from the given seat
+    double scoreFor(const GameResult &result, bool firstSeat);
+
+    struct ComparisonReport
+    {
+        CpuStrategy candidate = CpuStrategy::Random;
+        CpuStrategy incumbent = CpuStrategy::Random;
+        CpuStrategy reference = CpuStrategy::Random;
+        unsigned int pairs = 0;
+        unsigned int games = 0;
+        double candidateScore = 0.0;
+        double incumbentScore = 0.0;
+        double difference = 0.0;
+        double standardError = 0.0;
+        double varianceReduction = 0.0; // games an independent comparison needs per game of the paired one
+    };
+
+    // Each "pair" replays the same two seeds (common random numbers) for the candidate and the incumbent
+    // against the reference strategy, in both seats and with plain and antithetic streams: 4 games each.
+    // The per-pair score difference is far less noisy than two independent win rates.
+    ComparisonReport compareStrategies(const GameConfig &config, CpuStrategy candidate, CpuStrategy incumbent, CpuStrategy reference, unsigned int pairs, std::uint64_t seed);
+
+    std::ostream &operator<<(std::ostream &stream, const ComparisonReport &report);
+    unsigned int defaultWorkerCount();
+
+    // results a worker may finish ahead of the oldest one not yet handed out, per worker
+    constexpr std::uint64_t kReorderWindowPerWorker = 16;
+
+    // Plays games on worker threads and hands each result to onResult on the calling thread in index order, so
+    // a run stops at the same game whatever the thread timing was. Results finished early wait in a window of
+    // kReorderWindowPerWorker per worker; a worker that would get further ahead waits for the window to move.
+    // Once onResult returns false, or maxGames games were handed out, the workers stop after their current game.
+    // playIndexed(index) may return any result type; onResult receives (index, result).
+    template <typename PlayFnT, typename OnResultFnT>
+    void runParallel(unsigned int workers, std::uint64_t maxGames, PlayFnT playIndexed, OnResultFnT onResult)
+    {
+        using ResultT = decltype(playIndexed(std::uint64_t{}));
+        const std::uint64_t window = kReorderWindowPerWorker * std::max(workers, 1U);
+        std::atomic<std::uint64_t> nextGame{0};
+        std::atomic<bool> stop{false};
+        std::mutex mutex;
+        std::condition_variable arrived;
+        std::condition_variable moved; // the window moved on, or the run stopped
+        std::map<std::uint64_t, ResultT> results; // finished and not handed out yet
+        std::uint64_t nextToHand = 0;
+        unsigned int runningWorkers = workers;
+
+        std::vector<std::thread> threads;
+        for (unsigned int w = 0; w < workers; ++w)
+        {
+            threads.emplace_back([&]()
+                {
+                    while (!stop.load(std::memory_order_relaxed))
+                    {
+                        const std::uint64_t index = nextGame.fetch_add(1, std::memory_order_relaxed);
+                        if (index >= maxGames)
+                        {
+                            break;
+                        }
+                        {
+                            std::unique_lock<std::mutex> lock(mutex);
+                            moved.wait(lock, [&]{ return index < nextToHand + window || stop.load(); });
+                        }
+                        if (stop.load())
+                        {
+                            break;
+                        }
+                        ResultT result = playIndexed(index);
+                        std::lock_guard<std::mutex> lock(mutex);
+                        results.emplace(index, std::move(result));
+                        arrived.notify_one();
+                    }
+                    std::lock_guard<std::mutex> lock(mutex);
+                    runningWorkers--;
+                    arrived.notify_one();
+                });
+        }
+
+        bool wantMore = true;
+        std::unique_lock<std::mutex> lock(mutex);
+        const auto nextReady = [&]{ return !results.empty() && results.begin()->first == nextToHand; };
+        while (true)
+        {
+            arrived.wait(lock, [&]{ return nextReady() || runningWorkers == 0; });
+            if (!nextReady())
+            {
+                break; // every worker is done, and the games after a stop leave gaps
+            }
+            auto item = results.extract(results.begin());
+            nextToHand++;
+            moved.notify_all();
+            if (wantMore)
+            {
+                lock.unlock();
+                wantMore = onResult(item.key(), item.mapped());
+                lock.lock();
+                if (!wantMore)
+                {
+                    stop = true;
+                    moved.notify_all();
+                }
+            }
+        }
+        lock.unlock();
+
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    // Fixed set of threads shared by every job submitted to it, so many small batches reuse the same workers.
+    class WorkerPool
+    {
+    public:
+        explicit WorkerPool(unsigned int workers);
+        ~WorkerPool();
+
+        void submit(std::function<void()> job);
+        void wait(); // blocks until every submitted job has finished
+
+    private:
+        void work();
+
+        std::vector<std::thread> threads;
+        std::deque<std::function<void()>> jobs;
+        std::mutex mutex;
+        std::condition_variable jobAvailable;
+        std::condition_variable allDone;
+        unsigned int pending = 0;
+        bool closing = false;
+    };
+
+    struct MatchTally
+    {
+        std::uint64_t wins = 0;
+        std::uint64_t draws = 0;
+        std::uint64_t losses = 0;
+        double sum = 0.0;
+        double sumSq = 0.0;
+
+        void add(double score)
+        {
+            if (score == 1.0)
+            {
+                wins++;
+            }
+            else if (score == 0.0)
+            {
+                losses++;
+            }
+            else
+            {
+                draws++;
+            }
+            sum += score;
+            sumSq += score * score;
+        }
+
+        std::uint64_t games() const
+        {
+            return wins + draws + losses;
+        }
+
+        double mean() const
+        {
+            return games() ? sum / games() : 0.0;
+        }
+
+        double variance() const
+        {
+            const double n = static_cast<double>(games());
+            return (n > 1) ? std::max((sumSq - n * mean() * mean()) / (n - 1), 0.0) : 0.0;
+        }
+    };
+
+    enum class SprtDecision
+    {
+        Undecided,
+        AcceptH0, // strategy A is not better than B by delta
+        AcceptH1  // strategy A scores at least 0.5 + delta against B
+    };
+
+    struct SprtSettings
+    {
+        double delta = 0.05;
+        double alpha = 0.05;
+        double beta = 0.05;
+        std::uint64_t maxGames = 1000000;
+        unsigned int workers = 1;
+        std::uint64_t seed = 0;
+    };
+
+    struct SprtReport
+    {
+        CpuStrategy first = CpuStrategy::Random;
+        CpuStrategy second = CpuStrategy::Random;
+        SprtSettings settings;
+        MatchTally tally;
+        double llr = 0.0;
+        double lowerBound = 0.0;
+        double upperBound = 0.0;
+        SprtDecision decision = SprtDecision::Undecided;
+    };
+
+    // Head-to-head game i of a match: consecutive games share seeds and swap seats, like compareStrategies.
+    GameResult playMatchGame(const GameConfig &config, CpuStrategy a, CpuStrategy b, std::uint64_t seed, std::uint64_t index, bool &aFirst);
+
+    // Sequential probability ratio test on A's score against B, H0: 0.5 vs H1: 0.5 + delta, using the
+    // normal approximation of the log-likelihood ratio (the GSPRT used for engine testing). Results are
+    // folded in as workers deliver them and the match stops as soon as a bound is crossed.
+    SprtReport runSprt(const GameConfig &config, CpuStrategy a, CpuStrategy b, const SprtSettings &settings);
+
+    std::ostream &operator<<(std::ostream &stream, const SprtReport &report);
+
+    struct PrecisionSettings
+    {
+        double epsilon = 0.01; // target half-width of the 95% interval
+        std::uint64_t minGames = 100;
+        std::uint64_t maxGames = 10000000;
+        unsigned int workers = 1;
+        std::uint64_t seed = 0;
+    };
+
+    struct PrecisionReport
+    {
+        CpuStrategy first = CpuStrategy::Random;
+        CpuStrategy second = CpuStrategy::Random;
+        PrecisionSettings settings;
+        MatchTally tally; // from the first seat's point of view
+        double halfWidth = 0.0;
+        bool reached = false;
+    };
+
+    // Estimates the first seat's score for one configuration, stopping once the 95% interval is narrower than epsilon.
+    PrecisionReport estimateScore(const GameConfig &config, CpuStrategy first, CpuStrategy second, const PrecisionSettings &settings);
+
+    std::ostream &operator<<(std::ostream &stream, const PrecisionReport &report);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "minefield/engine/sim.h"
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Balance study over a grid of board sizes and mine counts. Every configuration starts with a small batch;
+// later batches go to the configurations whose 95% interval is widest, doubled in weight while the interval
+// still straddles the decision threshold. All batches run on one shared WorkerPool and each configuration
+// is appended to the output as soon as it is resolved.
+namespace sweep
+{
+    struct Settings
+    {
+        std::vector<unsigned int> sizes = {3, 4, 5, 6, 8};
+        std::vector<unsigned int> mines = {1, 2, 3, 5, 8};
+        CpuStrategy first = CpuStrategy::Cautious;
+        CpuStrategy second = CpuStrategy::Random;
+        double threshold = 0.5; // first-seat score separating "first seat favoured" from "second seat favoured"
+        double epsilon = 0.01;  // half-width at which a configuration counts as resolved
+        std::uint64_t initialGames = 256;
+        std::uint64_t batchGames = 4096; // games handed out per allocation step, across configurations
+        std::uint64_t budget = 2000000;
+        unsigned int workers = 1;
+        std::uint64_t seed = 0;
+    };
+
+    struct Point
+    {
+        sim::GameConfig config;
+        sim::MatchTally tally;
+        double rounds = 0.0;
+        std::uint64_t nextGame = 0;
+        bool resolved = false;
+    };
+
+    std::vector<Point> run(const Settings &settings, std::ostream &out, std::ostream &progress);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "minefield/engine/board.h"
+#include "minefield/engine/rules.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace utils
+{
+    template <typename OnValidCellFnT>
+    void safeCellAccess(Board &board, unsigned int col, unsigned int row, OnValidCellFnT onValidCell)
+    {
+        board.safeCellAccess(col, row, onValidCell);
+    }
+
+    void clearInput();
+
+    inline void initializeRandom()
+    {
+        std::srand(static_cast<unsigned int>(std::time(nullptr)));
+    }
+
+    inline bool samePosition(const Position &a, const Position &b)
+    {
+        return ((a.column == b.column) && (a.row == b.row));
+    }
+
+    Position generateRandomPosition(const Board &board);
+
+    // free (non-disabled) cells that are not listed in skip
+    std::vector<Position> collectFreeCells(const Board &board, const std::vector<Position> &skip);
+    unsigned int countFreeCells(const Board &board);
+
+    // Counter-based choice used by CPU players: each candidate gets the key mixSeed(decisionSeed, cell index)
+    // and the lowest key wins (the highest for antithetic games). Over a random seed the pick is uniform, and
+    // two strategies sharing a seed agree on every decision their candidate sets allow.
+    Position pickByKey(const Board &board, const std::vector<Position> &candidates, std::uint64_t decisionSeed, bool antithetic);
+
+    // discards everything written to it; used to run the game rules silently
+    std::ostream &nullStream();
+
+    std::vector<Position> removeCollidingMines(const std::vector<Position> &ownMines, const std::vector<Position> &opponentMines, std::vector<Position> &collisions, Board &board);
+    std::vector<Position> keepNonCollidingMines(const std::vector<Position> &ownMines, const std::vector<Position> &opponentMines);
+
+    Position requestPosition(const std::string &prompt, const Board &board);
+    unsigned int chooseValidDimension(const std::string &prompt, int min_val, int max_val);
+}
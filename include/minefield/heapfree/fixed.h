@@ -0,0 +1,430 @@
+#pragma once
+
+#include "minefield/engine/cell.h"
+#include "minefield/engine/rules.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// The game core with every container sized at compile time, for runtimes without a heap and for callers
+// that cannot afford one on the hot path: boards hold MaxWidth x MaxHeight cells inline, players hold their
+// mines and guesses in inline arrays, and events go to a fixed ring that drops the oldest. Nothing here
+// allocates, throws or uses std::string or std::function; the minefield.heapfree executable is linked so
+// that any call reaching the heap fails the link (see project_config.cmake).
+//
+// playGame follows the rules of sim::playGame decision for decision: the same seats give the same game.
+// Objects are as large as their capacity, so large boards belong in static storage rather than on the stack.
+namespace heapfree
+{
+    template <std::size_t N>
+    class PositionArray
+    {
+    public:
+        static constexpr std::size_t capacity()
+        {
+            return N;
+        }
+
+        std::size_t size() const
+        {
+            return count;
+        }
+
+        bool empty() const
+        {
+            return count == 0;
+        }
+
+        // false when full
+        bool push_back(const Position &position)
+        {
+            if (count == N)
+            {
+                return false;
+            }
+            items[count++] = position;
+            return true;
+        }
+
+        void clear()
+        {
+            count = 0;
+        }
+
+        // shrinks only
+        void resize(std::size_t size)
+        {
+            count = (size < count) ? size : count;
+        }
+
+        const Position &operator[](std::size_t index) const
+        {
+            return items[index];
+        }
+
+        Position &operator[](std::size_t index)
+        {
+            return items[index];
+        }
+
+        const Position *begin() const
+        {
+            return items.data();
+        }
+
+        const Position *end() const
+        {
+            return items.data() + count;
+        }
+
+        bool contains(const Position &position) const
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                if (items[i].column == position.column && items[i].row == position.row)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    private:
+        std::array<Position, N> items{};
+        std::size_t count = 0;
+    };
+
+    // cells column-major like ::Board, cell (col, row) at col * height + row
+    template <unsigned int MaxWidth, unsigned int MaxHeight>
+    class FixedBoard
+    {
+    public:
+        static_assert(MaxWidth > 0 && MaxHeight > 0, "a board needs at least one cell");
+
+        static constexpr bool fits(unsigned int width, unsigned int height)
+        {
+            return width > 0 && height > 0 && width <= MaxWidth && height <= MaxHeight;
+        }
+
+        // callers check fits(w, h) first; a size that does not fit is clamped to the capacity
+        FixedBoard(unsigned int w, unsigned int h)
+            : width(w < MaxWidth ? w : MaxWidth)
+            , height(h < MaxHeight ? h : MaxHeight)
+        {
+        }
+
+        unsigned int getWidth() const
+        {
+            return width;
+        }
+
+        unsigned int getHeight() const
+        {
+            return height;
+        }
+
+        bool isValidPosition(unsigned int col, unsigned int row) const
+        {
+            return col < width && row < height;
+        }
+
+        bool isDisabled(unsigned int col, unsigned int row) const
+        {
+            return isValidPosition(col, row) && hasFlag(grid[cellIndex(col, row)], CellStatusFlags::Disabled);
+        }
+
+        CellStatusFlags getCellStatus(unsigned int col, unsigned int row) const
+        {
+            return isValidPosition(col, row) ? grid[cellIndex(col, row)] : CellStatusFlags::None;
+        }
+
+        // sets and clears flags of a cell on the board; positions off the board are ignored
+        void update(const Position &position, CellStatusFlags set, CellStatusFlags clear = CellStatusFlags::None)
+        {
+            if (isValidPosition(position.column, position.row))
+            {
+                CellStatusFlags &status = grid[cellIndex(position.column, position.row)];
+                status = (status | set) & ~clear;
+            }
+        }
+
+        unsigned int countFreeCells() const
+        {
+            unsigned int count = 0;
+            for (std::size_t i = 0; i < static_cast<std::size_t>(width) * height; ++i)
+            {
+                count += hasFlag(grid[i], CellStatusFlags::Disabled) ? 0 : 1;
+            }
+            return count;
+        }
+
+        void clearMines()
+        {
+            for (std::size_t i = 0; i < static_cast<std::size_t>(width) * height; ++i)
+            {
+                grid[i] = grid[i] & ~CellStatusFlags::HasMine;
+            }
+        }
+
+    private:
+        std::size_t cellIndex(unsigned int col, unsigned int row) const
+        {
+            return static_cast<std::size_t>(col) * height + row;
+        }
+
+        unsigned int width;
+        unsigned int height;
+        std::array<CellStatusFlags, static_cast<std::size_t>(MaxWidth) * MaxHeight> grid{};
+    };
+
+    template <unsigned int MaxMines>
+    struct FixedPlayer
+    {
+        const char *name = "Player";
+        unsigned int remainingMines = 0;
+        PositionArray<MaxMines> currentMines;
+        PositionArray<MaxMines> currentGuesses; // never more than the opponent's mines
+    };
+
+    enum class EventKind : std::uint8_t
+    {
+        Placed,       // a mine, before collisions
+        Collision,    // both seats placed a mine on the cell; seat is the first one
+        Guessed,
+        Hit,          // the guess found a mine of the opponent
+        SelfDetonated // the seat guessed a cell holding its own mine
+    };
+
+    struct Event
+    {
+        unsigned int round = 0;
+        EventKind kind = EventKind::Placed;
+        std::uint8_t seat = 0; // 0 for the first seat
+        Position position;
+    };
+
+    // the last N events; older ones are overwritten and counted as dropped
+    template <std::size_t N>
+    class EventRing
+    {
+    public:
+        static_assert(N > 0, "an event ring needs room for one event");
+
+        void push(const Event &event)
+        {
+            events[static_cast<std::size_t>(total % N)] = event;
+            total++;
+        }
+
+        void clear()
+        {
+            total = 0;
+        }
+
+        std::size_t size() const
+        {
+            return (total < N) ? static_cast<std::size_t>(total) : N;
+        }
+
+        std::uint64_t dropped() const
+        {
+            return total - size();
+        }
+
+        // oldest first
+        const Event &operator[](std::size_t index) const
+        {
+            return events[static_cast<std::size_t>((total - size() + index) % N)];
+        }
+
+    private:
+        std::array<Event, N> events{};
+        std::uint64_t total = 0;
+    };
+
+    // a sink for playGame that keeps nothing
+    struct NoEvents
+    {
+        void push(const Event &)
+        {
+        }
+    };
+
+    // The counter-based choice of utils::pickByKey over the free cells not in chosen, without building the
+    // candidate list: cells are visited in the same column-major order, so ties resolve the same way.
+    // Guesses of a cautious seat skip its own mines while any other cell is left.
+    template <typename BoardT, std::size_t N, std::size_t M>
+    Position pickCell(const BoardT &board, const PositionArray<N> &chosen, const PositionArray<M> *ownMines, std::uint64_t decisionSeed, bool antithetic)
+    {
+        Position best;
+        Position bestSafe;
+        std::uint64_t bestKey = 0;
+        std::uint64_t bestSafeKey = 0;
+        bool any = false;
+        bool anySafe = false;
+        for (unsigned int c = 0; c < board.getWidth(); ++c)
+        {
+            for (unsigned int r = 0; r < board.getHeight(); ++r)
+            {
+                const Position cell = {c, r};
+                if (board.isDisabled(c, r) || chosen.contains(cell))
+                {
+                    continue;
+                }
+                const std::uint64_t key = utils::mixSeed(decisionSeed, static_cast<std::uint64_t>(r) * board.getWidth() + c);
+                if (!any || (antithetic ? key > bestKey : key < bestKey))
+                {
+                    best = cell;
+                    bestKey = key;
+                    any = true;
+                }
+                if (ownMines && !ownMines->contains(cell) && (!anySafe || (antithetic ? key > bestSafeKey : key < bestSafeKey)))
+                {
+                    bestSafe = cell;
+                    bestSafeKey = key;
+                    anySafe = true;
+                }
+            }
+        }
+        return anySafe ? bestSafe : best;
+    }
+
+    // sim::collectCpuPositions on a fixed board
+    template <typename BoardT, unsigned int MaxMines, typename SinkT>
+    void collectPositions(const sim::Seat &seat, std::uint8_t seatIndex, FixedPlayer<MaxMines> &player, unsigned int count, BoardT &board, unsigned int round,
+        bool markMinesOnBoard, SinkT &events)
+    {
+        PositionArray<MaxMines> &target = markMinesOnBoard ? player.currentMines : player.currentGuesses;
+        target.clear();
+        const unsigned int free = board.countFreeCells();
+        const unsigned int wanted = (count < free) ? count : free;
+        const std::uint64_t phaseSeed = utils::mixSeed(seat.seed, 2ULL * round + (markMinesOnBoard ? 0 : 1));
+        while (target.size() < wanted)
+        {
+            const std::uint64_t decisionSeed = utils::mixSeed(phaseSeed, target.size());
+            const bool cautious = !markMinesOnBoard && seat.strategy == CpuStrategy::Cautious;
+            const Position position = pickCell(board, target, cautious ? &player.currentMines : nullptr, decisionSeed, seat.antithetic);
+            if (markMinesOnBoard)
+            {
+                board.update(position, CellStatusFlags::HasMine);
+            }
+            target.push_back(position);
+            events.push({round, markMinesOnBoard ? EventKind::Placed : EventKind::Guessed, seatIndex, position});
+        }
+    }
+
+    inline unsigned int saturatingSubtract(unsigned int value, unsigned int amount)
+    {
+        return (value >= amount) ? value - amount : 0;
+    }
+
+    // One game under the rules of sim::playGame, events going to events. False, with nothing played, when the
+    // configuration does not fit the capacities.
+    template <unsigned int MaxWidth, unsigned int MaxHeight, unsigned int MaxMines, typename SinkT>
+    bool playGame(const sim::GameConfig &config, const sim::Seat &first, const sim::Seat &second, sim::GameResult &result, SinkT &events)
+    {
+        if (!FixedBoard<MaxWidth, MaxHeight>::fits(config.width, config.height) || config.mines > MaxMines)
+        {
+            return false;
+        }
+        FixedBoard<MaxWidth, MaxHeight> board(config.width, config.height);
+        FixedPlayer<MaxMines> players[2];
+        players[0].name = "CPU 1";
+        players[1].name = "CPU 2";
+        players[0].remainingMines = players[1].remainingMines = config.mines;
+        const sim::Seat *seats[2] = {&first, &second};
+
+        result = sim::GameResult{};
+        bool finished = false;
+        while (!finished)
+        {
+            const unsigned int round = ++result.rounds;
+            board.clearMines();
+            for (std::uint8_t s = 0; s < 2; ++s)
+            {
+                collectPositions(*seats[s], s, players[s], players[s].remainingMines, board, round, true, events);
+            }
+
+            // mines both seats placed on a cell are removed from both and disable the cell
+            PositionArray<MaxMines> kept[2];
+            for (std::uint8_t s = 0; s < 2; ++s)
+            {
+                for (const Position &mine : players[s].currentMines)
+                {
+                    if (!players[1 - s].currentMines.contains(mine))
+                    {
+                        kept[s].push_back(mine);
+                    }
+                    else if (s == 0)
+                    {
+                        board.update(mine, CellStatusFlags::HadCollision | CellStatusFlags::Disabled, CellStatusFlags::HasMine);
+                        events.push({round, EventKind::Collision, s, mine});
+                    }
+                }
+            }
+            for (std::uint8_t s = 0; s < 2; ++s)
+            {
+                players[s].remainingMines = saturatingSubtract(players[s].remainingMines, static_cast<unsigned int>(players[s].currentMines.size() - kept[s].size()));
+                players[s].currentMines = kept[s];
+            }
+
+            for (std::uint8_t s = 0; s < 2; ++s)
+            {
+                collectPositions(*seats[s], s, players[s], players[1 - s].remainingMines, board, round, false, events);
+            }
+
+            // game::resolveGuesses: hits on the opponent, then guesses on a seat's own mines detonate them
+            unsigned int hits[2] = {0, 0};
+            for (std::uint8_t s = 0; s < 2; ++s)
+            {
+                for (const Position &guess : players[s].currentGuesses)
+                {
+                    if (players[1 - s].currentMines.contains(guess))
+                    {
+                        hits[s]++;
+                        events.push({round, EventKind::Hit, s, guess});
+                    }
+                    board.update(guess, CellStatusFlags::Disabled | CellStatusFlags::WasGuessed);
+                }
+            }
+            players[1].remainingMines = saturatingSubtract(players[1].remainingMines, hits[0]);
+            players[0].remainingMines = saturatingSubtract(players[0].remainingMines, hits[1]);
+            for (std::uint8_t s = 0; s < 2; ++s)
+            {
+                FixedPlayer<MaxMines> &player = players[s];
+                std::size_t survivors = 0;
+                for (std::size_t i = 0; i < player.currentMines.size(); ++i)
+                {
+                    const Position mine = player.currentMines[i];
+                    if (player.currentGuesses.contains(mine))
+                    {
+                        board.update(mine, CellStatusFlags::Disabled | CellStatusFlags::SelfDetonated, CellStatusFlags::HasMine);
+                        events.push({round, EventKind::SelfDetonated, s, mine});
+                    }
+                    else
+                    {
+                        player.currentMines[survivors++] = mine;
+                    }
+                }
+                player.remainingMines = saturatingSubtract(player.remainingMines, static_cast<unsigned int>(player.currentMines.size() - survivors));
+                player.currentMines.resize(survivors);
+            }
+
+            finished = players[0].remainingMines == 0 || players[1].remainingMines == 0 || board.countFreeCells() == 0;
+        }
+
+        if (players[0].remainingMines != players[1].remainingMines)
+        {
+            result.outcome = (players[0].remainingMines > players[1].remainingMines) ? sim::Outcome::FirstSeatWins : sim::Outcome::SecondSeatWins;
+        }
+        return true;
+    }
+
+    template <unsigned int MaxWidth, unsigned int MaxHeight, unsigned int MaxMines>
+    bool playGame(const sim::GameConfig &config, const sim::Seat &first, const sim::Seat &second, sim::GameResult &result)
+    {
+        NoEvents events;
+        return playGame<MaxWidth, MaxHeight, MaxMines>(config, first, second, result, events);
+    }
+}
@@ -38,6 +38,10 @@ function(configure_subprojects main_project_name out_link_libraries)
             add_dependencies(${subproject_name} ${project_config_${subproject_name}_dependencies})
         endif()
 
+        if (project_config_${subproject_name}_version)
+            set_target_properties(${subproject_name} PROPERTIES VERSION ${project_config_${subproject_name}_version} SOVERSION ${project_config_${subproject_name}_soversion})
+        endif()
+
         if (project_config_${subproject_name}_link_libraries)
             target_link_directories(${subproject_name} PUBLIC ${CMAKE_BINARY_DIR})
             target_link_libraries(${subproject_name} ${project_config_${subproject_name}_link_libraries})
@@ -1,9 +1,15 @@
 if (${project_config_use_unit_tests})
     include("cmake_utils/setup_gtest.cmake")
 endif()
+if (project_config_link_failure_tests)
+    include("cmake_utils/setup_link_failure_tests.cmake")
+endif()
 if (${project_config_use_benchmark})
     include("cmake_utils/setup_benchmark.cmake")
 endif()
 if (${project_config_use_clang_tidy})
     include("cmake_utils/setup_clang_tidy.cmake")
 endif()
+if (${project_config_use_ipo})
+    include("cmake_utils/setup_ipo.cmake")
+endif()
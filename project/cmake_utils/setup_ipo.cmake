@@ -0,0 +1,12 @@
+include(CheckIPOSupported)
+
+# Enables link-time optimization for every target created afterwards, so calls from the executable into the
+# static sub-project libraries can still be inlined. Must run after project() and before targets are added.
+macro (setup_ipo)
+    check_ipo_supported(RESULT ipo_supported OUTPUT ipo_output LANGUAGES CXX)
+    if (ipo_supported)
+        set(CMAKE_INTERPROCEDURAL_OPTIMIZATION ON)
+    else()
+        message(STATUS "IPO/LTO not supported: ${ipo_output}")
+    endif()
+endmacro()
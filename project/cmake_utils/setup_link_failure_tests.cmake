@@ -0,0 +1,13 @@
+# Adds a ctest per name in project_config_link_failure_tests. Each one builds project_config_<name>_source into an
+# executable linked with project_config_<name>_link_libraries and passes only when the build output matches
+# project_config_<name>_expected_output; the executable itself is left out of the default build
+function(setup_link_failure_tests project_name)
+    foreach(check IN ITEMS ${project_config_link_failure_tests})
+        set(target_name ${project_name}.${check})
+        add_executable(${target_name} EXCLUDE_FROM_ALL ${project_config_${check}_source})
+        target_link_libraries(${target_name} ${project_config_${check}_link_libraries})
+        set_target_properties(${target_name} PROPERTIES EXCLUDE_FROM_DEFAULT_BUILD TRUE LINKER_LANGUAGE CXX FOLDER "${internals_project_folder}")
+        add_test(NAME ${target_name} COMMAND ${CMAKE_COMMAND} --build ${CMAKE_BINARY_DIR} --target ${target_name} --config $<CONFIG>)
+        set_tests_properties(${target_name} PROPERTIES PASS_REGULAR_EXPRESSION "${project_config_${check}_expected_output}")
+    endforeach()
+endfunction()
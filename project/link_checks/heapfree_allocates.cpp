@@ -0,0 +1,16 @@
+#include "minefield/heapfree/fixed.h"
+
+#include <vector>
+
+// Built by the heapfree_rejects_allocation test with the link flags of minefield.heapfree: the core itself
+// links, but the vector below reaches operator new, so the link has to fail on a wrapped symbol.
+
+int main(int argc, char *[])
+{
+    static heapfree::EventRing<4> events;
+    const sim::GameConfig config = {4, 4, 3};
+    sim::GameResult result;
+    heapfree::playGame<4, 4, 3>(config, {CpuStrategy::Cautious, 1, false}, {CpuStrategy::Random, 2, false}, result, events);
+    std::vector<unsigned int> rounds(static_cast<unsigned int>(argc), result.rounds);
+    return static_cast<int>(rounds.back());
+}
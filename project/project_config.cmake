@@ -6,7 +6,8 @@ set(project_config_cpp_std 20)
 set(project_config_use_clang_tidy true)
 set(project_config_use_unit_tests true)
 set(project_config_use_benchmark true)
-set(project_config_recursive_file_gathering true) # When set to false, it'll create sub-projects for nested folders in include/${project_config_name} folders
+set(project_config_use_ipo true) # Link-time optimization across the sub-project libraries and the executable
+set(project_config_recursive_file_gathering false) # When set to false, it'll create sub-projects for nested folders in include/${project_config_name} folders
 
 include(FetchContent)
 FetchContent_Declare(
@@ -34,6 +35,35 @@ endforeach()
 # set(project_config_<subproject>_type SHARED) # Change a specific subproject to STATIC[default], SHARED, EXE
 # set(project_config_<subproject>_link_libraries "example") # Set libraries to be linked for a specific subproject
 # set(project_config_<subproject>_dependencies "example") # Set other targets as dependencies for a specific subproject
+if (UNIX)
+    set(project_config_minefield.engine_link_libraries pthread) # worker threads of the simulation engine
+endif()
+
+# C API of the engine as a shared library; only the mf_* entry points are exported
+set(project_config_capi_type SHARED)
+set(project_config_minefield.capi_link_libraries minefield.engine)
+set(project_config_minefield.capi_version 1.0.0)
+set(project_config_minefield.capi_soversion 1) # MF_API_VERSION_MAJOR in minefield_c.h
+set(CMAKE_POSITION_INDEPENDENT_CODE ON) # the static engine is linked into the shared library
+set(CMAKE_CXX_VISIBILITY_PRESET hidden)
+set(CMAKE_VISIBILITY_INLINES_HIDDEN ON)
+
+# Heap-free game core (include/minefield/heapfree) as its own executable. With the check on, every allocation
+# function is wrapped to a symbol nobody defines, so anything in it that could reach the heap fails the link
+set(project_config_heapfree_type EXE)
+option(MINEFIELD_HEAP_FREE_CHECK "Fail the link of minefield.heapfree on any call that allocates" ON)
+if (MINEFIELD_HEAP_FREE_CHECK AND CMAKE_HOST_SYSTEM_NAME STREQUAL "Linux") # GNU ld, gold and lld all take --wrap
+    set(heap_functions malloc calloc realloc free aligned_alloc posix_memalign memalign strdup __cxa_allocate_exception
+        _Znwm _Znam _ZnwmRKSt9nothrow_t _ZnamRKSt9nothrow_t _ZnwmSt11align_val_t _ZnamSt11align_val_t # operator new, 64-bit
+        _Znwj _Znaj _ZnwjRKSt9nothrow_t _ZnajRKSt9nothrow_t _ZnwjSt11align_val_t _ZnajSt11align_val_t) # operator new, 32-bit
+    list(TRANSFORM heap_functions PREPEND "-Wl,--wrap=" OUTPUT_VARIABLE project_config_minefield.heapfree_link_libraries)
+
+    # ctest checks the check: a translation unit that allocates, linked with the same flags, must fail on a wrapped symbol
+    list(APPEND project_config_link_failure_tests heapfree_rejects_allocation)
+    set(project_config_heapfree_rejects_allocation_source "../project/link_checks/heapfree_allocates.cpp")
+    set(project_config_heapfree_rejects_allocation_link_libraries ${project_config_minefield.heapfree_link_libraries})
+    set(project_config_heapfree_rejects_allocation_expected_output "undefined (reference to|symbol:) `?__wrap_")
+endif()
 
 set(link_libraries jngl)
 
@@ -41,6 +71,8 @@ set(link_libraries jngl)
 
 # set(project_config_unit_tests_extra_sources "../src/*.cpp") # Extra sources that need to be compiled as part of a tests project
 # set(project_config_unit_tests_extra_libraries "dbghelp") # Extra libraries that need to be linked as part of a tests project
+set(project_config_unit_tests_extra_libraries minefield.capi) # capi.tests goes through the shared library
 
 # set(project_config_benchmark_extra_sources "../src/*.cpp") # Extra sources that need to be compiled as part of a benchmark project
 # set(project_config_benchmark_extra_libraries "dbghelp") # Extra libraries that need to be linked as part of a benchmark project
+set(project_config_benchmark_extra_libraries minefield.capi)
@@ -0,0 +1,212 @@
+#include "minefield/capi/minefield_c.h"
+
+#include "minefield/engine/board.h"
+#include "minefield/engine/session.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <vector>
+
+static_assert(sizeof(CellStatusFlags) == sizeof(std::uint32_t), "board cells are exposed as uint32_t words");
+static_assert(sizeof(Position) == sizeof(mf_position), "mf_position mirrors Position");
+static_assert(static_cast<std::uint32_t>(CellStatusFlags::Disabled) == MF_CELL_DISABLED, "cell bits are part of the ABI");
+static_assert(static_cast<std::uint32_t>(CellStatusFlags::HasMine) == MF_CELL_HAS_MINE, "cell bits are part of the ABI");
+static_assert(static_cast<std::uint32_t>(CellStatusFlags::WasGuessed) == MF_CELL_WAS_GUESSED, "cell bits are part of the ABI");
+static_assert(static_cast<std::uint32_t>(CellStatusFlags::SelfDetonated) == MF_CELL_SELF_DETONATED, "cell bits are part of the ABI");
+static_assert(static_cast<std::uint32_t>(CellStatusFlags::HadCollision) == MF_CELL_HAD_COLLISION, "cell bits are part of the ABI");
+
+namespace
+{
+    // Sizes of the structs as version 1 shipped them, the smallest any caller may pass. Fields appended later
+    // do not move these: a call reads and writes min(struct_size, the size it was built with) bytes, so
+    // older callers leave the new fields zero and newer callers keep theirs untouched.
+    constexpr std::uint32_t kConfigV1Size = offsetof(mf_batch_config, games) + sizeof(mf_batch_config::games);
+    constexpr std::uint32_t kInputV1Size = offsetof(mf_round_input, guess_count) + sizeof(mf_round_input::guess_count);
+    constexpr std::uint32_t kResultV1Size = offsetof(mf_round_result, collisions) + sizeof(mf_round_result::collisions);
+    constexpr std::uint32_t kViewV1Size = offsetof(mf_board_view, height) + sizeof(mf_board_view::height);
+
+    // the caller's struct of struct_size bytes as this library sees it
+    template <typename StructT>
+    StructT readStruct(const void *source, std::uint32_t size)
+    {
+        StructT copy = {};
+        std::memcpy(&copy, source, std::min<std::size_t>(size, sizeof(StructT)));
+        return copy;
+    }
+
+    template <typename StructT>
+    void writeStruct(void *target, std::uint32_t size, const StructT &value)
+    {
+        std::memcpy(target, &value, std::min<std::size_t>(size, sizeof(StructT)));
+    }
+
+    mf_outcome outcomeOf(const session::Game &game)
+    {
+        if (!game.finished)
+        {
+            return MF_ONGOING;
+        }
+        switch (game.outcome)
+        {
+        case sim::Outcome::FirstSeatWins:
+            return MF_FIRST_SEAT_WINS;
+        case sim::Outcome::SecondSeatWins:
+            return MF_SECOND_SEAT_WINS;
+        case sim::Outcome::Draw:
+        default:
+            return MF_DRAW;
+        }
+    }
+
+    session::RoundInput toRoundInput(const mf_round_input &input)
+    {
+        session::RoundInput round;
+        for (int seat = 0; seat < 2; ++seat)
+        {
+            round.mines[seat] = reinterpret_cast<const Position *>(input.mines[seat]);
+            round.guesses[seat] = reinterpret_cast<const Position *>(input.guesses[seat]);
+            round.mineCount[seat] = input.mine_count[seat];
+            round.guessCount[seat] = input.guess_count[seat];
+        }
+        return round;
+    }
+}
+
+struct mf_batch
+{
+    std::vector<session::Game> games;
+    session::CellMarks marks;
+};
+
+uint32_t mf_api_version(void)
+{
+    return MF_API_VERSION;
+}
+
+mf_status mf_batch_create(const mf_batch_config *config, mf_batch **batch)
+{
+    if (!config || !batch || config->struct_size < kConfigV1Size)
+    {
+        return MF_INVALID_ARGUMENT;
+    }
+    const mf_batch_config settings = readStruct<mf_batch_config>(config, config->struct_size);
+    const bool validSize = settings.width >= static_cast<std::uint32_t>(Board::kMinSize) && settings.width <= static_cast<std::uint32_t>(Board::kMaxSimulationSize) && settings.height >= static_cast<std::uint32_t>(Board::kMinSize) && settings.height <= static_cast<std::uint32_t>(Board::kMaxSimulationSize);
+    if (!validSize || settings.mines < static_cast<std::uint32_t>(Board::kMinMines) || settings.games == 0)
+    {
+        return MF_INVALID_ARGUMENT;
+    }
+
+    try
+    {
+        const sim::GameConfig gameConfig = {settings.width, settings.height, settings.mines};
+        auto created = std::make_unique<mf_batch>();
+        created->games.reserve(settings.games);
+        for (std::uint32_t g = 0; g < settings.games; ++g)
+        {
+            created->games.emplace_back(gameConfig);
+        }
+        *batch = created.release();
+        return MF_OK;
+    }
+    catch (const std::bad_alloc &)
+    {
+        return MF_OUT_OF_MEMORY;
+    }
+}
+
+void mf_batch_destroy(mf_batch *batch)
+{
+    delete batch;
+}
+
+mf_status mf_batch_expected_counts(const mf_batch *batch, uint32_t game, uint32_t mine_count[2], uint32_t max_guess_count[2])
+{
+    if (!batch || !mine_count || !max_guess_count || game >= batch->games.size())
+    {
+        return MF_INVALID_ARGUMENT;
+    }
+    session::expectedCounts(batch->games[game], mine_count, max_guess_count);
+    return MF_OK;
+}
+
+mf_status mf_batch_step(mf_batch *batch, uint32_t first, uint32_t count, const mf_round_input *inputs, mf_round_result *results)
+{
+    if (!batch || !inputs || !results || first > batch->games.size() || count > batch->games.size() - first)
+    {
+        return MF_INVALID_ARGUMENT;
+    }
+    if (count == 0)
+    {
+        return MF_OK;
+    }
+    const std::uint32_t inputStride = inputs->struct_size;
+    const std::uint32_t resultStride = results->struct_size;
+    if (inputStride < kInputV1Size || resultStride < kResultV1Size)
+    {
+        return MF_INVALID_ARGUMENT;
+    }
+
+    mf_status firstFailure = MF_OK;
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        session::Game &game = batch->games[first + i];
+        const mf_round_input input = readStruct<mf_round_input>(reinterpret_cast<const char *>(inputs) + std::size_t{i} * inputStride, inputStride);
+        mf_round_result result = {};
+        result.struct_size = resultStride;
+
+        mf_status status = MF_OK;
+        try
+        {
+            session::RoundResult round;
+            switch (session::playRound(game, toRoundInput(input), batch->marks, round))
+            {
+            case session::RoundStatus::Ok:
+                result.hits[0] = round.hits[0];
+                result.hits[1] = round.hits[1];
+                result.collisions = round.collisions;
+                break;
+            case session::RoundStatus::InvalidMove:
+                status = MF_INVALID_MOVE;
+                break;
+            case session::RoundStatus::GameOver:
+            default:
+                status = MF_GAME_OVER;
+                break;
+            }
+        }
+        catch (const std::bad_alloc &)
+        {
+            status = MF_OUT_OF_MEMORY;
+        }
+
+        result.status = status;
+        result.outcome = outcomeOf(game);
+        result.remaining_mines[0] = game.seats[0].remainingMines;
+        result.remaining_mines[1] = game.seats[1].remainingMines;
+        writeStruct(reinterpret_cast<char *>(results) + std::size_t{i} * resultStride, resultStride, result);
+        if (status != MF_OK && firstFailure == MF_OK)
+        {
+            firstFailure = status;
+        }
+    }
+    return firstFailure;
+}
+
+mf_status mf_batch_board(const mf_batch *batch, uint32_t game, mf_board_view *view)
+{
+    if (!batch || !view || view->struct_size < kViewV1Size || game >= batch->games.size())
+    {
+        return MF_INVALID_ARGUMENT;
+    }
+    const Board &board = batch->games[game].board;
+    mf_board_view filled = {};
+    filled.struct_size = view->struct_size;
+    filled.cells = reinterpret_cast<const std::uint32_t *>(board.cells());
+    filled.width = board.getWidth();
+    filled.height = board.getHeight();
+    writeStruct(view, view->struct_size, filled);
+    return MF_OK;
+}
@@ -0,0 +1,425 @@
+#include "minefield/engine/analysis.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+
+namespace analysis
+{
+    constexpr std::uint32_t kCheckpointMagic = 0x4B52464D; // "MFRK"
+    constexpr std::uint32_t kCheckpointVersion = 1;
+
+    BlockQueues::BlockQueues(std::uint64_t first, std::uint64_t last, unsigned int workers)
+        : runs(workers)
+    {
+        const std::uint64_t count = last - first;
+        for (unsigned int w = 0; w < workers; ++w)
+        {
+            runs[w].next = first + count * w / workers;
+            runs[w].end = first + count * (w + 1) / workers;
+        }
+    }
+
+    bool BlockQueues::take(unsigned int worker, std::uint64_t &block)
+    {
+        block = runs[worker].next.fetch_add(1);
+        if (block < runs[worker].end)
+        {
+            return true;
+        }
+        for (;;)
+        {
+            Run *victim = nullptr;
+            std::uint64_t most = 0;
+            for (auto &run : runs)
+            {
+                const std::uint64_t next = run.next.load(std::memory_order_relaxed);
+                if (next < run.end && run.end - next > most)
+                {
+                    most = run.end - next;
+                    victim = &run;
+                }
+            }
+            if (!victim)
+            {
+                return false;
+            }
+            block = victim->next.fetch_add(1);
+            if (block < victim->end)
+            {
+                steals.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+
+    std::uint64_t BlockQueues::getSteals() const
+    {
+        return steals.load();
+    }
+
+    bool readCheckpoint(const std::string &path, const archive::Reader &reader, std::uint64_t &blocksDone, std::string &state)
+    {
+        std::ifstream file(path, std::ios::binary);
+        const std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        const char *cursor = contents.data();
+        const char *end = contents.data() + contents.size();
+        std::uint32_t magic = 0;
+        std::uint32_t version = 0;
+        std::uint64_t blocks = 0;
+        std::uint64_t replays = 0;
+        std::uint64_t size = 0;
+        if (!archive::getFixed(cursor, end, magic) || !archive::getFixed(cursor, end, version) || !archive::getFixed(cursor, end, blocks)
+            || !archive::getFixed(cursor, end, replays) || !archive::getFixed(cursor, end, blocksDone) || !archive::getFixed(cursor, end, size)
+            || magic != kCheckpointMagic || version != kCheckpointVersion || blocks != reader.blockCount() || replays != reader.replayCount()
+            || blocksDone > blocks || size != static_cast<std::uint64_t>(end - cursor))
+        {
+            blocksDone = 0;
+            return false;
+        }
+        state.assign(cursor, end);
+        return true;
+    }
+
+    // written aside and renamed over the old one, so a crash leaves either checkpoint whole
+    bool writeCheckpoint(const std::string &path, const archive::Reader &reader, std::uint64_t blocksDone, const std::string &state)
+    {
+        std::string contents;
+        archive::putFixed(contents, kCheckpointMagic);
+        archive::putFixed(contents, kCheckpointVersion);
+        archive::putFixed(contents, static_cast<std::uint64_t>(reader.blockCount()));
+        archive::putFixed(contents, reader.replayCount());
+        archive::putFixed(contents, blocksDone);
+        archive::putFixed(contents, static_cast<std::uint64_t>(state.size()));
+        contents += state;
+
+        const std::string temporary = path + ".tmp";
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        file.close();
+        return !file.fail() && std::rename(temporary.c_str(), path.c_str()) == 0;
+    }
+
+    void saveCounts(std::string &out, const std::vector<std::uint64_t> &counts)
+    {
+        archive::putVarint(out, counts.size());
+        for (const std::uint64_t count : counts)
+        {
+            archive::putVarint(out, count);
+        }
+    }
+
+    bool loadCounts(const char *&cursor, const char *end, std::vector<std::uint64_t> &counts)
+    {
+        std::uint64_t size = 0;
+        if (!archive::getVarint(cursor, end, size) || size > static_cast<std::uint64_t>(end - cursor))
+        {
+            return false;
+        }
+        counts.resize(size);
+        for (auto &count : counts)
+        {
+            if (!archive::getVarint(cursor, end, count))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void addCounts(std::vector<std::uint64_t> &into, const std::vector<std::uint64_t> &from)
+    {
+        if (into.size() < from.size())
+        {
+            into.resize(from.size());
+        }
+        for (std::size_t i = 0; i < from.size(); ++i)
+        {
+            into[i] += from[i];
+        }
+    }
+
+    // sorted cell indices of a list, into a buffer reused by the thread
+    void cellsOf(const archive::PositionList &list, unsigned int height, std::vector<std::uint64_t> &cells)
+    {
+        cells.clear();
+        for (const Position &position : list)
+        {
+            cells.push_back(static_cast<std::uint64_t>(position.column) * height + position.row);
+        }
+        std::sort(cells.begin(), cells.end());
+    }
+
+    bool contains(const std::vector<std::uint64_t> &cells, const Position &position, unsigned int height)
+    {
+        return std::binary_search(cells.begin(), cells.end(), static_cast<std::uint64_t>(position.column) * height + position.row);
+    }
+
+    Analysis<HitsByRound> hitsByRound()
+    {
+        Analysis<HitsByRound> analysis;
+        analysis.map = [](HitsByRound &state, const archive::ReplayView &game)
+            {
+                thread_local std::vector<std::uint64_t> mines[2];
+                const unsigned int height = game.config.height;
+                for (std::size_t r = 0; r < game.rounds.size(); ++r)
+                {
+                    const archive::RoundView &round = game.rounds[r];
+                    cellsOf(round.mines1, height, mines[0]);
+                    cellsOf(round.mines2, height, mines[1]);
+                    for (int seat = 0; seat < 2; ++seat)
+                    {
+                        const std::vector<std::uint64_t> &own = mines[seat];
+                        const std::vector<std::uint64_t> &opponent = mines[1 - seat];
+                        if (state.guesses[seat].size() <= r)
+                        {
+                            state.guesses[seat].resize(r + 1);
+                            state.hits[seat].resize(r + 1);
+                        }
+                        for (const Position &guess : seat ? round.guesses2 : round.guesses1)
+                        {
+                            state.guesses[seat][r]++;
+                            // a mine of the opponent on a cell both seats mined was removed by the collision
+                            state.hits[seat][r] += (contains(opponent, guess, height) && !contains(own, guess, height)) ? 1 : 0;
+                        }
+                    }
+                }
+            };
+        analysis.reduce = [](HitsByRound &into, const HitsByRound &from)
+            {
+                for (int seat = 0; seat < 2; ++seat)
+                {
+                    addCounts(into.guesses[seat], from.guesses[seat]);
+                    addCounts(into.hits[seat], from.hits[seat]);
+                }
+            };
+        analysis.save = [](const HitsByRound &state, std::string &out)
+            {
+                for (int seat = 0; seat < 2; ++seat)
+                {
+                    saveCounts(out, state.guesses[seat]);
+                    saveCounts(out, state.hits[seat]);
+                }
+            };
+        analysis.load = [](HitsByRound &state, const char *&cursor, const char *end)
+            {
+                for (int seat = 0; seat < 2; ++seat)
+                {
+                    if (!loadCounts(cursor, end, state.guesses[seat]) || !loadCounts(cursor, end, state.hits[seat]))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            };
+        return analysis;
+    }
+
+    std::ostream &operator<<(std::ostream &stream, const HitsByRound &state)
+    {
+        stream << "\n === HITS BY ROUND === \nround  guesses 1  hit rate 1  guesses 2  hit rate 2\n";
+        const std::size_t rounds = std::max(state.guesses[0].size(), state.guesses[1].size());
+        for (std::size_t r = 0; r < rounds; ++r)
+        {
+            stream << std::setw(5) << r + 1;
+            for (int seat = 0; seat < 2; ++seat)
+            {
+                const std::uint64_t guesses = (r < state.guesses[seat].size()) ? state.guesses[seat][r] : 0;
+                const std::uint64_t hits = (r < state.hits[seat].size()) ? state.hits[seat][r] : 0;
+                stream << std::setw(11) << guesses << std::setw(11) << std::fixed << std::setprecision(2)
+                       << (guesses ? 100.0 * hits / guesses : 0.0) << '%' << std::defaultfloat;
+            }
+            stream << '\n';
+        }
+        return stream;
+    }
+
+    Analysis<Heatmap> heatmap()
+    {
+        Analysis<Heatmap> analysis;
+        analysis.map = [](Heatmap &state, const archive::ReplayView &game)
+            {
+                const unsigned int height = game.config.height;
+                for (int seat = 0; seat < 2; ++seat)
+                {
+                    std::vector<std::uint64_t> &cells = state.cells[seat][{game.config.width, height}];
+                    cells.resize(static_cast<std::size_t>(game.config.width) * height);
+                    for (const archive::RoundView &round : game.rounds)
+                    {
+                        for (const Position &mine : seat ? round.mines2 : round.mines1)
+                        {
+                            cells[static_cast<std::size_t>(mine.column) * height + mine.row]++;
+                        }
+                    }
+                }
+            };
+        analysis.reduce = [](Heatmap &into, const Heatmap &from)
+            {
+                for (int seat = 0; seat < 2; ++seat)
+                {
+                    for (const auto &[size, cells] : from.cells[seat])
+                    {
+                        addCounts(into.cells[seat][size], cells);
+                    }
+                }
+            };
+        analysis.save = [](const Heatmap &state, std::string &out)
+            {
+                for (int seat = 0; seat < 2; ++seat)
+                {
+                    archive::putVarint(out, state.cells[seat].size());
+                    for (const auto &[size, cells] : state.cells[seat])
+                    {
+                        archive::putVarint(out, size.first);
+                        archive::putVarint(out, size.second);
+                        saveCounts(out, cells);
+                    }
+                }
+            };
+        analysis.load = [](Heatmap &state, const char *&cursor, const char *end)
+            {
+                for (int seat = 0; seat < 2; ++seat)
+                {
+                    std::uint64_t sizes = 0;
+                    if (!archive::getVarint(cursor, end, sizes))
+                    {
+                        return false;
+                    }
+                    for (std::uint64_t i = 0; i < sizes; ++i)
+                    {
+                        unsigned int width = 0;
+                        unsigned int height = 0;
+                        if (!archive::getVarint(cursor, end, Board::kMaxSimulationSize, width) || !archive::getVarint(cursor, end, Board::kMaxSimulationSize, height)
+                            || !loadCounts(cursor, end, state.cells[seat][{width, height}]))
+                        {
+                            return false;
+                        }
+                    }
+                }
+                return true;
+            };
+        return analysis;
+    }
+
+    // boards up to this side are drawn, larger ones only counted
+    constexpr unsigned int kMaxDrawnSide = 16;
+
+    std::ostream &operator<<(std::ostream &stream, const Heatmap &state)
+    {
+        stream << "\n === MINE HEATMAP === \n";
+        for (int seat = 0; seat < 2; ++seat)
+        {
+            for (const auto &[size, cells] : state.cells[seat])
+            {
+                std::uint64_t total = 0;
+                for (const std::uint64_t count : cells)
+                {
+                    total += count;
+                }
+                stream << "seat " << seat + 1 << ", " << size.first << 'x' << size.second << ": " << total << " mines, per mille by cell\n";
+                if (size.first > kMaxDrawnSide || size.second > kMaxDrawnSide || total == 0)
+                {
+                    continue;
+                }
+                for (unsigned int r = 0; r < size.second; ++r)
+                {
+                    for (unsigned int c = 0; c < size.first; ++c)
+                    {
+                        stream << std::setw(5) << (1000 * cells[static_cast<std::size_t>(c) * size.second + r] + total / 2) / total;
+                    }
+                    stream << '\n';
+                }
+            }
+        }
+        return stream;
+    }
+
+    Analysis<Fingerprint> fingerprint()
+    {
+        Analysis<Fingerprint> analysis;
+        analysis.map = [](Fingerprint &state, const archive::ReplayView &game)
+            {
+                thread_local std::vector<std::uint64_t> own;
+                const unsigned int width = game.config.width;
+                const unsigned int height = game.config.height;
+                for (int seat = 0; seat < 2; ++seat)
+                {
+                    Fingerprint::Habits &habits = state.strategies[static_cast<std::size_t>(seat ? game.second.strategy : game.first.strategy) & 1];
+                    habits.games++;
+                    habits.wins += (game.result.outcome == (seat ? sim::Outcome::SecondSeatWins : sim::Outcome::FirstSeatWins)) ? 1 : 0;
+                    for (const archive::RoundView &round : game.rounds)
+                    {
+                        const archive::PositionList &mines = seat ? round.mines2 : round.mines1;
+                        cellsOf(mines, height, own);
+                        for (const Position &mine : mines)
+                        {
+                            habits.mines++;
+                            habits.edgeMines += (mine.column == 0 || mine.row == 0 || mine.column + 1 == width || mine.row + 1 == height) ? 1 : 0;
+                        }
+                        for (const Position &guess : seat ? round.guesses2 : round.guesses1)
+                        {
+                            habits.guesses++;
+                            habits.ownMineGuesses += contains(own, guess, height) ? 1 : 0;
+                        }
+                    }
+                }
+            };
+        analysis.reduce = [](Fingerprint &into, const Fingerprint &from)
+            {
+                for (std::size_t s = 0; s < 2; ++s)
+                {
+                    Fingerprint::Habits &a = into.strategies[s];
+                    const Fingerprint::Habits &b = from.strategies[s];
+                    a.games += b.games;
+                    a.guesses += b.guesses;
+                    a.ownMineGuesses += b.ownMineGuesses;
+                    a.mines += b.mines;
+                    a.edgeMines += b.edgeMines;
+                    a.wins += b.wins;
+                }
+            };
+        analysis.save = [](const Fingerprint &state, std::string &out)
+            {
+                for (const auto &habits : state.strategies)
+                {
+                    for (const std::uint64_t value : {habits.games, habits.guesses, habits.ownMineGuesses, habits.mines, habits.edgeMines, habits.wins})
+                    {
+                        archive::putVarint(out, value);
+                    }
+                }
+            };
+        analysis.load = [](Fingerprint &state, const char *&cursor, const char *end)
+            {
+                for (auto &habits : state.strategies)
+                {
+                    for (std::uint64_t *value : {&habits.games, &habits.guesses, &habits.ownMineGuesses, &habits.mines, &habits.edgeMines, &habits.wins})
+                    {
+                        if (!archive::getVarint(cursor, end, *value))
+                        {
+                            return false;
+                        }
+                    }
+                }
+                return true;
+            };
+        return analysis;
+    }
+
+    std::ostream &operator<<(std::ostream &stream, const Fingerprint &state)
+    {
+        stream << "\n === STRATEGY FINGERPRINTS === \n";
+        for (std::size_t s = 0; s < 2; ++s)
+        {
+            const Fingerprint::Habits &habits = state.strategies[s];
+            if (habits.games == 0)
+            {
+                continue;
+            }
+            stream << cpu::strategyName(static_cast<CpuStrategy>(s)) << ": " << habits.games << " seats, won " << 100.0 * habits.wins / habits.games
+                   << "%, guesses on own mines " << (habits.guesses ? 100.0 * habits.ownMineGuesses / habits.guesses : 0.0)
+                   << "%, mines on the border " << (habits.mines ? 100.0 * habits.edgeMines / habits.mines : 0.0) << "%\n";
+        }
+        return stream;
+    }
+}
@@ -0,0 +1,156 @@
+#include "minefield/engine/analytic.h"
+
+#include "minefield/engine/board.h"
+
+#include <algorithm>
+
+namespace analytic
+{
+    double choose(unsigned int n, unsigned int k)
+    {
+        if (k > n)
+        {
+            return 0.0;
+        }
+        double result = 1.0;
+        for (unsigned int i = 0; i < k; ++i)
+        {
+            result = result * (n - i) / (i + 1);
+        }
+        return result;
+    }
+
+    RandomGameSolver::RandomGameSolver(unsigned int cells, unsigned int mines)
+        : cells(cells)
+        , mines(mines)
+    {
+        const std::size_t states = static_cast<std::size_t>(cells + 1) * (mines + 1) * (mines + 1);
+        memo.resize(states);
+        known.assign(states, false);
+    }
+
+    std::size_t RandomGameSolver::index(unsigned int freeCells, unsigned int mines1, unsigned int mines2) const
+    {
+        return (static_cast<std::size_t>(freeCells) * (mines + 1) + mines1) * (mines + 1) + mines2;
+    }
+
+    // same end conditions as sim::playGame: a seat without mines or a board without free cells ends the game
+    void RandomGameSolver::addTransition(OutcomeDistribution &into, double probability, unsigned int freeCells, unsigned int mines1, unsigned int mines2)
+    {
+        into.expectedRounds += probability;
+        if (mines1 == 0 || mines2 == 0 || freeCells == 0)
+        {
+            if (mines1 == mines2)
+            {
+                into.draws += probability;
+            }
+            else if (mines1 > mines2)
+            {
+                into.firstSeatWins += probability;
+            }
+            else
+            {
+                into.secondSeatWins += probability;
+            }
+            return;
+        }
+        const OutcomeDistribution next = solve(freeCells, mines1, mines2);
+        into.firstSeatWins += probability * next.firstSeatWins;
+        into.draws += probability * next.draws;
+        into.secondSeatWins += probability * next.secondSeatWins;
+        into.expectedRounds += probability * next.expectedRounds;
+    }
+
+    // One round: placements collide (hypergeometric), then each seat guesses among the remaining free cells.
+    // Seat 1's guesses split over seat 1's mines (self-detonations), seat 2's mines (hits) and empty cells;
+    // seat 2's guesses are then split again by whether they land on a cell seat 1 already guessed.
+    // Every round disables at least one cell, so the recursion always moves to fewer free cells.
+    OutcomeDistribution RandomGameSolver::solve(unsigned int freeCells, unsigned int mines1, unsigned int mines2)
+    {
+        const std::size_t slot = index(freeCells, mines1, mines2);
+        if (known[slot])
+        {
+            return memo[slot];
+        }
+
+        OutcomeDistribution result;
+        const unsigned int placed1 = std::min(mines1, freeCells);
+        const unsigned int placed2 = std::min(mines2, freeCells);
+        const double placements = choose(freeCells, placed2);
+
+        for (unsigned int k = 0; k <= std::min(placed1, placed2); ++k)
+        {
+            const double pCollisions = choose(placed1, k) * choose(freeCells - placed1, placed2 - k) / placements;
+            if (pCollisions <= 0.0)
+            {
+                continue;
+            }
+            const unsigned int left1 = mines1 - k;
+            const unsigned int left2 = mines2 - k;
+            const unsigned int free = freeCells - k;
+            const unsigned int own1 = placed1 - k;
+            const unsigned int own2 = placed2 - k;
+            const unsigned int empty = free - own1 - own2;
+            const unsigned int guesses1 = std::min(left2, free);
+            const unsigned int guesses2 = std::min(left1, free);
+            const double guessSets = choose(free, guesses1) * choose(free, guesses2);
+
+            // seat 1 guesses x1 own mines, y1 opponent mines and z1 empty cells
+            for (unsigned int x1 = 0; x1 <= std::min(guesses1, own1); ++x1)
+            {
+                for (unsigned int y1 = 0; y1 <= std::min(guesses1 - x1, own2); ++y1)
+                {
+                    const unsigned int z1 = guesses1 - x1 - y1;
+                    if (z1 > empty)
+                    {
+                        continue;
+                    }
+                    const double ways1 = choose(own1, x1) * choose(own2, y1) * choose(empty, z1);
+
+                    // seat 2 guesses: a = on seat 1's mines, b = on its own mines, c = empty; "In" = already guessed by seat 1
+                    for (unsigned int aIn = 0; aIn <= std::min(guesses2, x1); ++aIn)
+                    {
+                        for (unsigned int aOut = 0; aOut <= std::min(guesses2 - aIn, own1 - x1); ++aOut)
+                        {
+                            for (unsigned int bIn = 0; bIn <= std::min(guesses2 - aIn - aOut, y1); ++bIn)
+                            {
+                                for (unsigned int bOut = 0; bOut <= std::min(guesses2 - aIn - aOut - bIn, own2 - y1); ++bOut)
+                                {
+                                    const unsigned int rest = guesses2 - aIn - aOut - bIn - bOut;
+                                    const double waysAB = choose(x1, aIn) * choose(own1 - x1, aOut) * choose(y1, bIn) * choose(own2 - y1, bOut);
+                                    for (unsigned int cIn = 0; cIn <= std::min(rest, z1); ++cIn)
+                                    {
+                                        const unsigned int cOut = rest - cIn;
+                                        if (cOut > empty - z1)
+                                        {
+                                            continue;
+                                        }
+                                        const double ways2 = waysAB * choose(z1, cIn) * choose(empty - z1, cOut);
+                                        const double probability = pCollisions * ways1 * ways2 / guessSets;
+
+                                        const unsigned int loss1 = x1 + aIn + aOut;
+                                        const unsigned int loss2 = y1 + bIn + bOut;
+                                        const unsigned int disabled = guesses1 + aOut + bOut + cOut;
+                                        addTransition(result, probability, free - disabled, (left1 > loss1) ? left1 - loss1 : 0, (left2 > loss2) ? left2 - loss2 : 0);
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        known[slot] = true;
+        memo[slot] = result;
+        return result;
+    }
+
+    OutcomeDistribution randomGameOutcome(const sim::GameConfig &config)
+    {
+        const Board board = sim::makeBoard(config);
+        const unsigned int cells = board.getWidth() * board.getHeight();
+        RandomGameSolver solver(cells, config.mines);
+        return solver.solve(cells, config.mines, config.mines);
+    }
+}
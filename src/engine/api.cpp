@@ -0,0 +1,753 @@
+#include "minefield/engine/api.h"
+
+#include "minefield/engine/net.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <new>
+
+#ifndef _WIN32
+#include <csignal>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace api
+{
+    // bound on one game's state or round result in a reply, every number at its widest
+    constexpr std::size_t kMaxGameReply = 256;
+    constexpr std::size_t kMaxReplyFrame = 64; // the ok flag and brackets around a batch
+
+    const char *outcomeName(const session::Game &game)
+    {
+        if (!game.finished)
+        {
+            return "ongoing";
+        }
+        switch (game.outcome)
+        {
+        case sim::Outcome::FirstSeatWins:
+            return "first";
+        case sim::Outcome::SecondSeatWins:
+            return "second";
+        case sim::Outcome::Draw:
+        default:
+            return "draw";
+        }
+    }
+
+    bool readCount(const json::Document &request, std::uint32_t index, std::uint64_t min, std::uint64_t max, unsigned int &value)
+    {
+        std::uint64_t number = 0;
+        if (index == 0 || !request.number(index, number) || number < min || number > max)
+        {
+            return false;
+        }
+        value = static_cast<unsigned int>(number);
+        return true;
+    }
+
+    // an array holding one array per seat
+    bool isSeatLists(const json::Document &request, std::uint32_t index)
+    {
+        if (index == 0 || request.token(index).type != json::TokenType::Array || request.token(index).children != 2)
+        {
+            return false;
+        }
+        const std::uint32_t first = request.firstChild(index);
+        return request.token(first).type == json::TokenType::Array && request.token(request.nextSibling(first)).type == json::TokenType::Array;
+    }
+
+    void writeError(json::Writer &reply, const char *message)
+    {
+        reply.beginObject().key("ok").value(false).key("error").value(message).endObject();
+    }
+
+    std::uint64_t cellCount(const session::Game &game)
+    {
+        return std::uint64_t{game.board.getWidth()} * game.board.getHeight();
+    }
+
+    Handler::Handler(std::uint64_t maxLiveCells)
+        : maxLiveCells(maxLiveCells)
+        , tokens(kMaxTokens)
+    {
+    }
+
+    bool Handler::readPositions(const json::Document &request, std::uint32_t lists, std::size_t offset, std::uint32_t counts[2])
+    {
+        std::uint32_t list = request.firstChild(lists);
+        for (int seat = 0; seat < 2; ++seat, list = request.nextSibling(list))
+        {
+            counts[seat] = request.token(list).children;
+            std::uint32_t pair = request.firstChild(list);
+            for (std::uint32_t i = 0; i < counts[seat]; ++i, pair = request.nextSibling(pair))
+            {
+                const json::Token &token = request.token(pair);
+                if (token.type != json::TokenType::Array || token.children != 2)
+                {
+                    return false;
+                }
+                const std::uint32_t column = request.firstChild(pair);
+                Position &position = positions[offset++];
+                if (!readCount(request, column, 0, std::numeric_limits<unsigned int>::max(), position.column)
+                    || !readCount(request, request.nextSibling(column), 0, std::numeric_limits<unsigned int>::max(), position.row))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    void Handler::writeState(json::Writer &reply, std::uint64_t id, const session::Game &game) const
+    {
+        std::uint32_t mines[2];
+        std::uint32_t guesses[2];
+        session::expectedCounts(game, mines, guesses);
+        writeState(reply, id, game, mines, guesses);
+    }
+
+    // with the counts expected next round taken beforehand, so writing allocates nothing
+    void Handler::writeState(json::Writer &reply, std::uint64_t id, const session::Game &game, const std::uint32_t mines[2], const std::uint32_t guesses[2]) const
+    {
+        reply.key("game").value(id);
+        reply.key("outcome").value(outcomeName(game));
+        reply.key("remaining").beginArray().value(game.seats[0].remainingMines).value(game.seats[1].remainingMines).endArray();
+        if (!game.finished)
+        {
+            reply.key("next").beginObject();
+            reply.key("mines").beginArray().value(mines[0]).value(mines[1]).endArray();
+            reply.key("guesses").beginArray().value(guesses[0]).value(guesses[1]).endArray();
+            reply.endObject();
+        }
+    }
+
+    void Handler::playRound(const json::Document &request, std::uint32_t object, std::uint64_t id, session::Game &game, json::Writer &reply)
+    {
+        const std::uint32_t mines = request.find(object, "mines");
+        const std::uint32_t guesses = request.find(object, "guesses");
+        if (!isSeatLists(request, mines) || !isSeatLists(request, guesses))
+        {
+            writeError(reply, "round needs mines and guesses per seat");
+            return;
+        }
+        std::size_t total = 0;
+        for (const std::uint32_t lists : {mines, guesses})
+        {
+            const std::uint32_t first = request.firstChild(lists);
+            total += request.token(first).children + request.token(request.nextSibling(first)).children;
+        }
+        if (positions.size() < total)
+        {
+            try
+            {
+                positions.resize(total);
+            }
+            catch (const std::bad_alloc &)
+            {
+                writeError(reply, "out of memory");
+                return;
+            }
+        }
+
+        session::RoundInput input;
+        if (!readPositions(request, mines, 0, input.mineCount) || !readPositions(request, guesses, input.mineCount[0] + input.mineCount[1], input.guessCount))
+        {
+            writeError(reply, "positions are [column,row] pairs");
+            return;
+        }
+        input.mines[0] = positions.data();
+        input.mines[1] = input.mines[0] + input.mineCount[0];
+        input.guesses[0] = input.mines[1] + input.mineCount[1];
+        input.guesses[1] = input.guesses[0] + input.guessCount[0];
+
+        session::RoundResult result;
+        session::RoundStatus status = session::RoundStatus::Ok;
+        std::uint32_t nextMines[2];
+        std::uint32_t nextGuesses[2];
+        try
+        {
+            status = session::playRound(game, input, marks, result);
+            if (status == session::RoundStatus::Ok)
+            {
+                session::expectedCounts(game, nextMines, nextGuesses);
+            }
+        }
+        catch (const std::bad_alloc &)
+        {
+            // the round may be applied in part, so the game cannot go on
+            liveCells -= cellCount(game);
+            games.erase(id);
+            writeError(reply, "out of memory, game closed");
+            return;
+        }
+        if (status != session::RoundStatus::Ok)
+        {
+            writeError(reply, (status == session::RoundStatus::GameOver) ? "game over" : "invalid move");
+            return;
+        }
+        reply.beginObject().key("ok").value(true);
+        writeState(reply, id, game, nextMines, nextGuesses);
+        reply.key("hits").beginArray().value(result.hits[0]).value(result.hits[1]).endArray();
+        reply.key("collisions").value(result.collisions);
+        reply.endObject();
+    }
+
+    bool Handler::handle(char *line, std::size_t length, json::Writer &reply)
+    {
+        try
+        {
+            return dispatch(line, length, reply);
+        }
+        catch (const std::bad_alloc &)
+        {
+            // every op that allocates after it starts its reply catches that itself, so no game changed
+            reply.reset();
+            writeError(reply, "out of memory");
+            return true;
+        }
+    }
+
+    bool Handler::dispatch(char *line, std::size_t length, json::Writer &reply)
+    {
+        // every token takes at least one byte of text, so a batch never needs more tokens than that
+        if (tokens.size() <= length && tokens.size() < kMaxBatchTokens)
+        {
+            tokens.resize(std::min<std::size_t>(length + 1, kMaxBatchTokens));
+        }
+        json::Document request(tokens.data(), tokens.size());
+        if (!request.parse(line, length) || request.token(request.root()).type != json::TokenType::Object)
+        {
+            writeError(reply, "malformed request");
+            return true;
+        }
+        const std::string_view op = request.string(request.find(request.root(), "op"));
+
+        if (op == "shutdown")
+        {
+            reply.beginObject().key("ok").value(true).endObject();
+            return false;
+        }
+        if (op == "create")
+        {
+            sim::GameConfig config;
+            if (!readCount(request, request.find(request.root(), "width"), Board::kMinSize, Board::kMaxSimulationSize, config.width)
+                || !readCount(request, request.find(request.root(), "height"), Board::kMinSize, Board::kMaxSimulationSize, config.height)
+                || !readCount(request, request.find(request.root(), "mines"), Board::kMinMines, std::uint64_t{config.width} * config.height, config.mines))
+            {
+                writeError(reply, "create needs width, height and mines");
+                return true;
+            }
+            const std::uint32_t countToken = request.find(request.root(), "count");
+            unsigned int count = 1;
+            if (countToken != 0 && !readCount(request, countToken, 1, kMaxBatchGames, count))
+            {
+                writeError(reply, "count is out of range");
+                return true;
+            }
+            const std::uint64_t cells = std::uint64_t{config.width} * config.height * count;
+            if (cells > kMaxRequestCells || liveCells + cells > maxLiveCells)
+            {
+                writeError(reply, cells > kMaxRequestCells ? "too many cells for one request" : "too many cells held by the server");
+                return true;
+            }
+            // the reply has its room before any game exists, and running out of memory anyway takes back every
+            // game of the request along with the reply
+            if (!reply.reserve(count * kMaxGameReply + kMaxReplyFrame))
+            {
+                throw std::bad_alloc();
+            }
+            const std::uint64_t firstGame = nextGame;
+            try
+            {
+                for (unsigned int i = 0; i < count; ++i)
+                {
+                    games.emplace_hint(games.end(), nextGame, session::Game(config));
+                    nextGame++;
+                    liveCells += cellCount(games.rbegin()->second);
+                }
+                reply.beginObject().key("ok").value(true);
+                if (countToken != 0)
+                {
+                    reply.key("games").beginArray();
+                }
+                for (auto game = games.lower_bound(firstGame); game != games.end(); ++game)
+                {
+                    if (countToken != 0)
+                    {
+                        reply.beginObject();
+                        writeState(reply, game->first, game->second);
+                        reply.endObject();
+                    }
+                    else
+                    {
+                        writeState(reply, game->first, game->second);
+                    }
+                }
+                if (countToken != 0)
+                {
+                    reply.endArray();
+                }
+                reply.endObject();
+            }
+            catch (const std::bad_alloc &)
+            {
+                for (auto game = games.lower_bound(firstGame); game != games.end(); game = games.erase(game))
+                {
+                    liveCells -= cellCount(game->second);
+                }
+                throw;
+            }
+            return true;
+        }
+        if (op == "rounds")
+        {
+            const std::uint32_t rounds = request.find(request.root(), "rounds");
+            if (rounds == 0 || request.token(rounds).type != json::TokenType::Array)
+            {
+                writeError(reply, "rounds needs an array of rounds");
+                return true;
+            }
+            // one result per round in request order; a bad round fails alone
+            if (!reply.reserve(request.token(rounds).children * kMaxGameReply + kMaxReplyFrame))
+            {
+                throw std::bad_alloc();
+            }
+            reply.beginObject().key("ok").value(true).key("results").beginArray();
+            std::uint32_t round = request.firstChild(rounds);
+            for (std::uint32_t i = 0; i < request.token(rounds).children; ++i, round = request.nextSibling(round))
+            {
+                std::uint64_t id = 0;
+                const std::uint32_t idToken = (request.token(round).type == json::TokenType::Object) ? request.find(round, "game") : 0;
+                auto found = (idToken != 0 && request.number(idToken, id)) ? games.find(id) : games.end();
+                if (found == games.end())
+                {
+                    writeError(reply, "unknown game");
+                    continue;
+                }
+                playRound(request, round, id, found->second, reply);
+            }
+            reply.endArray().endObject();
+            return true;
+        }
+        if (op == "close" && request.find(request.root(), "games") != 0)
+        {
+            const std::uint32_t ids = request.find(request.root(), "games");
+            if (request.token(ids).type != json::TokenType::Array)
+            {
+                writeError(reply, "games is a list of game ids");
+                return true;
+            }
+            unsigned int closed = 0;
+            std::uint32_t element = request.firstChild(ids);
+            for (std::uint32_t i = 0; i < request.token(ids).children; ++i, element = request.nextSibling(element))
+            {
+                std::uint64_t id = 0;
+                const auto found = request.number(element, id) ? games.find(id) : games.end();
+                if (found != games.end())
+                {
+                    liveCells -= cellCount(found->second);
+                    games.erase(found);
+                    closed++;
+                }
+            }
+            reply.beginObject().key("ok").value(true).key("closed").value(closed).endObject();
+            return true;
+        }
+
+        std::uint64_t id = 0;
+        const std::uint32_t idToken = request.find(request.root(), "game");
+        auto found = (idToken != 0 && request.number(idToken, id)) ? games.find(id) : games.end();
+        if (found == games.end())
+        {
+            writeError(reply, (op == "round" || op == "state" || op == "board" || op == "close") ? "unknown game" : "unknown op");
+            return true;
+        }
+        session::Game &game = found->second;
+
+        if (op == "round")
+        {
+            playRound(request, request.root(), id, game, reply);
+        }
+        else if (op == "state")
+        {
+            reply.beginObject().key("ok").value(true);
+            writeState(reply, id, game);
+            reply.endObject();
+        }
+        else if (op == "board")
+        {
+            if (!reply.reserve(cellCount(game) + kMaxGameReply))
+            {
+                throw std::bad_alloc();
+            }
+            reply.beginObject().key("ok").value(true).key("game").value(id);
+            json::writeBoard(reply, game.board);
+            reply.endObject();
+        }
+        else if (op == "close")
+        {
+            liveCells -= cellCount(game);
+            games.erase(found);
+            reply.beginObject().key("ok").value(true).endObject();
+        }
+        else
+        {
+            writeError(reply, "unknown op");
+        }
+        return true;
+    }
+
+    void savePositions(handoff::ImageWriter &image, const std::vector<Position> &positions)
+    {
+        image.value(static_cast<std::uint64_t>(positions.size()));
+        image.bytes(positions.data(), positions.size() * sizeof(Position));
+    }
+
+    bool restorePositions(handoff::ImageReader &image, std::vector<Position> &positions)
+    {
+        std::uint64_t count = 0;
+        const char *data = nullptr;
+        if (!image.value(count) || count > std::numeric_limits<std::uint32_t>::max() || !(data = image.view(count * sizeof(Position))))
+        {
+            return false;
+        }
+        positions.resize(count);
+        std::memcpy(positions.data(), data, count * sizeof(Position));
+        return true;
+    }
+
+    void Handler::save(handoff::ImageWriter &image) const
+    {
+        image.value(nextGame);
+        image.value(static_cast<std::uint64_t>(games.size()));
+        std::vector<std::uint8_t> cells;
+        for (const auto &[id, game] : games)
+        {
+            const Board &board = game.board;
+            image.value(id);
+            image.value(board.getWidth());
+            image.value(board.getHeight());
+            image.value(static_cast<std::uint8_t>(game.finished));
+            image.value(static_cast<std::uint8_t>(game.outcome));
+            for (const Player &seat : game.seats)
+            {
+                image.value(seat.remainingMines);
+                image.value(static_cast<std::uint8_t>(seat.isHuman));
+                image.text(seat.name);
+                savePositions(image, seat.currentMines);
+                savePositions(image, seat.currentGuesses);
+            }
+            // every flag combination fits a byte
+            const std::size_t total = static_cast<std::size_t>(board.getWidth()) * board.getHeight();
+            cells.resize(total);
+            std::transform(board.cells(), board.cells() + total, cells.begin(), [](CellStatusFlags status){ return static_cast<std::uint8_t>(status); });
+            image.bytes(cells.data(), total);
+        }
+    }
+
+    bool Handler::restore(handoff::ImageReader &image)
+    {
+        std::uint64_t count = 0;
+        if (!image.value(nextGame) || !image.value(count))
+        {
+            return false;
+        }
+        games.clear();
+        liveCells = 0;
+        for (std::uint64_t i = 0; i < count; ++i)
+        {
+            std::uint64_t id = 0;
+            sim::GameConfig config;
+            std::uint8_t finished = 0;
+            std::uint8_t outcome = 0;
+            if (!image.value(id) || !image.value(config.width) || !image.value(config.height) || !image.value(finished) || !image.value(outcome)
+                || config.width < Board::kMinSize || config.width > Board::kMaxSimulationSize
+                || config.height < Board::kMinSize || config.height > Board::kMaxSimulationSize
+                || outcome > static_cast<std::uint8_t>(sim::Outcome::SecondSeatWins))
+            {
+                return false;
+            }
+            session::Game &game = games.emplace_hint(games.end(), id, session::Game(config))->second;
+            liveCells += cellCount(game);
+            game.finished = finished != 0;
+            game.outcome = static_cast<sim::Outcome>(outcome);
+            for (Player &seat : game.seats)
+            {
+                std::uint8_t isHuman = 0;
+                if (!image.value(seat.remainingMines) || !image.value(isHuman) || !image.text(seat.name)
+                    || !restorePositions(image, seat.currentMines) || !restorePositions(image, seat.currentGuesses))
+                {
+                    return false;
+                }
+                seat.isHuman = isHuman != 0;
+            }
+            const char *cells = image.view(static_cast<std::size_t>(config.width) * config.height);
+            if (!cells)
+            {
+                return false;
+            }
+            for (unsigned int c = 0; c < config.width; ++c)
+            {
+                for (unsigned int r = 0; r < config.height; ++r)
+                {
+                    const std::uint8_t flags = static_cast<std::uint8_t>(*cells++);
+                    game.board.safeCellAccess(c, r, [flags](CellStatusFlags &status){ status = static_cast<CellStatusFlags>(flags); });
+                }
+            }
+        }
+        return true;
+    }
+
+    std::size_t Handler::gameCount() const
+    {
+        return games.size();
+    }
+
+#ifndef _WIN32
+    struct Client
+    {
+        int fd = -1;
+        std::string inbox;  // a request not complete yet
+        std::string outbox; // replies the socket did not take yet
+    };
+
+    // Called when a successor connected on the handoff channel: sends it the image and every socket, then
+    // waits for its word that it resumed. Until then this server still owns everything and keeps serving
+    // if the successor fails.
+    bool handOver(int successor, const Handler &handler, int listener, const std::vector<Client> &clients)
+    {
+        handoff::ImageWriter image;
+        image.value(handoff::kMagic);
+        image.value(handoff::kVersion);
+        handler.save(image);
+        image.value(static_cast<std::uint64_t>(clients.size()));
+        for (const auto &client : clients)
+        {
+            image.text(client.inbox);
+            image.text(client.outbox);
+        }
+        const int memory = handoff::publish(image.data());
+        if (memory < 0)
+        {
+            return false;
+        }
+        std::vector<int> fds = {listener, memory};
+        for (const auto &client : clients)
+        {
+            fds.push_back(client.fd);
+        }
+        char resumed = 0;
+        const bool sent = handoff::sendDescriptors(successor, fds);
+        close(memory);
+        return sent && recv(successor, &resumed, 1, MSG_WAITALL) == 1 && resumed == 1;
+    }
+
+    bool takeOver(const std::string &address, Handler &handler, int &listener, std::vector<Client> &clients, ServerReport &report)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const int channel = net::openSocket(handoff::channelPath(address), false);
+        std::vector<int> fds;
+        if (channel < 0 || !handoff::receiveDescriptors(channel, fds) || fds.size() < 2)
+        {
+            for (const int fd : fds)
+            {
+                close(fd);
+            }
+            if (channel >= 0)
+            {
+                close(channel);
+            }
+            return false;
+        }
+
+        std::size_t size = 0;
+        const char *data = handoff::map(fds[1], size);
+        close(fds[1]);
+        handoff::ImageReader image(data, data ? size : 0);
+        std::uint32_t magic = 0;
+        std::uint32_t version = 0;
+        std::uint64_t count = 0;
+        bool ok = data && image.value(magic) && image.value(version) && magic == handoff::kMagic && version == handoff::kVersion
+            && handler.restore(image) && image.value(count) && count == fds.size() - 2;
+        clients.clear();
+        for (std::size_t i = 2; ok && i < fds.size(); ++i)
+        {
+            Client client{fds[i], {}, {}};
+            ok = image.text(client.inbox) && image.text(client.outbox) && net::setNonBlocking(client.fd);
+            clients.push_back(std::move(client));
+        }
+        if (data)
+        {
+            handoff::release(data, size);
+        }
+
+        // the previous server keeps serving unless it hears that this one resumed
+        const char resumed = 1;
+        if (!ok || !net::sendAll(channel, &resumed, 1))
+        {
+            for (std::size_t i = 0; i < fds.size(); ++i)
+            {
+                if (i != 1)
+                {
+                    close(fds[i]);
+                }
+            }
+            clients.clear();
+            close(channel);
+            return false;
+        }
+        close(channel);
+        listener = fds[0];
+        report.resumedGames = handler.gameCount();
+        report.resumedClients = clients.size();
+        report.pauseMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return true;
+    }
+
+    bool serve(const std::string &address, ServerReport &report, bool takeover)
+    {
+        constexpr std::size_t kReplyBuffer = 64 * 1024;
+        constexpr std::size_t kMaxPending = 16 * 1024 * 1024; // unanswered bytes a client may queue
+        constexpr std::size_t kMaxUnsent = 64 * 1024 * 1024;  // replies a client may leave unread before it is dropped
+
+        std::signal(SIGPIPE, SIG_IGN);
+        Handler handler;
+        std::vector<Client> clients;
+        int listener = -1;
+        if (takeover ? !takeOver(address, handler, listener, clients, report) : (listener = net::openSocket(address, true)) < 0)
+        {
+            return false;
+        }
+        // opened once any previous server is gone, so a later successor finds this one
+        const std::string channelPath = handoff::channelPath(address);
+        const int channel = net::openSocket(channelPath, true);
+
+        std::vector<char> output(kReplyBuffer);
+        std::vector<pollfd> polled;
+        bool running = true;
+        while (running)
+        {
+            polled.assign({pollfd{listener, POLLIN, 0}, pollfd{channel, POLLIN, 0}});
+            for (const auto &client : clients)
+            {
+                polled.push_back({client.fd, static_cast<short>(client.outbox.empty() ? POLLIN : (POLLIN | POLLOUT)), 0});
+            }
+            if (poll(polled.data(), polled.size(), -1) < 0)
+            {
+                continue;
+            }
+            if (polled[1].revents & POLLIN)
+            {
+                const int successor = accept(channel, nullptr, nullptr);
+                if (successor >= 0)
+                {
+                    report.handedOff = handOver(successor, handler, listener, clients);
+                    close(successor);
+                    if (report.handedOff)
+                    {
+                        break;
+                    }
+                }
+            }
+            if (polled[0].revents & POLLIN)
+            {
+                const int fd = accept(listener, nullptr, nullptr);
+                if (fd >= 0 && net::setNonBlocking(fd))
+                {
+                    clients.push_back({fd, {}, {}});
+                    report.connections++;
+                }
+                else if (fd >= 0)
+                {
+                    close(fd);
+                }
+            }
+
+            // a client that stops reading never blocks the others: its replies wait in its outbox, and no
+            // request of it is handled while the outbox holds more than a reply buffer
+            for (std::size_t i = 2; i < polled.size() && running; ++i)
+            {
+                if (!polled[i].revents)
+                {
+                    continue;
+                }
+                Client &client = clients[i - 2];
+                bool open = !(polled[i].revents & POLLOUT) || net::sendPending(client.fd, client.outbox);
+                if (open && (polled[i].revents & (POLLIN | POLLHUP | POLLERR)))
+                {
+                    open = net::receive(client.fd, client.inbox) && client.inbox.size() <= kMaxPending;
+                }
+
+                std::size_t consumed = 0;
+                std::size_t end = 0;
+                while (open && running && client.outbox.size() < kReplyBuffer && (end = client.inbox.find('\n', consumed)) != std::string::npos)
+                {
+                    json::Writer reply(output.data(), output.size(), &client.outbox);
+                    running = handler.handle(&client.inbox[consumed], end - consumed, reply);
+                    open = reply.finish() && net::sendPending(client.fd, client.outbox) && client.outbox.size() <= kMaxUnsent;
+                    consumed = end + 1;
+                    report.requests++;
+                }
+                client.inbox.erase(0, consumed);
+                if (!open)
+                {
+                    close(client.fd);
+                    client.fd = -1;
+                }
+            }
+            clients.erase(std::remove_if(clients.begin(), clients.end(), [](const Client &client){ return client.fd < 0; }), clients.end());
+        }
+
+        // on shutdown, every client still gets what it was answered, as far as it reads it within a moment
+        while (!report.handedOff)
+        {
+            polled.clear();
+            for (const auto &client : clients)
+            {
+                if (!client.outbox.empty())
+                {
+                    polled.push_back({client.fd, POLLOUT, 0});
+                }
+            }
+            if (polled.empty() || poll(polled.data(), polled.size(), 1000) <= 0)
+            {
+                break;
+            }
+            for (auto &client : clients)
+            {
+                if (!client.outbox.empty() && !net::sendPending(client.fd, client.outbox))
+                {
+                    client.outbox.clear();
+                }
+            }
+        }
+
+        // after a handoff the paths belong to the successor, which holds the same sockets
+        for (const auto &client : clients)
+        {
+            close(client.fd);
+        }
+        close(listener);
+        if (channel >= 0)
+        {
+            close(channel);
+        }
+        if (!report.handedOff)
+        {
+            unlink(channelPath.c_str());
+            std::string host;
+            std::string port;
+            if (!net::isTcpAddress(address, host, port))
+            {
+                unlink(address.c_str());
+            }
+        }
+        return true;
+    }
+#endif
+}
@@ -0,0 +1,742 @@
+#include "minefield/engine/archive.h"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace archive
+{
+    void putVarint(std::string &out, std::uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    bool getVarint(const char *&cursor, const char *end, std::uint64_t &value)
+    {
+        value = 0;
+        for (unsigned int shift = 0; cursor != end && shift < 64; shift += 7)
+        {
+            const std::uint8_t byte = static_cast<std::uint8_t>(*cursor++);
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool getVarint(const char *&cursor, const char *end, std::uint64_t max, unsigned int &value)
+    {
+        std::uint64_t number = 0;
+        if (!getVarint(cursor, end, number) || number > max)
+        {
+            return false;
+        }
+        value = static_cast<unsigned int>(number);
+        return true;
+    }
+
+    void putSeat(std::string &out, const sim::Seat &seat)
+    {
+        out.push_back(static_cast<char>(static_cast<unsigned int>(seat.strategy) | (seat.antithetic ? 2U : 0U)));
+        putFixed(out, seat.seed);
+    }
+
+    bool getSeat(const char *&cursor, const char *end, sim::Seat &seat)
+    {
+        std::uint8_t flags = 0;
+        if (!getFixed(cursor, end, flags) || (flags & ~3U) || !getFixed(cursor, end, seat.seed))
+        {
+            return false;
+        }
+        seat.strategy = static_cast<CpuStrategy>(flags & 1U);
+        seat.antithetic = (flags & 2U) != 0;
+        return true;
+    }
+
+    void encodeReplay(const sim::GameReplay &replay, std::string &out)
+    {
+        const unsigned int height = replay.config.height;
+        putVarint(out, replay.config.width);
+        putVarint(out, height);
+        putVarint(out, replay.config.mines);
+        putSeat(out, replay.first);
+        putSeat(out, replay.second);
+        out.push_back(static_cast<char>(replay.result.outcome));
+        putVarint(out, replay.result.rounds);
+        putVarint(out, replay.rounds.size());
+        for (const auto &round : replay.rounds)
+        {
+            for (const std::vector<Position> *list : {&round.mines1, &round.mines2, &round.guesses1, &round.guesses2})
+            {
+                putVarint(out, list->size());
+                for (const auto &position : *list)
+                {
+                    putVarint(out, static_cast<std::uint64_t>(position.column) * height + position.row);
+                }
+            }
+        }
+    }
+
+    PositionList::Iterator::Iterator(const char *cursor, std::uint32_t left, unsigned int height)
+        : cursor(cursor)
+        , left(left)
+        , height(height)
+    {
+        decode();
+    }
+
+    // the record was checked when it was parsed, so the varint is known to be complete and in range
+    void PositionList::Iterator::decode()
+    {
+        if (left == 0)
+        {
+            return;
+        }
+        std::uint64_t cell = 0;
+        for (unsigned int shift = 0;; shift += 7)
+        {
+            const std::uint8_t byte = static_cast<std::uint8_t>(*cursor++);
+            cell |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+            {
+                break;
+            }
+        }
+        position = {static_cast<unsigned int>(cell / height), static_cast<unsigned int>(cell % height)};
+    }
+
+    const Position &PositionList::Iterator::operator*() const
+    {
+        return position;
+    }
+
+    PositionList::Iterator &PositionList::Iterator::operator++()
+    {
+        --left;
+        decode();
+        return *this;
+    }
+
+    bool PositionList::Iterator::operator==(const Iterator &other) const
+    {
+        return left == other.left;
+    }
+
+    bool PositionList::Iterator::operator!=(const Iterator &other) const
+    {
+        return left != other.left;
+    }
+
+    PositionList::PositionList(const char *data, std::uint32_t count, unsigned int height)
+        : data(data)
+        , count(count)
+        , height(height)
+    {
+    }
+
+    std::uint32_t PositionList::size() const
+    {
+        return count;
+    }
+
+    bool PositionList::empty() const
+    {
+        return count == 0;
+    }
+
+    PositionList::Iterator PositionList::begin() const
+    {
+        return Iterator(data, count, height);
+    }
+
+    PositionList::Iterator PositionList::end() const
+    {
+        return Iterator(nullptr, 0, height);
+    }
+
+    bool ReplayView::parse(const char *&cursor, const char *end)
+    {
+        std::uint8_t outcome = 0;
+        unsigned int count = 0;
+        if (!getVarint(cursor, end, Board::kMaxSimulationSize, config.width)
+            || !getVarint(cursor, end, Board::kMaxSimulationSize, config.height)
+            || !getVarint(cursor, end, std::numeric_limits<unsigned int>::max(), config.mines)
+            || !getSeat(cursor, end, first) || !getSeat(cursor, end, second)
+            || !getFixed(cursor, end, outcome) || outcome > static_cast<std::uint8_t>(sim::Outcome::SecondSeatWins)
+            || !getVarint(cursor, end, std::numeric_limits<unsigned int>::max(), result.rounds)
+            || !getVarint(cursor, end, std::numeric_limits<unsigned int>::max(), count)
+            || count > static_cast<std::size_t>(end - cursor)) // every round takes at least four bytes
+        {
+            return false;
+        }
+        result.outcome = static_cast<sim::Outcome>(outcome);
+        const unsigned int height = config.height;
+        const std::uint64_t cells = static_cast<std::uint64_t>(config.width) * height;
+        if (cells == 0)
+        {
+            return false;
+        }
+        rounds.resize(count);
+        for (auto &round : rounds)
+        {
+            for (PositionList *list : {&round.mines1, &round.mines2, &round.guesses1, &round.guesses2})
+            {
+                unsigned int size = 0;
+                if (!getVarint(cursor, end, static_cast<std::uint64_t>(end - cursor), size))
+                {
+                    return false;
+                }
+                const char *first = cursor;
+                for (unsigned int i = 0; i < size; ++i)
+                {
+                    unsigned int cell = 0;
+                    if (!getVarint(cursor, end, cells - 1, cell))
+                    {
+                        return false;
+                    }
+                }
+                *list = PositionList(first, size, height);
+            }
+        }
+        return true;
+    }
+
+    void ReplayView::copyTo(sim::GameReplay &replay) const
+    {
+        replay.config = config;
+        replay.first = first;
+        replay.second = second;
+        replay.result = result;
+        replay.rounds.resize(rounds.size());
+        for (std::size_t r = 0; r < rounds.size(); ++r)
+        {
+            const RoundView &view = rounds[r];
+            sim::RoundRecord &record = replay.rounds[r];
+            for (const auto &[list, positions] : {std::make_pair(&view.mines1, &record.mines1), std::make_pair(&view.mines2, &record.mines2),
+                     std::make_pair(&view.guesses1, &record.guesses1), std::make_pair(&view.guesses2, &record.guesses2)})
+            {
+                positions->assign(list->begin(), list->end());
+            }
+        }
+    }
+
+    bool decodeReplay(const char *&cursor, const char *end, sim::GameReplay &replay)
+    {
+        // one view per thread, so its rounds keep their capacity from game to game
+        thread_local ReplayView view;
+        if (!view.parse(cursor, end))
+        {
+            return false;
+        }
+        view.copyTo(replay);
+        return true;
+    }
+
+    Dictionary::Dictionary()
+        : codes(256 * 256)
+        , symbols(kScale)
+    {
+        std::array<std::uint16_t, 256> uniform;
+        uniform.fill(kScale / 256);
+        for (unsigned int context = 0; context < 256; ++context)
+        {
+            table[context] = 0;
+            setContext(context, uniform);
+        }
+    }
+
+    void Dictionary::setContext(unsigned int context, const std::array<std::uint16_t, 256> &frequencies)
+    {
+        std::uint8_t *slots = symbols.data() + table[context];
+        std::uint16_t cumulative = 0;
+        for (unsigned int symbol = 0; symbol < 256; ++symbol)
+        {
+            codes[context * 256 + symbol] = {frequencies[symbol], cumulative};
+            std::fill(slots + cumulative, slots + cumulative + frequencies[symbol], static_cast<std::uint8_t>(symbol));
+            cumulative = static_cast<std::uint16_t>(cumulative + frequencies[symbol]);
+        }
+    }
+
+    // Every symbol keeps one slot and the rest is shared out by count plus one, as a byte never seen after this
+    // context in the samples is rare rather than impossible; what rounding leaves goes to the most common.
+    std::array<std::uint16_t, 256> normalize(const std::array<std::uint64_t, 256> &counts, std::uint64_t total, unsigned int scale)
+    {
+        std::array<std::uint16_t, 256> frequencies;
+        const unsigned int spare = scale - 256;
+        unsigned int used = 0;
+        for (unsigned int symbol = 0; symbol < 256; ++symbol)
+        {
+            frequencies[symbol] = static_cast<std::uint16_t>(1 + (counts[symbol] + 1) * spare / (total + 256));
+            used += frequencies[symbol];
+        }
+        const auto common = std::max_element(counts.begin(), counts.end()) - counts.begin();
+        frequencies[common] = static_cast<std::uint16_t>(frequencies[common] + scale - used);
+        return frequencies;
+    }
+
+    Dictionary Dictionary::train(const std::vector<sim::GameReplay> &samples)
+    {
+        std::string raw;
+        for (const auto &replay : samples)
+        {
+            encodeReplay(replay, raw);
+        }
+        std::vector<std::array<std::uint64_t, 256>> counts(256);
+        std::uint8_t previous = 0;
+        for (const char ch : raw)
+        {
+            counts[previous][static_cast<std::uint8_t>(ch)]++;
+            previous = static_cast<std::uint8_t>(ch);
+        }
+
+        Dictionary dictionary;
+        for (unsigned int context = 0; context < 256; ++context)
+        {
+            std::uint64_t total = 0;
+            for (const std::uint64_t count : counts[context])
+            {
+                total += count;
+            }
+            if (total > 0)
+            {
+                dictionary.table[context] = static_cast<std::uint32_t>(dictionary.symbols.size());
+                dictionary.symbols.resize(dictionary.symbols.size() + kScale);
+                dictionary.setContext(context, normalize(counts[context], total, kScale));
+            }
+        }
+        return dictionary;
+    }
+
+    const Dictionary::Code &Dictionary::code(unsigned int context, unsigned int symbol) const
+    {
+        return codes[context * 256 + symbol];
+    }
+
+    unsigned int Dictionary::trainedContexts() const
+    {
+        return static_cast<unsigned int>(symbols.size() / kScale - 1);
+    }
+
+    // byte-wise rANS with a 32-bit state kept in [kLow, kLow << 8)
+    constexpr std::uint32_t kLow = 1U << 23;
+
+    void Dictionary::compress(const std::string &raw, std::string &out) const
+    {
+        // symbols are coded last to first, so the output fills a buffer from its end
+        std::vector<std::uint8_t> buffer(2 * raw.size() + 8);
+        std::uint8_t *cursor = buffer.data() + buffer.size();
+        std::uint32_t state = kLow;
+        for (std::size_t i = raw.size(); i-- > 0;)
+        {
+            const std::uint8_t context = i ? static_cast<std::uint8_t>(raw[i - 1]) : 0;
+            const std::uint8_t symbol = static_cast<std::uint8_t>(raw[i]);
+            const Code &entry = code(context, symbol);
+            const std::uint32_t freq = entry.frequency;
+            const std::uint32_t limit = ((kLow >> kScaleBits) << 8) * freq;
+            while (state >= limit)
+            {
+                *--cursor = static_cast<std::uint8_t>(state);
+                state >>= 8;
+            }
+            state = ((state / freq) << kScaleBits) + (state % freq) + entry.start;
+        }
+        for (int i = 0; i < 4; ++i)
+        {
+            *--cursor = static_cast<std::uint8_t>(state);
+            state >>= 8;
+        }
+        out.assign(reinterpret_cast<const char *>(cursor), buffer.data() + buffer.size() - cursor);
+    }
+
+    bool Dictionary::decompress(const char *data, std::size_t size, std::size_t rawSize, std::string &out) const
+    {
+        const std::uint8_t *cursor = reinterpret_cast<const std::uint8_t *>(data);
+        const std::uint8_t *end = cursor + size;
+        if (size < 4)
+        {
+            return false;
+        }
+        std::uint32_t state = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            state = (state << 8) | *cursor++;
+        }
+        out.resize(rawSize);
+        char *target = out.data();
+        std::uint8_t context = 0;
+        for (std::size_t i = 0; i < rawSize; ++i)
+        {
+            const std::uint32_t slot = state & (kScale - 1);
+            const std::uint8_t symbol = symbols[table[context] + slot];
+            const Code &entry = code(context, symbol);
+            state = entry.frequency * (state >> kScaleBits) + slot - entry.start;
+            // a symbol never costs more than kScaleBits bits, so at most two bytes come in, without branching
+            // while the input has them
+            if (end - cursor >= 2)
+            {
+                for (int k = 0; k < 2; ++k)
+                {
+                    const bool low = state < kLow;
+                    state = low ? (state << 8) | *cursor : state;
+                    cursor += low;
+                }
+            }
+            else
+            {
+                while (state < kLow)
+                {
+                    if (cursor == end)
+                    {
+                        return false;
+                    }
+                    state = (state << 8) | *cursor++;
+                }
+            }
+            target[i] = static_cast<char>(symbol);
+            context = symbol;
+        }
+        return cursor == end && state == kLow;
+    }
+
+    // which contexts were trained, then their frequencies
+    void Dictionary::save(std::string &out) const
+    {
+        for (unsigned int word = 0; word < 256; word += 64)
+        {
+            std::uint64_t trained = 0;
+            for (unsigned int context = word; context < word + 64; ++context)
+            {
+                trained |= static_cast<std::uint64_t>(table[context] != 0) << (context - word);
+            }
+            putFixed(out, trained);
+        }
+        for (unsigned int context = 0; context < 256; ++context)
+        {
+            if (table[context] != 0)
+            {
+                for (unsigned int symbol = 0; symbol < 256; ++symbol)
+                {
+                    putVarint(out, code(context, symbol).frequency);
+                }
+            }
+        }
+    }
+
+    bool Dictionary::load(const char *&cursor, const char *end)
+    {
+        *this = Dictionary();
+        std::uint64_t trained[4];
+        for (auto &word : trained)
+        {
+            if (!getFixed(cursor, end, word))
+            {
+                return false;
+            }
+        }
+        for (unsigned int context = 0; context < 256; ++context)
+        {
+            if (!((trained[context / 64] >> (context % 64)) & 1))
+            {
+                continue;
+            }
+            std::array<std::uint16_t, 256> frequencies;
+            unsigned int total = 0;
+            for (auto &freq : frequencies)
+            {
+                unsigned int value = 0;
+                if (!getVarint(cursor, end, kScale, value) || value == 0)
+                {
+                    return false;
+                }
+                freq = static_cast<std::uint16_t>(value);
+                total += value;
+            }
+            if (total != kScale)
+            {
+                return false;
+            }
+            table[context] = static_cast<std::uint32_t>(symbols.size());
+            symbols.resize(symbols.size() + kScale);
+            setContext(context, frequencies);
+        }
+        return true;
+    }
+
+    double Stats::ratio() const
+    {
+        return compressedBytes ? static_cast<double>(rawBytes) / compressedBytes : 0.0;
+    }
+
+    Writer::Writer(const std::string &path, const Dictionary &dictionary, unsigned int blockReplays)
+        : dictionary(dictionary)
+        , blockReplays(std::max(blockReplays, 1U))
+        , file(path, std::ios::binary | std::ios::trunc)
+    {
+        std::string header;
+        putFixed(header, kMagic);
+        putFixed(header, kVersion);
+        dictionary.save(header);
+        file.write(header.data(), static_cast<std::streamsize>(header.size()));
+        offset = header.size();
+    }
+
+    bool Writer::add(const sim::GameReplay &replay)
+    {
+        encodeReplay(replay, raw);
+        totals.replays++;
+        return ++pending < blockReplays || flushBlock();
+    }
+
+    bool Writer::flushBlock()
+    {
+        if (pending == 0)
+        {
+            return static_cast<bool>(file);
+        }
+        dictionary.compress(raw, compressed);
+        BlockInfo info;
+        info.offset = offset;
+        info.firstReplay = totals.replays - pending;
+        info.replays = pending;
+        info.rawSize = static_cast<std::uint32_t>(raw.size());
+        info.compressedSize = static_cast<std::uint32_t>(compressed.size());
+        directory.push_back(info);
+        file.write(compressed.data(), static_cast<std::streamsize>(compressed.size()));
+
+        offset += compressed.size();
+        totals.blocks++;
+        totals.rawBytes += raw.size();
+        totals.compressedBytes += compressed.size();
+        raw.clear();
+        pending = 0;
+        return static_cast<bool>(file);
+    }
+
+    bool Writer::finish()
+    {
+        if (!flushBlock())
+        {
+            return false;
+        }
+        std::string tail;
+        for (const auto &info : directory)
+        {
+            putFixed(tail, info.offset);
+            putFixed(tail, info.firstReplay);
+            putFixed(tail, info.replays);
+            putFixed(tail, info.rawSize);
+            putFixed(tail, info.compressedSize);
+        }
+        putFixed(tail, offset);
+        putFixed(tail, static_cast<std::uint64_t>(directory.size()));
+        putFixed(tail, totals.replays);
+        putFixed(tail, kMagic);
+        file.write(tail.data(), static_cast<std::streamsize>(tail.size()));
+        file.close();
+        return !file.fail();
+    }
+
+    const Stats &Writer::stats() const
+    {
+        return totals;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        close();
+    }
+
+    void MappedFile::close()
+    {
+#ifndef _WIN32
+        if (base && length > 0)
+        {
+            munmap(const_cast<char *>(base), length);
+        }
+#endif
+        base = nullptr;
+        length = 0;
+    }
+
+    bool MappedFile::open(const std::string &path)
+    {
+        close();
+#ifndef _WIN32
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        struct stat info = {};
+        if (fd < 0 || fstat(fd, &info) != 0)
+        {
+            if (fd >= 0)
+            {
+                ::close(fd);
+            }
+            return false;
+        }
+        length = static_cast<std::size_t>(info.st_size);
+        void *memory = (length > 0) ? mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0) : nullptr;
+        ::close(fd);
+        if (memory == MAP_FAILED)
+        {
+            length = 0;
+            return false;
+        }
+        base = static_cast<const char *>(memory);
+        return true;
+#else
+        std::ifstream file(path, std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        base = contents.data();
+        length = contents.size();
+        return !file.bad() && file.is_open();
+#endif
+    }
+
+    const char *MappedFile::data() const
+    {
+        return base;
+    }
+
+    std::size_t MappedFile::size() const
+    {
+        return length;
+    }
+
+    bool Reader::open(const std::string &path)
+    {
+        constexpr std::size_t kTrailer = 3 * sizeof(std::uint64_t) + sizeof(std::uint32_t);
+        constexpr std::size_t kEntry = 2 * sizeof(std::uint64_t) + 3 * sizeof(std::uint32_t);
+
+        directory.clear();
+        replays = 0;
+        if (!file.open(path) || file.size() < 2 * sizeof(std::uint32_t) + kTrailer)
+        {
+            return false;
+        }
+        const char *begin = file.data();
+        const char *end = begin + file.size();
+        const char *cursor = end - kTrailer;
+        std::uint64_t directoryOffset = 0;
+        std::uint64_t blocks = 0;
+        std::uint32_t magic = 0;
+        getFixed(cursor, end, directoryOffset);
+        getFixed(cursor, end, blocks);
+        getFixed(cursor, end, replays);
+        getFixed(cursor, end, magic);
+        const std::uint64_t limit = file.size() - kTrailer;
+        if (magic != kMagic || directoryOffset > limit || limit - directoryOffset != blocks * kEntry)
+        {
+            return false;
+        }
+
+        cursor = begin + directoryOffset;
+        directory.resize(blocks);
+        for (auto &info : directory)
+        {
+            getFixed(cursor, end, info.offset);
+            getFixed(cursor, end, info.firstReplay);
+            getFixed(cursor, end, info.replays);
+            getFixed(cursor, end, info.rawSize);
+            getFixed(cursor, end, info.compressedSize);
+            if (info.offset + info.compressedSize > directoryOffset)
+            {
+                return false;
+            }
+        }
+
+        // the header and dictionary end where the first block starts
+        cursor = begin;
+        end = begin + directoryOffset;
+        std::uint32_t version = 0;
+        return getFixed(cursor, end, magic) && magic == kMagic && getFixed(cursor, end, version) && version == kVersion
+            && dictionary.load(cursor, end);
+    }
+
+    std::size_t Reader::blockCount() const
+    {
+        return directory.size();
+    }
+
+    std::uint64_t Reader::replayCount() const
+    {
+        return replays;
+    }
+
+    const BlockInfo &Reader::block(std::size_t index) const
+    {
+        return directory[index];
+    }
+
+    const Dictionary &Reader::getDictionary() const
+    {
+        return dictionary;
+    }
+
+    bool Reader::readRaw(std::size_t index, std::string &out) const
+    {
+        if (index >= directory.size())
+        {
+            return false;
+        }
+        const BlockInfo &info = directory[index];
+        return dictionary.decompress(file.data() + info.offset, info.compressedSize, info.rawSize, out);
+    }
+
+    bool Reader::readBlock(std::size_t index, std::vector<sim::GameReplay> &out)
+    {
+        if (!readRaw(index, raw))
+        {
+            return false;
+        }
+        out.resize(directory[index].replays);
+        const char *cursor = raw.data();
+        for (auto &replay : out)
+        {
+            if (!decodeReplay(cursor, raw.data() + raw.size(), replay))
+            {
+                return false;
+            }
+        }
+        return cursor == raw.data() + raw.size();
+    }
+
+    bool Reader::readReplay(std::uint64_t index, sim::GameReplay &replay)
+    {
+        // the last block starting at or before index
+        auto found = std::upper_bound(directory.begin(), directory.end(), index, [](std::uint64_t value, const BlockInfo &info){ return value < info.firstReplay; });
+        if (index >= replays || found == directory.begin() || !readRaw(static_cast<std::size_t>(found - directory.begin() - 1), raw))
+        {
+            return false;
+        }
+        const char *cursor = raw.data();
+        for (std::uint64_t skip = index - (found - 1)->firstReplay + 1; skip > 0; --skip)
+        {
+            if (!decodeReplay(cursor, raw.data() + raw.size(), replay))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::ostream &operator<<(std::ostream &stream, const Stats &stats)
+    {
+        stream << stats.replays << " games in " << stats.blocks << " blocks: " << stats.rawBytes << " bytes of records, "
+               << stats.compressedBytes << " compressed (ratio " << stats.ratio() << ", "
+               << (stats.replays ? 8.0 * stats.compressedBytes / stats.replays : 0.0) << " bits per game)\n";
+        return stream;
+    }
+}
@@ -0,0 +1,194 @@
+#include "minefield/engine/bitplane.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace bitplane
+{
+    constexpr std::size_t kDisabledPlane = 0;
+    constexpr std::size_t kMinePlane = 1;
+    constexpr std::size_t kCollisionPlane = 2;
+    constexpr std::size_t kFirstOwnerPlane = 3;
+
+    MinePlanes::MinePlanes(const Board &board, unsigned int seats)
+        : width(board.getWidth())
+        , height(board.getHeight())
+        , seats(seats)
+        , words((static_cast<std::size_t>(width) * height + 63) / 64)
+        , storage(new Word[(kFirstOwnerPlane + seats) * words])
+    {
+        for (std::size_t w = 0; w < (kFirstOwnerPlane + seats) * words; ++w)
+        {
+            storage[w].store(0, std::memory_order_relaxed);
+        }
+        const CellStatusFlags *cells = board.cells();
+        Word *disabled = plane(kDisabledPlane);
+        for (std::size_t index = 0; index < static_cast<std::size_t>(width) * height; ++index)
+        {
+            if (hasFlag(cells[index], CellStatusFlags::Disabled))
+            {
+                disabled[index / 64].fetch_or(std::uint64_t{1} << (index % 64), std::memory_order_relaxed);
+            }
+        }
+    }
+
+    MinePlanes::Word *MinePlanes::plane(std::size_t number) const
+    {
+        return storage.get() + number * words;
+    }
+
+    std::size_t MinePlanes::cellIndex(unsigned int col, unsigned int row) const
+    {
+        return static_cast<std::size_t>(col) * height + row;
+    }
+
+    bool MinePlanes::test(const Word *bits, std::size_t index) const
+    {
+        return (bits[index / 64].load(std::memory_order_relaxed) >> (index % 64)) & 1;
+    }
+
+    Placement MinePlanes::place(unsigned int seat, unsigned int col, unsigned int row)
+    {
+        if (seat >= seats || col >= width || row >= height)
+        {
+            return Placement::Invalid;
+        }
+        const std::size_t index = cellIndex(col, row);
+        if (test(plane(kDisabledPlane), index))
+        {
+            return Placement::Invalid;
+        }
+        const std::uint64_t bit = std::uint64_t{1} << (index % 64);
+        if (plane(kFirstOwnerPlane + seat)[index / 64].fetch_or(bit, std::memory_order_relaxed) & bit)
+        {
+            return Placement::Duplicate;
+        }
+        if (plane(kMinePlane)[index / 64].fetch_or(bit, std::memory_order_relaxed) & bit)
+        {
+            plane(kCollisionPlane)[index / 64].fetch_or(bit, std::memory_order_relaxed);
+            return Placement::Collision;
+        }
+        return Placement::Placed;
+    }
+
+    void MinePlanes::clear()
+    {
+        for (std::size_t w = kMinePlane * words; w < (kFirstOwnerPlane + seats) * words; ++w)
+        {
+            storage[w].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    bool MinePlanes::hasMine(unsigned int col, unsigned int row) const
+    {
+        if (col >= width || row >= height)
+        {
+            return false;
+        }
+        const std::size_t index = cellIndex(col, row);
+        return test(plane(kMinePlane), index) && !test(plane(kCollisionPlane), index);
+    }
+
+    bool MinePlanes::collided(unsigned int col, unsigned int row) const
+    {
+        return col < width && row < height && test(plane(kCollisionPlane), cellIndex(col, row));
+    }
+
+    bool MinePlanes::owns(unsigned int seat, unsigned int col, unsigned int row) const
+    {
+        return seat < seats && col < width && row < height && test(plane(kFirstOwnerPlane + seat), cellIndex(col, row));
+    }
+
+    unsigned int MinePlanes::count(const Word *bits, const Word *mask, bool inverted) const
+    {
+        unsigned int total = 0;
+        for (std::size_t w = 0; w < words; ++w)
+        {
+            const std::uint64_t masked = mask[w].load(std::memory_order_relaxed);
+            total += std::popcount(bits[w].load(std::memory_order_relaxed) & (inverted ? ~masked : masked));
+        }
+        return total;
+    }
+
+    unsigned int MinePlanes::survivors(unsigned int seat) const
+    {
+        return (seat < seats) ? count(plane(kFirstOwnerPlane + seat), plane(kCollisionPlane), true) : 0;
+    }
+
+    unsigned int MinePlanes::collisions(unsigned int seat) const
+    {
+        return (seat < seats) ? count(plane(kFirstOwnerPlane + seat), plane(kCollisionPlane), false) : 0;
+    }
+
+    void MinePlanes::applyTo(Board &board) const
+    {
+        const Word *mines = plane(kMinePlane);
+        const Word *collisions = plane(kCollisionPlane);
+        for (std::size_t w = 0; w < words; ++w)
+        {
+            // only set bits are visited, so sparse rounds on large boards stay cheap
+            std::uint64_t touched = mines[w].load(std::memory_order_relaxed);
+            const std::uint64_t collided = collisions[w].load(std::memory_order_relaxed);
+            while (touched)
+            {
+                const unsigned int bit = static_cast<unsigned int>(std::countr_zero(touched));
+                touched &= touched - 1;
+                const std::size_t index = w * 64 + bit;
+                const bool lost = (collided >> bit) & 1;
+                board.safeCellAccess(static_cast<unsigned int>(index / height), static_cast<unsigned int>(index % height), [lost](CellStatusFlags &status)
+                    {
+                        if (lost)
+                        {
+                            status |= CellStatusFlags::HadCollision | CellStatusFlags::Disabled;
+                            status = status & ~CellStatusFlags::HasMine;
+                        }
+                        else
+                        {
+                            status |= CellStatusFlags::HasMine;
+                        }
+                    });
+            }
+        }
+    }
+
+    unsigned int MinePlanes::getSeats() const
+    {
+        return seats;
+    }
+
+    PlacementReport placeAll(MinePlanes &planes, const std::vector<std::vector<Position>> &mines, sim::WorkerPool &pool, std::size_t chunkSize)
+    {
+        std::atomic<std::uint64_t> placed{0};
+        std::atomic<std::uint64_t> collisions{0};
+        std::atomic<std::uint64_t> rejected{0};
+        chunkSize = std::max<std::size_t>(chunkSize, 1);
+
+        const unsigned int seats = static_cast<unsigned int>(std::min<std::size_t>(mines.size(), planes.getSeats()));
+        for (unsigned int seat = 0; seat < seats; ++seat)
+        {
+            const std::vector<Position> &list = mines[seat];
+            for (std::size_t begin = 0; begin < list.size(); begin += chunkSize)
+            {
+                const std::size_t end = std::min(list.size(), begin + chunkSize);
+                pool.submit([&, seat, begin, end]()
+                    {
+                        std::uint64_t counts[4] = {};
+                        for (std::size_t i = begin; i < end; ++i)
+                        {
+                            counts[static_cast<int>(planes.place(seat, list[i].column, list[i].row))]++;
+                        }
+                        placed += counts[static_cast<int>(Placement::Placed)];
+                        collisions += counts[static_cast<int>(Placement::Collision)];
+                        rejected += counts[static_cast<int>(Placement::Duplicate)] + counts[static_cast<int>(Placement::Invalid)];
+                    });
+            }
+        }
+        pool.wait();
+
+        PlacementReport report;
+        report.placed = placed.load();
+        report.collisions = collisions.load();
+        report.rejected = rejected.load();
+        return report;
+    }
+}
@@ -0,0 +1,94 @@
+#include "minefield/engine/board.h"
+
+#include "minefield/engine/parallel.h"
+
+#include <iomanip>
+#include <string>
+#include <vector>
+
+Board::Board(unsigned int w, unsigned int h, unsigned int maxSize)
+{
+    width = (w >= kMinSize && w <= maxSize) ? w : kMinSize;
+    height = (h >= kMinSize && h <= maxSize) ? h : kMinSize;
+    grid.assign(static_cast<std::size_t>(width) * height, CellStatusFlags::None);
+}
+
+bool Board::isValidMineCount(unsigned int count) const
+{
+    return (count >= kMinMines && count <= kMaxMines);
+}
+
+// board display
+char getSymbolForStatus(const CellStatusFlags status)
+{
+    if (hasFlag(status, CellStatusFlags::SelfDetonated))
+    {
+        return '#';
+    }
+    if (hasFlag(status, CellStatusFlags::HadCollision))
+    {
+        return '*';
+    }
+    if (hasFlag(status, CellStatusFlags::WasGuessed) && hasFlag(status, CellStatusFlags::HasMine))
+    {
+        return 'G';
+    }
+    if (hasFlag(status, CellStatusFlags::Disabled))
+    {
+        return 'X';
+    }
+    return '.'; // empty
+}
+
+std::ostream &operator<<(std::ostream &stream, const Board &board)
+{
+    stream << "\n === BOARD === \n   ";
+    for (unsigned int c = 0; c < board.getWidth(); ++c)
+    {
+        stream << std::setw(3) << c + 1;
+    }
+    stream << '\n';
+
+    const std::size_t cells = static_cast<std::size_t>(board.getWidth()) * board.getHeight();
+    if (parallel::chunksFor(board.getHeight(), board.getWidth()) == 1)
+    {
+        for (unsigned int r = 0; r < board.getHeight(); ++r)
+        {
+            stream << std::setw(3) << r + 1;
+            for (unsigned int c = 0; c < board.getWidth(); ++c)
+            {
+                const CellStatusFlags status = board.getCellStatus(c, r);
+                stream << std::setw(3) << getSymbolForStatus(status);
+            }
+            stream << '\n';
+        }
+    }
+    else
+    {
+        // huge boards: every chunk of rows is formatted into its own text, written out in order
+        std::vector<std::string> texts(parallel::chunksFor(board.getHeight(), board.getWidth()));
+        const char fill = stream.fill();
+        parallel::forChunks(board.getHeight(), board.getWidth(), [&](unsigned int chunk, std::size_t first, std::size_t last)
+            {
+                std::string &text = texts[chunk];
+                text.reserve(cells / texts.size() * 3 + (last - first) * 8);
+                for (std::size_t r = first; r < last; ++r)
+                {
+                    const std::string label = std::to_string(r + 1);
+                    text.append(label.size() < 3 ? 3 - label.size() : 0, fill).append(label);
+                    for (unsigned int c = 0; c < board.getWidth(); ++c)
+                    {
+                        text.append(2, fill).push_back(getSymbolForStatus(board.getCellStatus(c, static_cast<unsigned int>(r))));
+                    }
+                    text.push_back('\n');
+                }
+            });
+        for (const auto &text : texts)
+        {
+            stream << text;
+        }
+    }
+
+    stream << '\n';
+    return stream;
+}
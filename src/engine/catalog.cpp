@@ -0,0 +1,439 @@
+#include "minefield/engine/catalog.h"
+
+#include "minefield/engine/utils.h"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iterator>
+#include <map>
+
+namespace catalog
+{
+    // header, then per block the summary, then the sorted key table (key, count, offset into the postings)
+    constexpr std::size_t kHeaderSize = 2 * sizeof(std::uint32_t) + 3 * sizeof(std::uint64_t);
+    constexpr std::size_t kSummarySize = 9 * sizeof(std::uint32_t) + kBloomWords * sizeof(std::uint64_t);
+    constexpr std::size_t kKeySize = 3 * sizeof(std::uint64_t);
+    constexpr unsigned int kFeatures = 5;
+
+    // with ranges to check, a posting list longer than this share of the games saves less than the block summaries
+    constexpr std::uint64_t kSelectiveShare = 8;
+
+    std::uint64_t featureKey(Feature feature, std::uint64_t value)
+    {
+        return (static_cast<std::uint64_t>(feature) << 56) | value;
+    }
+
+    Features featuresOf(const sim::GameReplay &replay)
+    {
+        Features features;
+        features.width = replay.config.width;
+        features.height = replay.config.height;
+        features.mines = replay.config.mines;
+        features.rounds = static_cast<unsigned int>(replay.rounds.size());
+        features.outcome = replay.result.outcome;
+        features.first = replay.first.strategy;
+        features.second = replay.second.strategy;
+
+        std::vector<std::uint64_t> cells;
+        for (const auto &round : replay.rounds)
+        {
+            cells.clear();
+            for (const auto &mine : round.mines1)
+            {
+                cells.push_back(static_cast<std::uint64_t>(mine.column) * features.height + mine.row);
+            }
+            std::sort(cells.begin(), cells.end());
+            for (const auto &mine : round.mines2)
+            {
+                features.collisions += std::binary_search(cells.begin(), cells.end(), static_cast<std::uint64_t>(mine.column) * features.height + mine.row) ? 1 : 0;
+            }
+        }
+        return features;
+    }
+
+    std::array<std::uint64_t, kFeatures> keysOf(const Features &features)
+    {
+        return {featureKey(Feature::Width, features.width), featureKey(Feature::Height, features.height), featureKey(Feature::Mines, features.mines),
+            featureKey(Feature::Outcome, static_cast<std::uint64_t>(features.outcome)),
+            featureKey(Feature::Strategies, static_cast<std::uint64_t>(features.first) * 2 + static_cast<std::uint64_t>(features.second))};
+    }
+
+    // the keys the query asks for, in a fixed order
+    std::vector<std::uint64_t> keysOf(const Query &query)
+    {
+        std::vector<std::uint64_t> keys;
+        if (query.width != Query::kAny)
+        {
+            keys.push_back(featureKey(Feature::Width, query.width));
+        }
+        if (query.height != Query::kAny)
+        {
+            keys.push_back(featureKey(Feature::Height, query.height));
+        }
+        if (query.mines != Query::kAny)
+        {
+            keys.push_back(featureKey(Feature::Mines, query.mines));
+        }
+        if (query.outcome != Query::kAny)
+        {
+            keys.push_back(featureKey(Feature::Outcome, query.outcome));
+        }
+        return keys;
+    }
+
+    bool matches(const Features &features, const Query &query)
+    {
+        return (query.width == Query::kAny || features.width == query.width) && (query.height == Query::kAny || features.height == query.height)
+            && (query.mines == Query::kAny || features.mines == query.mines)
+            && (query.outcome == Query::kAny || static_cast<unsigned int>(features.outcome) == query.outcome)
+            && features.rounds >= query.minRounds && features.rounds <= query.maxRounds
+            && features.collisions >= query.minCollisions && features.collisions <= query.maxCollisions;
+    }
+
+    // three bits of the block's bloom filter per key
+    template <typename OnBitFnT>
+    void forBloomBits(std::uint64_t key, OnBitFnT onBit)
+    {
+        constexpr std::uint64_t kBits = kBloomWords * 64;
+        const std::uint64_t hash = utils::mixSeed(key, 0x626C6F6F6D);
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            const std::uint64_t bit = (hash >> (16 * i)) % kBits;
+            onBit(bit / 64, std::uint64_t{1} << (bit % 64));
+        }
+    }
+
+    bool mayContain(const BlockSummary &summary, std::uint64_t key)
+    {
+        bool found = true;
+        forBloomBits(key, [&](std::size_t word, std::uint64_t bit){ found = found && (summary.bloom[word] & bit); });
+        return found;
+    }
+
+    // what the summary says about the block: none of its games can match, all of them match, or it must be read
+    enum class Coverage
+    {
+        None,
+        All,
+        Some
+    };
+
+    Coverage cover(const BlockSummary &summary, const Query &query, const std::vector<std::uint64_t> &keys)
+    {
+        if (summary.maxRounds < query.minRounds || summary.minRounds > query.maxRounds || summary.maxCollisions < query.minCollisions
+            || summary.minCollisions > query.maxCollisions || (query.mines != Query::kAny && (query.mines < summary.minMines || query.mines > summary.maxMines))
+            || (query.outcome != Query::kAny && (query.outcome > 2 || summary.outcomes[query.outcome] == 0)))
+        {
+            return Coverage::None;
+        }
+        for (const std::uint64_t key : keys)
+        {
+            if (!mayContain(summary, key))
+            {
+                return Coverage::None;
+            }
+        }
+        const bool rangesHold = summary.minRounds >= query.minRounds && summary.maxRounds <= query.maxRounds
+            && summary.minCollisions >= query.minCollisions && summary.maxCollisions <= query.maxCollisions;
+        return (rangesHold && keys.empty()) ? Coverage::All : Coverage::Some;
+    }
+
+    bool build(archive::Reader &reader, const std::string &path)
+    {
+        std::vector<BlockSummary> summaries(reader.blockCount());
+        std::map<std::uint64_t, std::vector<std::uint64_t>> lists;
+        std::vector<sim::GameReplay> replays;
+        for (std::size_t b = 0; b < reader.blockCount(); ++b)
+        {
+            if (!reader.readBlock(b, replays))
+            {
+                return false;
+            }
+            BlockSummary &summary = summaries[b];
+            for (std::size_t i = 0; i < replays.size(); ++i)
+            {
+                const Features features = featuresOf(replays[i]);
+                summary.minRounds = std::min(summary.minRounds, features.rounds);
+                summary.maxRounds = std::max(summary.maxRounds, features.rounds);
+                summary.minCollisions = std::min(summary.minCollisions, features.collisions);
+                summary.maxCollisions = std::max(summary.maxCollisions, features.collisions);
+                summary.minMines = std::min(summary.minMines, features.mines);
+                summary.maxMines = std::max(summary.maxMines, features.mines);
+                summary.outcomes[static_cast<std::size_t>(features.outcome)]++;
+                for (const std::uint64_t key : keysOf(features))
+                {
+                    lists[key].push_back(reader.block(b).firstReplay + i);
+                    forBloomBits(key, [&](std::size_t word, std::uint64_t bit){ summary.bloom[word] |= bit; });
+                }
+            }
+        }
+
+        std::string out;
+        archive::putFixed(out, kMagic);
+        archive::putFixed(out, kVersion);
+        archive::putFixed(out, reader.replayCount());
+        archive::putFixed(out, static_cast<std::uint64_t>(summaries.size()));
+        archive::putFixed(out, static_cast<std::uint64_t>(lists.size()));
+        for (const auto &summary : summaries)
+        {
+            for (const std::uint32_t value : {summary.minRounds, summary.maxRounds, summary.minCollisions, summary.maxCollisions, summary.minMines,
+                     summary.maxMines, summary.outcomes[0], summary.outcomes[1], summary.outcomes[2]})
+            {
+                archive::putFixed(out, value);
+            }
+            for (const std::uint64_t word : summary.bloom)
+            {
+                archive::putFixed(out, word);
+            }
+        }
+        std::string postings;
+        for (const auto &[key, games] : lists)
+        {
+            archive::putFixed(out, key);
+            archive::putFixed(out, static_cast<std::uint64_t>(games.size()));
+            archive::putFixed(out, static_cast<std::uint64_t>(postings.size()));
+            std::uint64_t previous = 0;
+            for (const std::uint64_t game : games)
+            {
+                archive::putVarint(postings, game - previous);
+                previous = game;
+            }
+        }
+        out += postings;
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(out.data(), static_cast<std::streamsize>(out.size()));
+        file.close();
+        return !file.fail();
+    }
+
+    bool Catalog::open(const std::string &path)
+    {
+        if (!file.open(path) || file.size() < kHeaderSize)
+        {
+            return false;
+        }
+        const char *cursor = file.data();
+        end = file.data() + file.size();
+        std::uint32_t magic = 0;
+        std::uint32_t version = 0;
+        archive::getFixed(cursor, end, magic);
+        archive::getFixed(cursor, end, version);
+        archive::getFixed(cursor, end, games);
+        archive::getFixed(cursor, end, blocks);
+        archive::getFixed(cursor, end, keys);
+        if (magic != kMagic || version != kVersion || blocks > file.size() / kSummarySize || keys > file.size() / kKeySize
+            || kHeaderSize + blocks * kSummarySize + keys * kKeySize > file.size())
+        {
+            return false;
+        }
+        summaries = cursor;
+        keyTable = summaries + blocks * kSummarySize;
+        postingData = keyTable + keys * kKeySize;
+        return true;
+    }
+
+    std::uint64_t Catalog::gameCount() const
+    {
+        return games;
+    }
+
+    std::size_t Catalog::blockCount() const
+    {
+        return static_cast<std::size_t>(blocks);
+    }
+
+    BlockSummary Catalog::summary(std::size_t block) const
+    {
+        BlockSummary summary;
+        const char *cursor = summaries + block * kSummarySize;
+        for (std::uint32_t *value : {&summary.minRounds, &summary.maxRounds, &summary.minCollisions, &summary.maxCollisions, &summary.minMines,
+                 &summary.maxMines, &summary.outcomes[0], &summary.outcomes[1], &summary.outcomes[2]})
+        {
+            archive::getFixed(cursor, end, *value);
+        }
+        for (std::uint64_t &word : summary.bloom)
+        {
+            archive::getFixed(cursor, end, word);
+        }
+        return summary;
+    }
+
+    // binary search over the mapped key table
+    bool Catalog::findKey(std::uint64_t key, std::uint64_t &count, std::uint64_t &offset) const
+    {
+        std::uint64_t low = 0;
+        std::uint64_t high = keys;
+        while (low < high)
+        {
+            const std::uint64_t middle = low + (high - low) / 2;
+            const char *cursor = keyTable + middle * kKeySize;
+            std::uint64_t found = 0;
+            archive::getFixed(cursor, end, found);
+            if (found < key)
+            {
+                low = middle + 1;
+            }
+            else if (found > key)
+            {
+                high = middle;
+            }
+            else
+            {
+                return archive::getFixed(cursor, end, count) && archive::getFixed(cursor, end, offset);
+            }
+        }
+        return false;
+    }
+
+    std::uint64_t Catalog::postingCount(std::uint64_t key) const
+    {
+        std::uint64_t count = 0;
+        std::uint64_t offset = 0;
+        return findKey(key, count, offset) ? count : 0;
+    }
+
+    std::vector<std::uint64_t> Catalog::postings(std::uint64_t key) const
+    {
+        std::vector<std::uint64_t> ids;
+        std::uint64_t count = 0;
+        std::uint64_t offset = 0;
+        if (!findKey(key, count, offset) || offset > static_cast<std::uint64_t>(end - postingData) || count > static_cast<std::uint64_t>(end - postingData))
+        {
+            return ids;
+        }
+        const char *cursor = postingData + offset;
+        ids.reserve(count);
+        std::uint64_t game = 0;
+        for (std::uint64_t i = 0; i < count; ++i)
+        {
+            std::uint64_t delta = 0;
+            if (!archive::getVarint(cursor, end, delta))
+            {
+                break;
+            }
+            game += delta;
+            ids.push_back(game);
+        }
+        return ids;
+    }
+
+    Result Catalog::run(const Query &query, archive::Reader &reader) const
+    {
+        Result result;
+        result.blocks = blocks;
+        const std::vector<std::uint64_t> keys = keysOf(query);
+        const bool ranged = query.minRounds > 0 || query.maxRounds != Query::kAny || query.minCollisions > 0 || query.maxCollisions != Query::kAny;
+
+        std::vector<std::uint64_t> counts;
+        for (const std::uint64_t key : keys)
+        {
+            counts.push_back(postingCount(key));
+        }
+        const auto rarest = std::min_element(counts.begin(), counts.end());
+        // without ranges the posting lists answer exactly and no block is read
+        result.usedPostings = rarest != counts.end() && (!ranged || *rarest * kSelectiveShare <= games);
+
+        std::vector<sim::GameReplay> replays;
+        auto checkBlock = [&](std::size_t block, const std::uint64_t *first, const std::uint64_t *last)
+            {
+                result.blocksDecoded++;
+                if (!reader.readBlock(block, replays))
+                {
+                    return;
+                }
+                const std::uint64_t base = reader.block(block).firstReplay;
+                for (; first != last; ++first)
+                {
+                    if (matches(featuresOf(replays[*first - base]), query))
+                    {
+                        result.games.push_back(*first);
+                    }
+                }
+            };
+
+        if (result.usedPostings)
+        {
+            // the rarest list first, then every other one intersected into it
+            std::vector<std::uint64_t> candidates = postings(keys[rarest - counts.begin()]);
+            std::vector<std::uint64_t> other;
+            for (std::size_t k = 0; k < keys.size(); ++k)
+            {
+                if (k != static_cast<std::size_t>(rarest - counts.begin()))
+                {
+                    const std::vector<std::uint64_t> list = postings(keys[k]);
+                    other.clear();
+                    std::set_intersection(candidates.begin(), candidates.end(), list.begin(), list.end(), std::back_inserter(other));
+                    candidates.swap(other);
+                }
+            }
+            result.candidates = candidates.size();
+            if (!ranged)
+            {
+                result.games = std::move(candidates);
+                return result;
+            }
+
+            // the candidates of one block at a time, with blocks the ranges rule out skipped unread
+            std::size_t block = 0;
+            for (std::size_t i = 0; i < candidates.size();)
+            {
+                while (block + 1 < reader.blockCount() && reader.block(block + 1).firstReplay <= candidates[i])
+                {
+                    block++;
+                }
+                const std::uint64_t next = (block + 1 < reader.blockCount()) ? reader.block(block + 1).firstReplay : games;
+                std::size_t last = i;
+                while (last < candidates.size() && candidates[last] < next)
+                {
+                    last++;
+                }
+                const Coverage coverage = cover(summary(block), query, {});
+                if (coverage == Coverage::All)
+                {
+                    result.games.insert(result.games.end(), candidates.begin() + i, candidates.begin() + last);
+                }
+                else if (coverage == Coverage::Some)
+                {
+                    checkBlock(block, candidates.data() + i, candidates.data() + last);
+                }
+                i = last;
+            }
+            return result;
+        }
+
+        std::vector<std::uint64_t> ids;
+        for (std::size_t block = 0; block < blocks && block < reader.blockCount(); ++block)
+        {
+            const archive::BlockInfo &info = reader.block(block);
+            const Coverage coverage = cover(summary(block), query, keys);
+            if (coverage == Coverage::None)
+            {
+                continue;
+            }
+            result.candidates += info.replays;
+            ids.resize(info.replays);
+            for (std::uint32_t i = 0; i < info.replays; ++i)
+            {
+                ids[i] = info.firstReplay + i;
+            }
+            if (coverage == Coverage::All)
+            {
+                result.games.insert(result.games.end(), ids.begin(), ids.end());
+            }
+            else
+            {
+                checkBlock(block, ids.data(), ids.data() + ids.size());
+            }
+        }
+        return result;
+    }
+
+    std::ostream &operator<<(std::ostream &stream, const Result &result)
+    {
+        stream << result.games.size() << " games match; " << (result.usedPostings ? "posting lists" : "block summaries") << " left "
+               << result.candidates << " candidates, " << result.blocksDecoded << " of " << result.blocks << " blocks decoded\n";
+        return stream;
+    }
+}
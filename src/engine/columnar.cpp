@@ -0,0 +1,667 @@
+#include "minefield/engine/columnar.h"
+
+#include "minefield/engine/catalog.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <unordered_map>
+
+namespace columnar
+{
+    constexpr std::size_t kAlignment = 64;
+    constexpr const char *kColumnNames[kColumns] = {"seed", "width", "height", "mines", "rounds", "winner", "collisions"};
+    constexpr const char *kOutcomeNames[] = {"draw", "first", "second"}; // in sim::Outcome order
+
+    const char *columnName(Column column)
+    {
+        return kColumnNames[static_cast<std::size_t>(column)];
+    }
+
+    bool parseColumn(const std::string &name, Column &column)
+    {
+        const auto it = std::find(std::begin(kColumnNames), std::end(kColumnNames), name);
+        if (it == std::end(kColumnNames))
+        {
+            return false;
+        }
+        column = static_cast<Column>(it - std::begin(kColumnNames));
+        return true;
+    }
+
+    Row rowOf(const sim::GameReplay &replay)
+    {
+        const catalog::Features features = catalog::featuresOf(replay);
+        Row row;
+        row.seed = replay.first.seed;
+        row.width = features.width;
+        row.height = features.height;
+        row.mines = features.mines;
+        row.rounds = features.rounds;
+        row.winner = static_cast<std::uint8_t>(features.outcome);
+        row.collisions = features.collisions;
+        return row;
+    }
+
+    std::size_t paddedSize(std::size_t bytes)
+    {
+        return (bytes + kAlignment - 1) / kAlignment * kAlignment;
+    }
+
+    // bytes of a row group with the given rows, every column padded to the alignment
+    std::size_t groupSize(std::uint32_t rows)
+    {
+        return paddedSize(rows * sizeof(std::uint64_t)) + 5 * paddedSize(rows * sizeof(std::uint32_t)) + paddedSize(rows * sizeof(std::uint8_t));
+    }
+
+    Writer::Writer(const std::string &path)
+        : file(path, std::ios::binary | std::ios::trunc)
+    {
+        std::string header;
+        archive::putFixed(header, kMagic);
+        archive::putFixed(header, kVersion);
+        header.resize(kAlignment, '\0'); // the first row group starts aligned
+        file.write(header.data(), static_cast<std::streamsize>(header.size()));
+        offset = header.size();
+    }
+
+    bool Writer::add(const Row &row)
+    {
+        seeds.push_back(row.seed);
+        widths.push_back(row.width);
+        heights.push_back(row.height);
+        mines.push_back(row.mines);
+        rounds.push_back(row.rounds);
+        winners.push_back(row.winner);
+        collisions.push_back(row.collisions);
+        rows++;
+        return seeds.size() < kRowGroupRows || flushGroup();
+    }
+
+    template <typename T>
+    void Writer::writeColumn(const std::vector<T> &values)
+    {
+        // columns are written in host order, little-endian on every target the engine builds for
+        static const char kPadding[kAlignment] = {};
+        const std::size_t bytes = values.size() * sizeof(T);
+        file.write(reinterpret_cast<const char *>(values.data()), static_cast<std::streamsize>(bytes));
+        file.write(kPadding, static_cast<std::streamsize>(paddedSize(bytes) - bytes));
+    }
+
+    template <typename T>
+    void extent(const std::vector<T> &values, std::uint64_t &min, std::uint64_t &max)
+    {
+        const auto [low, high] = std::minmax_element(values.begin(), values.end());
+        min = *low;
+        max = *high;
+    }
+
+    bool Writer::flushGroup()
+    {
+        if (seeds.empty())
+        {
+            return static_cast<bool>(file);
+        }
+        GroupInfo info;
+        info.offset = offset;
+        info.rows = static_cast<std::uint32_t>(seeds.size());
+        extent(seeds, info.min[0], info.max[0]);
+        extent(widths, info.min[1], info.max[1]);
+        extent(heights, info.min[2], info.max[2]);
+        extent(mines, info.min[3], info.max[3]);
+        extent(rounds, info.min[4], info.max[4]);
+        extent(winners, info.min[5], info.max[5]);
+        extent(collisions, info.min[6], info.max[6]);
+        directory.push_back(info);
+
+        writeColumn(seeds);
+        writeColumn(widths);
+        writeColumn(heights);
+        writeColumn(mines);
+        writeColumn(rounds);
+        writeColumn(winners);
+        writeColumn(collisions);
+        offset += groupSize(info.rows);
+        for (auto *column : {&widths, &heights, &mines, &rounds, &collisions})
+        {
+            column->clear();
+        }
+        seeds.clear();
+        winners.clear();
+        return static_cast<bool>(file);
+    }
+
+    bool Writer::finish()
+    {
+        if (!flushGroup())
+        {
+            return false;
+        }
+        std::string tail;
+        for (const auto &info : directory)
+        {
+            archive::putFixed(tail, info.offset);
+            archive::putFixed(tail, info.rows);
+            for (std::size_t c = 0; c < kColumns; ++c)
+            {
+                archive::putFixed(tail, info.min[c]);
+                archive::putFixed(tail, info.max[c]);
+            }
+        }
+        archive::putFixed(tail, offset);
+        archive::putFixed(tail, static_cast<std::uint64_t>(directory.size()));
+        archive::putFixed(tail, rows);
+        archive::putFixed(tail, kMagic);
+        file.write(tail.data(), static_cast<std::streamsize>(tail.size()));
+        file.close();
+        return !file.fail();
+    }
+
+    std::uint64_t Writer::rowCount() const
+    {
+        return rows;
+    }
+
+    std::uint64_t RowGroup::value(Column column, std::size_t row) const
+    {
+        switch (column)
+        {
+        case Column::Seed:
+            return seed[row];
+        case Column::Width:
+            return width[row];
+        case Column::Height:
+            return height[row];
+        case Column::Mines:
+            return mines[row];
+        case Column::Rounds:
+            return rounds[row];
+        case Column::Winner:
+            return winner[row];
+        case Column::Collisions:
+            return collisions[row];
+        }
+        return 0;
+    }
+
+    bool Table::open(const std::string &path)
+    {
+        constexpr std::size_t kTrailer = 3 * sizeof(std::uint64_t) + sizeof(std::uint32_t);
+        constexpr std::size_t kEntry = sizeof(std::uint64_t) + sizeof(std::uint32_t) + 2 * kColumns * sizeof(std::uint64_t);
+
+        directory.clear();
+        rows = 0;
+        if (!file.open(path) || file.size() < kAlignment + kTrailer)
+        {
+            return false;
+        }
+        const char *begin = file.data();
+        const char *end = begin + file.size();
+        const char *cursor = end - kTrailer;
+        std::uint64_t directoryOffset = 0;
+        std::uint64_t groups = 0;
+        std::uint32_t magic = 0;
+        archive::getFixed(cursor, end, directoryOffset);
+        archive::getFixed(cursor, end, groups);
+        archive::getFixed(cursor, end, rows);
+        archive::getFixed(cursor, end, magic);
+        const std::uint64_t limit = file.size() - kTrailer;
+        // divided rather than multiplied, so that no group count read from the file can overflow
+        if (magic != kMagic || directoryOffset > limit || (limit - directoryOffset) % kEntry != 0 || groups != (limit - directoryOffset) / kEntry)
+        {
+            return false;
+        }
+
+        cursor = begin + directoryOffset;
+        directory.resize(groups);
+        std::uint64_t counted = 0;
+        for (auto &info : directory)
+        {
+            archive::getFixed(cursor, end, info.offset);
+            archive::getFixed(cursor, end, info.rows);
+            for (std::size_t c = 0; c < kColumns; ++c)
+            {
+                archive::getFixed(cursor, end, info.min[c]);
+                archive::getFixed(cursor, end, info.max[c]);
+            }
+            if (info.offset % kAlignment != 0 || info.rows > kRowGroupRows || info.offset > directoryOffset || groupSize(info.rows) > directoryOffset - info.offset)
+            {
+                return false;
+            }
+            counted += info.rows;
+        }
+
+        cursor = begin;
+        std::uint32_t version = 0;
+        return counted == rows && archive::getFixed(cursor, end, magic) && magic == kMagic && archive::getFixed(cursor, end, version) && version == kVersion;
+    }
+
+    std::uint64_t Table::rowCount() const
+    {
+        return rows;
+    }
+
+    std::size_t Table::groupCount() const
+    {
+        return directory.size();
+    }
+
+    const GroupInfo &Table::info(std::size_t group) const
+    {
+        return directory[group];
+    }
+
+    RowGroup Table::group(std::size_t index) const
+    {
+        const GroupInfo &info = directory[index];
+        const char *cursor = file.data() + info.offset;
+        const auto next = [&](std::size_t width)
+            {
+                const char *column = cursor;
+                cursor += paddedSize(info.rows * width);
+                return column;
+            };
+        RowGroup group;
+        group.rows = info.rows;
+        group.seed = reinterpret_cast<const std::uint64_t *>(next(sizeof(std::uint64_t)));
+        group.width = reinterpret_cast<const std::uint32_t *>(next(sizeof(std::uint32_t)));
+        group.height = reinterpret_cast<const std::uint32_t *>(next(sizeof(std::uint32_t)));
+        group.mines = reinterpret_cast<const std::uint32_t *>(next(sizeof(std::uint32_t)));
+        group.rounds = reinterpret_cast<const std::uint32_t *>(next(sizeof(std::uint32_t)));
+        group.winner = reinterpret_cast<const std::uint8_t *>(next(sizeof(std::uint8_t)));
+        group.collisions = reinterpret_cast<const std::uint32_t *>(next(sizeof(std::uint32_t)));
+        return group;
+    }
+
+    bool parsePredicate(const std::string &text, Predicate &predicate)
+    {
+        const std::size_t op = text.find_first_of("<>=");
+        if (op == std::string::npos || !parseColumn(text.substr(0, op), predicate.column))
+        {
+            return false;
+        }
+        std::size_t valueStart = op + 1;
+        const bool orEqual = valueStart < text.size() && text[valueStart] == '=';
+        valueStart += (text[op] != '=' && orEqual) ? 1 : 0;
+        const std::string valueText = text.substr(valueStart);
+
+        std::uint64_t value = 0;
+        const auto outcome = std::find(std::begin(kOutcomeNames), std::end(kOutcomeNames), valueText);
+        if (predicate.column == Column::Winner && outcome != std::end(kOutcomeNames))
+        {
+            value = static_cast<std::uint64_t>(outcome - std::begin(kOutcomeNames));
+        }
+        else if (valueText.empty() || valueText.find_first_not_of("0123456789") != std::string::npos)
+        {
+            return false;
+        }
+        else
+        {
+            value = std::stoull(valueText);
+        }
+
+        predicate.min = 0;
+        predicate.max = ~std::uint64_t{0};
+        switch (text[op])
+        {
+        case '=':
+            predicate.min = predicate.max = value;
+            return true;
+        case '<':
+            if (!orEqual && value == 0)
+            {
+                predicate.min = 1; // matches nothing
+                predicate.max = 0;
+                return true;
+            }
+            predicate.max = orEqual ? value : value - 1;
+            return true;
+        default:
+            if (!orEqual && value == ~std::uint64_t{0})
+            {
+                predicate.min = 1;
+                predicate.max = 0;
+                return true;
+            }
+            predicate.min = orEqual ? value : value + 1;
+            return true;
+        }
+    }
+
+    // mask[i] &= min <= values[i] <= max. Subtracting min wraps values below it around to the top, so one
+    // unsigned compare checks both ends and the loop has no branch left to keep it from vectorizing.
+    template <typename T>
+    void filterColumn(const T *values, std::size_t count, std::uint64_t min, std::uint64_t max, std::uint8_t *mask)
+    {
+        constexpr std::uint64_t kLargest = std::numeric_limits<T>::max();
+        if (min > kLargest || min > max)
+        {
+            std::fill(mask, mask + count, std::uint8_t{0});
+            return;
+        }
+        const T low = static_cast<T>(min);
+        const T span = static_cast<T>(std::min(max, kLargest) - min);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            mask[i] &= static_cast<std::uint8_t>(static_cast<T>(values[i] - low) <= span);
+        }
+    }
+
+    void filterBatch(const RowGroup &group, const Predicate &predicate, std::size_t first, std::size_t count, std::uint8_t *mask)
+    {
+        switch (predicate.column)
+        {
+        case Column::Seed:
+            filterColumn(group.seed + first, count, predicate.min, predicate.max, mask);
+            break;
+        case Column::Width:
+            filterColumn(group.width + first, count, predicate.min, predicate.max, mask);
+            break;
+        case Column::Height:
+            filterColumn(group.height + first, count, predicate.min, predicate.max, mask);
+            break;
+        case Column::Mines:
+            filterColumn(group.mines + first, count, predicate.min, predicate.max, mask);
+            break;
+        case Column::Rounds:
+            filterColumn(group.rounds + first, count, predicate.min, predicate.max, mask);
+            break;
+        case Column::Winner:
+            filterColumn(group.winner + first, count, predicate.min, predicate.max, mask);
+            break;
+        case Column::Collisions:
+            filterColumn(group.collisions + first, count, predicate.min, predicate.max, mask);
+            break;
+        }
+    }
+
+    using Key = std::array<std::uint64_t, kMaxGroupColumns>;
+
+    struct KeyHash
+    {
+        std::size_t operator()(const Key &key) const
+        {
+            std::uint64_t hash = 0;
+            for (const std::uint64_t value : key)
+            {
+                hash = (hash ^ value) * 0x9E3779B97F4A7C15ULL;
+                hash ^= hash >> 29;
+            }
+            return static_cast<std::size_t>(hash);
+        }
+    };
+
+    // the groups of one worker; recent remembers where the last keys went, since most rows of a batch fall
+    // into a handful of groups and a hit skips the hash map
+    struct Aggregator
+    {
+        static constexpr std::size_t kRecent = 64;
+
+        std::unordered_map<Key, Group, KeyHash> groups;
+        std::array<Group *, kRecent> recent{};
+        std::vector<Group> dense; // see DensePlan
+        std::uint64_t rowsScanned = 0;
+        std::uint64_t groupsSkipped = 0;
+
+        Group &find(const Key &key)
+        {
+            Group *&slot = recent[KeyHash()(key) % kRecent];
+            if (!slot || slot->key != key)
+            {
+                Group &group = groups[key];
+                group.key = key;
+                slot = &group; // nodes of an unordered_map never move
+            }
+            return *slot;
+        }
+    };
+
+    // Where the group-by columns of a row group span few values, rows aggregate into a dense array indexed
+    // by their mixed-radix key, and the array is folded into the hash map once per row group.
+    struct DensePlan
+    {
+        std::size_t slots = 0; // 0 when the keys are too spread out
+        std::array<std::uint64_t, kMaxGroupColumns> base{};
+        std::array<std::uint64_t, kMaxGroupColumns> radix{};
+    };
+
+    constexpr std::size_t kDenseSlots = 1024;
+
+    DensePlan planDense(const GroupInfo &info, const std::vector<Column> &groupBy)
+    {
+        DensePlan plan;
+        std::size_t slots = 1;
+        for (std::size_t c = 0; c < groupBy.size(); ++c)
+        {
+            const std::size_t column = static_cast<std::size_t>(groupBy[c]);
+            const std::uint64_t span = info.max[column] - info.min[column];
+            if (span >= kDenseSlots || slots * (span + 1) > kDenseSlots)
+            {
+                return plan;
+            }
+            plan.base[c] = info.min[column];
+            plan.radix[c] = span + 1;
+            slots *= span + 1;
+        }
+        plan.slots = slots;
+        return plan;
+    }
+
+    void addRow(Group &group, const RowGroup &rows, std::size_t row)
+    {
+        group.rows++;
+        group.outcomes[rows.winner[row] % 3]++;
+        group.rounds += rows.rounds[row];
+        group.collisions += rows.collisions[row];
+    }
+
+    // Late materialization: the group-by and aggregated columns are only read at the selected rows.
+    void aggregate(const RowGroup &group, const std::vector<Column> &groupBy, const DensePlan &plan, std::size_t first, const std::uint16_t *selection,
+        std::size_t selected, Aggregator &aggregator)
+    {
+        if (groupBy.empty())
+        {
+            Group &total = aggregator.find(Key{});
+            for (std::size_t s = 0; s < selected; ++s)
+            {
+                addRow(total, group, first + selection[s]);
+            }
+            return;
+        }
+        if (plan.slots > 0)
+        {
+            for (std::size_t s = 0; s < selected; ++s)
+            {
+                const std::size_t row = first + selection[s];
+                std::uint64_t slot = 0;
+                for (std::size_t c = 0; c < groupBy.size(); ++c)
+                {
+                    slot = slot * plan.radix[c] + (group.value(groupBy[c], row) - plan.base[c]);
+                }
+                addRow(aggregator.dense[slot], group, row);
+            }
+            return;
+        }
+        for (std::size_t s = 0; s < selected; ++s)
+        {
+            const std::size_t row = first + selection[s];
+            Key key{};
+            for (std::size_t c = 0; c < groupBy.size(); ++c)
+            {
+                key[c] = group.value(groupBy[c], row);
+            }
+            addRow(aggregator.find(key), group, row);
+        }
+    }
+
+    void foldDense(const DensePlan &plan, std::size_t columns, Aggregator &aggregator)
+    {
+        for (std::size_t slot = 0; slot < plan.slots; ++slot)
+        {
+            Group &partial = aggregator.dense[slot];
+            if (partial.rows == 0)
+            {
+                continue;
+            }
+            Key key{};
+            std::uint64_t rest = slot;
+            for (std::size_t c = columns; c-- > 0;)
+            {
+                key[c] = plan.base[c] + rest % plan.radix[c];
+                rest /= plan.radix[c];
+            }
+            Group &into = aggregator.find(key);
+            into.rows += partial.rows;
+            for (std::size_t o = 0; o < 3; ++o)
+            {
+                into.outcomes[o] += partial.outcomes[o];
+            }
+            into.rounds += partial.rounds;
+            into.collisions += partial.collisions;
+            partial = Group{};
+        }
+    }
+
+    void scanGroup(const Table &table, std::size_t index, const Query &query, Aggregator &aggregator)
+    {
+        const GroupInfo &info = table.info(index);
+
+        // the filters this group needs at all, after its min and max
+        std::vector<Predicate> active;
+        for (const Predicate &predicate : query.where)
+        {
+            const std::size_t c = static_cast<std::size_t>(predicate.column);
+            if (predicate.min > predicate.max || predicate.max < info.min[c] || predicate.min > info.max[c])
+            {
+                aggregator.groupsSkipped++;
+                return;
+            }
+            if (predicate.min > info.min[c] || predicate.max < info.max[c])
+            {
+                active.push_back(predicate);
+            }
+        }
+
+        const RowGroup group = table.group(index);
+        const DensePlan plan = planDense(info, query.groupBy);
+        aggregator.dense.resize(std::max(aggregator.dense.size(), plan.slots));
+        aggregator.rowsScanned += group.rows;
+        std::uint8_t mask[kBatchRows];
+        std::uint16_t selection[kBatchRows];
+        for (std::size_t first = 0; first < group.rows; first += kBatchRows)
+        {
+            const std::size_t count = std::min<std::size_t>(kBatchRows, group.rows - first);
+            std::fill(mask, mask + count, std::uint8_t{1});
+            for (const Predicate &predicate : active)
+            {
+                filterBatch(group, predicate, first, count, mask);
+            }
+            // branch-free compaction: every row is written, only the selected ones advance the cursor
+            std::size_t selected = 0;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                selection[selected] = static_cast<std::uint16_t>(i);
+                selected += mask[i];
+            }
+            aggregate(group, query.groupBy, plan, first, selection, selected, aggregator);
+        }
+        foldDense(plan, query.groupBy.size(), aggregator);
+    }
+
+    bool run(const Table &table, const Query &query, unsigned int workers, Result &result)
+    {
+        if (query.groupBy.size() > kMaxGroupColumns)
+        {
+            return false;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        workers = std::max(1U, std::min<unsigned int>(workers, static_cast<unsigned int>(std::max<std::size_t>(table.groupCount(), 1))));
+        std::vector<Aggregator> aggregators(workers);
+        std::atomic<std::size_t> next{0};
+        {
+            sim::WorkerPool pool(workers);
+            for (unsigned int w = 0; w < workers; ++w)
+            {
+                pool.submit([&, w]
+                    {
+                        for (std::size_t index = next++; index < table.groupCount(); index = next++)
+                        {
+                            scanGroup(table, index, query, aggregators[w]);
+                        }
+                    });
+            }
+            pool.wait();
+        }
+
+        result = Result{};
+        result.groupBy = query.groupBy;
+        result.rowGroups = table.groupCount();
+        std::map<Key, Group> merged;
+        for (const Aggregator &aggregator : aggregators)
+        {
+            result.rowsScanned += aggregator.rowsScanned;
+            result.groupsSkipped += aggregator.groupsSkipped;
+            for (const auto &[key, group] : aggregator.groups)
+            {
+                Group &into = merged[key];
+                into.key = key;
+                into.rows += group.rows;
+                for (std::size_t o = 0; o < 3; ++o)
+                {
+                    into.outcomes[o] += group.outcomes[o];
+                }
+                into.rounds += group.rounds;
+                into.collisions += group.collisions;
+            }
+        }
+        for (const auto &[key, group] : merged)
+        {
+            if (group.rows > 0)
+            {
+                result.rowsMatched += group.rows;
+                result.groups.push_back(group);
+            }
+        }
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return true;
+    }
+
+    std::ostream &operator<<(std::ostream &stream, const Result &result)
+    {
+        stream << "\n === QUERY RESULT === \n";
+        for (const Column column : result.groupBy)
+        {
+            stream << std::setw(11) << columnName(column);
+        }
+        stream << std::setw(13) << "games" << std::setw(13) << "first wins" << std::setw(13) << "second wins" << std::setw(9) << "draws"
+               << std::setw(13) << "mean rounds" << std::setw(17) << "mean collisions" << '\n';
+        for (const Group &group : result.groups)
+        {
+            for (std::size_t c = 0; c < result.groupBy.size(); ++c)
+            {
+                if (result.groupBy[c] == Column::Winner && group.key[c] < 3)
+                {
+                    stream << std::setw(11) << kOutcomeNames[group.key[c]];
+                }
+                else
+                {
+                    stream << std::setw(11) << group.key[c];
+                }
+            }
+            const double rows = static_cast<double>(group.rows);
+            stream << std::setw(13) << group.rows << std::fixed << std::setprecision(2) << std::setw(12) << 100.0 * group.outcomes[1] / rows << '%'
+                   << std::setw(12) << 100.0 * group.outcomes[2] / rows << '%' << std::setw(8) << 100.0 * group.outcomes[0] / rows << '%'
+                   << std::setw(13) << group.rounds / rows << std::setw(17) << group.collisions / rows << std::defaultfloat << '\n';
+        }
+        stream << result.rowsMatched << " of " << result.rowsScanned << " rows scanned matched, " << result.groupsSkipped << " of " << result.rowGroups
+               << " row groups skipped, " << result.seconds * 1000.0 << " ms";
+        if (result.seconds > 0.0)
+        {
+            stream << " (" << result.rowsScanned / result.seconds / 1e6 << " M rows/s)";
+        }
+        return stream << '\n';
+    }
+}
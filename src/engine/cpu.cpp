@@ -0,0 +1,62 @@
+#include "minefield/engine/cpu.h"
+
+#include "minefield/engine/utils.h"
+
+#include <algorithm>
+
+namespace cpu
+{
+    const char *strategyName(CpuStrategy strategy)
+    {
+        switch (strategy)
+        {
+        case CpuStrategy::Cautious:
+            return "cautious";
+        case CpuStrategy::Random:
+        default:
+            return "random";
+        }
+    }
+
+    bool parseStrategy(const std::string &name, CpuStrategy &strategy)
+    {
+        if (name == "random")
+        {
+            strategy = CpuStrategy::Random;
+            return true;
+        }
+        if (name == "cautious")
+        {
+            strategy = CpuStrategy::Cautious;
+            return true;
+        }
+        return false;
+    }
+
+    Position choosePlacement(CpuStrategy, const Player &, const Board &board, const std::vector<Position> &chosen, std::uint64_t decisionSeed, bool antithetic)
+    {
+        return utils::pickByKey(board, utils::collectFreeCells(board, chosen), decisionSeed, antithetic);
+    }
+
+    Position chooseGuess(CpuStrategy strategy, const Player &self, const Board &board, const std::vector<Position> &chosen, std::uint64_t decisionSeed, bool antithetic)
+    {
+        std::vector<Position> candidates = utils::collectFreeCells(board, chosen);
+        if (strategy == CpuStrategy::Cautious)
+        {
+            std::vector<Position> safe;
+            for (const auto &cell : candidates)
+            {
+                bool ownMine = std::any_of(self.currentMines.begin(), self.currentMines.end(), [&](const Position &p){ return utils::samePosition(p, cell); });
+                if (!ownMine)
+                {
+                    safe.push_back(cell);
+                }
+            }
+            if (!safe.empty())
+            {
+                candidates.swap(safe);
+            }
+        }
+        return utils::pickByKey(board, candidates, decisionSeed, antithetic);
+    }
+}
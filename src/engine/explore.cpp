@@ -0,0 +1,499 @@
+#include "minefield/engine/explore.h"
+
+#include "minefield/engine/game.h"
+#include "minefield/engine/player.h"
+#include "minefield/engine/utils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <limits>
+#include <memory>
+#include <mutex>
+
+namespace explore
+{
+    constexpr std::uint32_t kUnvisited = std::numeric_limits<std::uint32_t>::max();
+    constexpr std::size_t kStatesPerJob = 16;
+
+    const char *invariantName(Invariant invariant)
+    {
+        switch (invariant)
+        {
+        case Invariant::MineUnderflow:
+            return "mine count underflow";
+        case Invariant::RemainingMismatch:
+            return "remaining mines mismatch";
+        case Invariant::DisabledShrank:
+            return "disabled cell freed";
+        case Invariant::CollisionImbalance:
+            return "collision imbalance";
+        case Invariant::NoProgress:
+            return "round without progress";
+        case Invariant::Count:
+        default:
+            return "unknown";
+        }
+    }
+
+    std::uint64_t choose(unsigned int n, unsigned int k)
+    {
+        if (k > n)
+        {
+            return 0;
+        }
+        std::uint64_t result = 1;
+        for (unsigned int i = 1; i <= k; ++i)
+        {
+            result = result * (n - k + i) / i;
+        }
+        return result;
+    }
+
+    // Two seats picking x1 and x2 of the n cells of a class, o of them the same: the first seat takes the first
+    // x1 cells, the second the first o of those and the x2 - o after them. Every pair of picks with these
+    // counts is this one with the class's cells relabeled; multiplicity says how many there are.
+    struct SharedPick
+    {
+        unsigned int x1 = 0;
+        unsigned int x2 = 0;
+        unsigned int o = 0;
+
+        std::uint64_t multiplicity(unsigned int n) const
+        {
+            return choose(n, x1) * choose(x1, o) * choose(n - x1, x2 - o);
+        }
+
+        void append(const std::vector<Position> &cells, std::vector<Position> &first, std::vector<Position> &second) const
+        {
+            first.insert(first.end(), cells.begin(), cells.begin() + x1);
+            second.insert(second.end(), cells.begin(), cells.begin() + o);
+            second.insert(second.end(), cells.begin() + x1, cells.begin() + x1 + x2 - o);
+        }
+    };
+
+    // calls onPick with every pick of x1 and x2 cells with overlap o out of a class of n
+    template <typename OnPickFnT>
+    bool forEachSharedPick(unsigned int n, unsigned int maxX1, unsigned int maxX2, OnPickFnT onPick)
+    {
+        for (unsigned int x1 = 0; x1 <= std::min(n, maxX1); ++x1)
+        {
+            for (unsigned int x2 = 0; x2 <= std::min(n, maxX2); ++x2)
+            {
+                for (unsigned int o = (x1 + x2 > n) ? x1 + x2 - n : 0; o <= std::min(x1, x2); ++o)
+                {
+                    if (!onPick(SharedPick{x1, x2, o}))
+                    {
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    class Explorer
+    {
+    public:
+        explicit Explorer(const Settings &settings)
+            : settings(settings)
+            , width(settings.config.width)
+            , height(settings.config.height)
+            , cells(width * height)
+            , mines(settings.config.mines)
+            , parents(new std::atomic<std::uint32_t>[static_cast<std::size_t>(mines + 1) * (mines + 1) * (cells + 1)])
+        {
+            const std::size_t size = static_cast<std::size_t>(mines + 1) * (mines + 1) * (cells + 1);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                parents[i].store(kUnvisited, std::memory_order_relaxed);
+            }
+        }
+
+        Report run()
+        {
+            Report report;
+            report.config = settings.config;
+            const std::uint32_t root = indexOf({0, mines, mines});
+            parents[root].store(root, std::memory_order_relaxed);
+            std::vector<std::uint32_t> frontier = {root};
+            sim::WorkerPool pool(settings.workers);
+
+            unsigned int level = 0;
+            while (!frontier.empty() && !stop.load())
+            {
+                report.states += frontier.size();
+                report.depth = level;
+                std::vector<std::uint32_t> next;
+                std::mutex nextMutex;
+                for (std::size_t first = 0; first < frontier.size(); first += kStatesPerJob)
+                {
+                    const std::size_t last = std::min(frontier.size(), first + kStatesPerJob);
+                    pool.submit([&, first, last]
+                        {
+                            std::vector<std::uint32_t> found;
+                            for (std::size_t i = first; i < last && !stop.load(std::memory_order_relaxed); ++i)
+                            {
+                                expand(frontier[i], found);
+                            }
+                            std::lock_guard<std::mutex> lock(nextMutex);
+                            next.insert(next.end(), found.begin(), found.end());
+                        });
+                }
+                pool.wait();
+                frontier.swap(next);
+                level++;
+            }
+
+            report.complete = !stop.load();
+            report.moveClasses = moveClasses.load();
+            report.transitions = transitions.load();
+            for (int i = 0; i < 3; ++i)
+            {
+                report.finalStates[i] = finalStates[i].load();
+            }
+            for (std::size_t i = 0; i < report.violations.size(); ++i)
+            {
+                report.violations[i] = violations[i].load();
+            }
+            for (const auto &found : recorded)
+            {
+                Violation violation;
+                violation.invariant = found.invariant;
+                violation.move = found.move;
+                for (std::uint32_t index = found.from;; index = parents[index].load())
+                {
+                    violation.trace.push_back(stateOf(index));
+                    if (parents[index].load() == index)
+                    {
+                        break;
+                    }
+                }
+                std::reverse(violation.trace.begin(), violation.trace.end());
+                report.traces.push_back(violation);
+            }
+            return report;
+        }
+
+    private:
+        struct Recorded
+        {
+            Invariant invariant;
+            std::uint32_t from;
+            Move move;
+        };
+
+        // a state is its disabled cell count and the mines of both seats; it is played on the board whose
+        // lowest cells are the disabled ones
+        std::uint32_t indexOf(const State &state) const
+        {
+            return (state.mines1 * (mines + 1) + state.mines2) * (cells + 1) + static_cast<std::uint32_t>(std::popcount(state.disabled));
+        }
+
+        State stateOf(std::uint32_t index) const
+        {
+            const std::uint32_t counts = index / (cells + 1);
+            const std::uint32_t disabled = index % (cells + 1);
+            return {(disabled >= 32) ? ~0U : (1U << disabled) - 1, counts / (mines + 1), counts % (mines + 1)};
+        }
+
+        std::uint32_t maskOf(const std::vector<Position> &positions) const
+        {
+            std::uint32_t mask = 0;
+            for (const auto &position : positions)
+            {
+                mask |= 1U << (position.column * height + position.row);
+            }
+            return mask;
+        }
+
+        std::uint32_t disabledOf(const Board &board) const
+        {
+            std::uint32_t mask = 0;
+            for (unsigned int cell = 0; cell < cells; ++cell)
+            {
+                if (hasFlag(board.cells()[cell], CellStatusFlags::Disabled))
+                {
+                    mask |= 1U << cell;
+                }
+            }
+            return mask;
+        }
+
+        std::vector<Position> cellsOf(std::uint32_t mask) const
+        {
+            std::vector<Position> found;
+            for (unsigned int cell = 0; cell < cells; ++cell)
+            {
+                if ((mask >> cell) & 1)
+                {
+                    found.push_back({cell / height, cell % height});
+                }
+            }
+            return found;
+        }
+
+        void violate(Invariant invariant, std::uint64_t weight, std::uint32_t from, const std::vector<Position> *placed, const std::vector<Position> *guessed)
+        {
+            violations[static_cast<std::size_t>(invariant)] += weight;
+            if (traceSlots.fetch_add(1, std::memory_order_relaxed) < settings.maxTraces)
+            {
+                std::lock_guard<std::mutex> lock(recordMutex);
+                Recorded found = {invariant, from, {}};
+                for (int seat = 0; seat < 2; ++seat)
+                {
+                    found.move.mines[seat] = placed[seat];
+                    if (guessed)
+                    {
+                        found.move.guesses[seat] = guessed[seat];
+                    }
+                }
+                recorded.push_back(found);
+            }
+        }
+
+        void visit(std::uint32_t from, const State &state, std::vector<std::uint32_t> &found)
+        {
+            const std::uint32_t index = indexOf(state);
+            std::uint32_t expected = kUnvisited;
+            if (parents[index].compare_exchange_strong(expected, from, std::memory_order_relaxed))
+            {
+                found.push_back(index);
+            }
+        }
+
+        // Every legal round from a state, one move class at a time. The rules see a cell only through its flags
+        // and whose positions list it, so relabeling cells that agree on both maps moves onto moves with the same
+        // outcome. Placements differ only in how many cells the seats share, and guesses only in how many cells
+        // each seat picks among the first seat's mines, the second seat's and the empty cells, and how many of
+        // those both pick. One representative of each class is played by game::* and counted with its size.
+        void expand(std::uint32_t from, std::vector<std::uint32_t> &found)
+        {
+            const State state = stateOf(from);
+            const std::vector<Position> free = cellsOf(~state.disabled & ((cells >= 32) ? ~0U : (1U << cells) - 1));
+            if (state.mines1 == 0 || state.mines2 == 0 || free.empty())
+            {
+                finalStates[(state.mines1 > state.mines2) ? 0 : (state.mines1 == state.mines2) ? 1 : 2]++;
+                return;
+            }
+
+            Board start = sim::makeBoard(settings.config);
+            for (const auto &cell : cellsOf(state.disabled))
+            {
+                utils::safeCellAccess(start, cell.column, cell.row, [](CellStatusFlags &status){ status |= CellStatusFlags::Disabled; });
+            }
+            Board placedBoard = start;
+            Board guessedBoard = start;
+            Player seats[2] = {makePlayer(false, "CPU 1", 0), makePlayer(false, "CPU 2", 0)};
+            Player after[2] = {seats[0], seats[1]};
+            std::vector<Position> placed[2];
+            std::vector<Position> guessed[2];
+
+            // every placement of both seats, as sim::placeAndGuess counts them
+            const unsigned int count1 = std::min<unsigned int>(state.mines1, static_cast<unsigned int>(free.size()));
+            const unsigned int count2 = std::min<unsigned int>(state.mines2, static_cast<unsigned int>(free.size()));
+            forEachSharedPick(static_cast<unsigned int>(free.size()), count1, count2, [&](const SharedPick &placement)
+                {
+                    if (placement.x1 != count1 || placement.x2 != count2)
+                    {
+                        return true;
+                    }
+                    const std::uint64_t placements = placement.multiplicity(static_cast<unsigned int>(free.size()));
+                    placed[0].clear();
+                    placed[1].clear();
+                    placement.append(free, placed[0], placed[1]);
+
+                    placedBoard = start;
+                    for (int seat = 0; seat < 2; ++seat)
+                    {
+                        seats[seat].remainingMines = seat ? state.mines2 : state.mines1;
+                        seats[seat].currentMines = placed[seat];
+                    }
+                    for (const auto &list : placed)
+                    {
+                        for (const auto &mine : list)
+                        {
+                            utils::safeCellAccess(placedBoard, mine.column, mine.row, [](CellStatusFlags &status){ status |= CellStatusFlags::HasMine; });
+                        }
+                    }
+                    game::detectAndRemoveCollisions(seats[0], seats[1], placedBoard, utils::nullStream());
+                    const unsigned int collisions = static_cast<unsigned int>(std::popcount(maskOf(placed[0]) & maskOf(placed[1])));
+                    if (state.mines1 - seats[0].remainingMines != collisions || state.mines2 - seats[1].remainingMines != collisions
+                        || seats[0].currentMines.size() + collisions != placed[0].size() || seats[1].currentMines.size() + collisions != placed[1].size())
+                    {
+                        violate(Invariant::CollisionImbalance, placements, from, placed, nullptr);
+                    }
+
+                    const std::uint32_t collided = disabledOf(placedBoard);
+                    const std::uint32_t mines1 = maskOf(seats[0].currentMines);
+                    const std::uint32_t mines2 = maskOf(seats[1].currentMines);
+                    const std::uint32_t open = ~collided & ((cells >= 32) ? ~0U : (1U << cells) - 1);
+                    // the classes guesses tell apart: the first seat's mines, the second seat's, and empty cells
+                    const std::vector<Position> classes[3] = {cellsOf(open & mines1), cellsOf(open & mines2), cellsOf(open & ~mines1 & ~mines2)};
+                    const unsigned int openCount = static_cast<unsigned int>(std::popcount(open));
+                    const unsigned int guesses1 = std::min(seats[1].remainingMines, openCount);
+                    const unsigned int guesses2 = std::min(seats[0].remainingMines, openCount);
+                    const unsigned int sizes[3] = {static_cast<unsigned int>(classes[0].size()), static_cast<unsigned int>(classes[1].size()),
+                        static_cast<unsigned int>(classes[2].size())};
+
+                    // every split of both seats' guesses over the classes
+                    return forEachSharedPick(sizes[0], guesses1, guesses2, [&](const SharedPick &onFirst)
+                        {
+                            return forEachSharedPick(sizes[1], guesses1 - onFirst.x1, guesses2 - onFirst.x2, [&](const SharedPick &onSecond)
+                                {
+                                    return forEachSharedPick(sizes[2], guesses1 - onFirst.x1 - onSecond.x1, guesses2 - onFirst.x2 - onSecond.x2, [&](const SharedPick &onEmpty)
+                                        {
+                                            if (onFirst.x1 + onSecond.x1 + onEmpty.x1 != guesses1 || onFirst.x2 + onSecond.x2 + onEmpty.x2 != guesses2)
+                                            {
+                                                return true;
+                                            }
+                                            const std::uint64_t weight = placements * onFirst.multiplicity(sizes[0]) * onSecond.multiplicity(sizes[1]) * onEmpty.multiplicity(sizes[2]);
+                                            guessed[0].clear();
+                                            guessed[1].clear();
+                                            onFirst.append(classes[0], guessed[0], guessed[1]);
+                                            onSecond.append(classes[1], guessed[0], guessed[1]);
+                                            onEmpty.append(classes[2], guessed[0], guessed[1]);
+
+                                            guessedBoard = placedBoard;
+                                            for (int seat = 0; seat < 2; ++seat)
+                                            {
+                                                after[seat].remainingMines = seats[seat].remainingMines;
+                                                after[seat].currentMines = seats[seat].currentMines;
+                                                after[seat].currentGuesses = guessed[seat];
+                                            }
+                                            game::resolveGuesses(after[0], after[1], guessedBoard, utils::nullStream());
+                                            check(from, weight, state, collided, seats, after, mines1, mines2, placed, guessed, guessedBoard, found);
+                                            transitions.fetch_add(weight, std::memory_order_relaxed);
+                                            if (moveClasses.fetch_add(1, std::memory_order_relaxed) + 1 >= settings.maxMoveClasses)
+                                            {
+                                                stop.store(true);
+                                            }
+                                            return !stop.load(std::memory_order_relaxed);
+                                        });
+                                });
+                        });
+                });
+        }
+
+        void check(std::uint32_t from, std::uint64_t weight, const State &state, std::uint32_t collided, const Player seats[2], const Player after[2], std::uint32_t mines1,
+            std::uint32_t mines2, const std::vector<Position> *placed, const std::vector<Position> *guessed, const Board &board, std::vector<std::uint32_t> &found)
+        {
+            const std::uint32_t guesses1 = maskOf(guessed[0]);
+            const std::uint32_t guesses2 = maskOf(guessed[1]);
+            // a mine is lost to each guess on it, the opponent's and its owner's alike
+            const unsigned int losses[2] = {
+                static_cast<unsigned int>(std::popcount(guesses2 & mines1) + std::popcount(guesses1 & mines1)),
+                static_cast<unsigned int>(std::popcount(guesses1 & mines2) + std::popcount(guesses2 & mines2))};
+            for (int seat = 0; seat < 2; ++seat)
+            {
+                if (losses[seat] > seats[seat].remainingMines)
+                {
+                    violate(Invariant::MineUnderflow, weight, from, placed, guessed);
+                }
+                else if (after[seat].remainingMines != seats[seat].remainingMines - losses[seat])
+                {
+                    violate(Invariant::RemainingMismatch, weight, from, placed, guessed);
+                }
+            }
+
+            const State next = {disabledOf(board), after[0].remainingMines, after[1].remainingMines};
+            if ((next.disabled & state.disabled) != state.disabled || (next.disabled & collided) != collided)
+            {
+                violate(Invariant::DisabledShrank, weight, from, placed, guessed);
+            }
+            const bool finished = next.mines1 == 0 || next.mines2 == 0 || static_cast<unsigned int>(std::popcount(next.disabled)) == cells;
+            if (!finished && next.disabled == state.disabled)
+            {
+                violate(Invariant::NoProgress, weight, from, placed, guessed);
+            }
+            visit(from, next, found);
+        }
+
+        const Settings &settings;
+        const unsigned int width;
+        const unsigned int height;
+        const unsigned int cells;
+        const unsigned int mines;
+        std::unique_ptr<std::atomic<std::uint32_t>[]> parents; // kUnvisited, or the state a state was first reached from
+
+        std::atomic<bool> stop{false};
+        std::atomic<std::uint64_t> moveClasses{0};
+        std::atomic<std::uint64_t> transitions{0};
+        std::atomic<std::uint64_t> finalStates[3] = {};
+        std::array<std::atomic<std::uint64_t>, static_cast<std::size_t>(Invariant::Count)> violations{};
+        std::atomic<std::uint64_t> traceSlots{0};
+        std::mutex recordMutex;
+        std::vector<Recorded> recorded;
+    };
+
+    Report exploreStates(const Settings &settings)
+    {
+        Settings bounded = settings;
+        bounded.config.width = std::clamp<unsigned int>(settings.config.width, Board::kMinSize, Board::kMaxSize);
+        bounded.config.height = std::clamp<unsigned int>(settings.config.height, Board::kMinSize, Board::kMaxSize);
+        bounded.config.mines = std::clamp<unsigned int>(settings.config.mines, Board::kMinMines, Board::kMaxMines);
+        Explorer explorer(bounded);
+        return explorer.run();
+    }
+
+    void printPositions(std::ostream &stream, const std::vector<Position> &positions)
+    {
+        stream << '[';
+        for (std::size_t i = 0; i < positions.size(); ++i)
+        {
+            stream << (i ? " " : "") << '(' << positions[i].column + 1 << ',' << positions[i].row + 1 << ')';
+        }
+        stream << ']';
+    }
+
+    std::ostream &operator<<(std::ostream &stream, const Report &report)
+    {
+        const unsigned int height = report.config.height;
+        stream << "\n === STATE SPACE " << report.config.width << "x" << height << ", " << report.config.mines << " mines === \n";
+        stream << "states: " << report.states << " (up to relabeling cells), transitions: " << report.transitions << " in " << report.moveClasses
+               << " move classes, longest game: " << report.depth << " rounds\n";
+        stream << "final states - first seat ahead: " << report.finalStates[0] << ", draws: " << report.finalStates[1] << ", second seat ahead: " << report.finalStates[2] << '\n';
+        if (!report.complete)
+        {
+            stream << "search stopped at the move class limit, the counts above are partial\n";
+        }
+        std::uint64_t total = 0;
+        for (std::size_t i = 0; i < report.violations.size(); ++i)
+        {
+            total += report.violations[i];
+            stream << invariantName(static_cast<Invariant>(i)) << ": " << report.violations[i] << '\n';
+        }
+        if (total == 0)
+        {
+            stream << "all invariants hold\n";
+        }
+        for (std::size_t v = 0; v < report.traces.size(); ++v)
+        {
+            const Violation &violation = report.traces[v];
+            stream << "\ncounterexample " << v + 1 << ": " << invariantName(violation.invariant) << '\n';
+            for (std::size_t round = 0; round < violation.trace.size(); ++round)
+            {
+                const State &state = violation.trace[round];
+                std::vector<Position> disabled;
+                for (std::uint32_t bits = state.disabled; bits; bits &= bits - 1)
+                {
+                    const unsigned int cell = static_cast<unsigned int>(std::countr_zero(bits));
+                    disabled.push_back({cell / height, cell % height});
+                }
+                stream << "  round " << round + 1 << ": mines " << state.mines1 << '/' << state.mines2 << ", disabled ";
+                printPositions(stream, disabled);
+                stream << '\n';
+            }
+            stream << "  mines ";
+            printPositions(stream, violation.move.mines[0]);
+            stream << " / ";
+            printPositions(stream, violation.move.mines[1]);
+            stream << ", guesses ";
+            printPositions(stream, violation.move.guesses[0]);
+            stream << " / ";
+            printPositions(stream, violation.move.guesses[1]);
+            stream << '\n';
+        }
+        return stream;
+    }
+}
@@ -0,0 +1,182 @@
+#include "minefield/engine/fog.h"
+
+#include <algorithm>
+#include <iomanip>
+
+namespace fog
+{
+    Views::Views(const Board &board, unsigned int seats)
+        : width(board.getWidth())
+        , height(board.getHeight())
+        , seats(seats)
+        , words((static_cast<std::size_t>(width) * height + 63) / 64)
+        , bits((kFirstOwn + seats) * words, 0)
+    {
+        for (unsigned int c = 0; c < width; ++c)
+        {
+            for (unsigned int r = 0; r < height; ++r)
+            {
+                const CellStatusFlags status = board.getCellStatus(c, r);
+                const std::size_t index = cellIndex(c, r);
+                assign(kDisabled, index, hasFlag(status, CellStatusFlags::Disabled));
+                assign(kGuessed, index, hasFlag(status, CellStatusFlags::WasGuessed));
+                assign(kSelfDetonated, index, hasFlag(status, CellStatusFlags::SelfDetonated));
+                assign(kCollided, index, hasFlag(status, CellStatusFlags::HadCollision));
+            }
+        }
+    }
+
+    std::size_t Views::cellIndex(unsigned int col, unsigned int row) const
+    {
+        return static_cast<std::size_t>(col) * height + row;
+    }
+
+    std::uint64_t *Views::planeWords(std::size_t plane)
+    {
+        return bits.data() + plane * words;
+    }
+
+    const std::uint64_t *Views::planeWords(std::size_t plane) const
+    {
+        return bits.data() + plane * words;
+    }
+
+    bool Views::test(std::size_t plane, std::size_t index) const
+    {
+        return (planeWords(plane)[index / 64] >> (index % 64)) & 1;
+    }
+
+    void Views::assign(std::size_t plane, std::size_t index, bool value)
+    {
+        const std::uint64_t bit = std::uint64_t{1} << (index % 64);
+        std::uint64_t &word = planeWords(plane)[index / 64];
+        word = value ? (word | bit) : (word & ~bit);
+    }
+
+    void Views::beginRound()
+    {
+        std::fill(bits.begin() + kRevealed * words, bits.end(), 0);
+    }
+
+    void Views::placeMines(unsigned int seat, const std::vector<Position> &mines)
+    {
+        if (seat >= seats)
+        {
+            return;
+        }
+        for (const auto &mine : mines)
+        {
+            if (mine.column < width && mine.row < height)
+            {
+                assign(kFirstOwn + seat, cellIndex(mine.column, mine.row), true);
+            }
+        }
+    }
+
+    void Views::refresh(const Board &board, const std::vector<Position> &cells)
+    {
+        for (const auto &cell : cells)
+        {
+            if (cell.column >= width || cell.row >= height)
+            {
+                continue;
+            }
+            const CellStatusFlags status = board.getCellStatus(cell.column, cell.row);
+            const std::size_t index = cellIndex(cell.column, cell.row);
+            const bool hasMine = hasFlag(status, CellStatusFlags::HasMine);
+            assign(kDisabled, index, hasFlag(status, CellStatusFlags::Disabled));
+            assign(kGuessed, index, hasFlag(status, CellStatusFlags::WasGuessed));
+            assign(kSelfDetonated, index, hasFlag(status, CellStatusFlags::SelfDetonated));
+            assign(kCollided, index, hasFlag(status, CellStatusFlags::HadCollision));
+            assign(kRevealed, index, hasMine && hasFlag(status, CellStatusFlags::WasGuessed));
+            if (!hasMine)
+            {
+                for (unsigned int seat = 0; seat < seats; ++seat)
+                {
+                    assign(kFirstOwn + seat, index, false);
+                }
+            }
+        }
+    }
+
+    CellStatusFlags Views::cellFor(unsigned int seat, unsigned int col, unsigned int row) const
+    {
+        if (col >= width || row >= height)
+        {
+            return CellStatusFlags::None;
+        }
+        const std::size_t index = cellIndex(col, row);
+        CellStatusFlags status = CellStatusFlags::None;
+        if (test(kDisabled, index))
+        {
+            status |= CellStatusFlags::Disabled;
+        }
+        if (test(kGuessed, index))
+        {
+            status |= CellStatusFlags::WasGuessed;
+        }
+        if (test(kSelfDetonated, index))
+        {
+            status |= CellStatusFlags::SelfDetonated;
+        }
+        if (test(kCollided, index))
+        {
+            status |= CellStatusFlags::HadCollision;
+        }
+        if (test(kRevealed, index) || ownsMine(seat, col, row))
+        {
+            status |= CellStatusFlags::HasMine;
+        }
+        return status;
+    }
+
+    bool Views::ownsMine(unsigned int seat, unsigned int col, unsigned int row) const
+    {
+        return seat < seats && col < width && row < height && test(kFirstOwn + seat, cellIndex(col, row));
+    }
+
+    std::size_t Views::getWords() const
+    {
+        return words;
+    }
+
+    std::uint64_t Views::freeCells(std::size_t word) const
+    {
+        // bits past the last cell are never free
+        const std::size_t cells = static_cast<std::size_t>(width) * height;
+        const std::uint64_t valid = (word + 1 < words || cells % 64 == 0) ? ~std::uint64_t{0} : (std::uint64_t{1} << (cells % 64)) - 1;
+        return ~planeWords(kDisabled)[word] & valid;
+    }
+
+    std::uint64_t Views::ownMines(unsigned int seat, std::size_t word) const
+    {
+        return (seat < seats) ? planeWords(kFirstOwn + seat)[word] : 0;
+    }
+
+    std::uint64_t Views::safeGuesses(unsigned int seat, std::size_t word) const
+    {
+        return freeCells(word) & ~ownMines(seat, word);
+    }
+
+    void Views::render(std::ostream &stream, unsigned int seat) const
+    {
+        stream << "\n === BOARD === \n   ";
+        for (unsigned int c = 0; c < width; ++c)
+        {
+            stream << std::setw(3) << c + 1;
+        }
+        stream << '\n';
+
+        for (unsigned int r = 0; r < height; ++r)
+        {
+            stream << std::setw(3) << r + 1;
+            for (unsigned int c = 0; c < width; ++c)
+            {
+                const char symbol = getSymbolForStatus(cellFor(seat, c, r));
+                stream << std::setw(3) << ((symbol == '.' && ownsMine(seat, c, r)) ? 'M' : symbol);
+            }
+            stream << '\n';
+        }
+        stream << '\n';
+    }
+}
@@ -0,0 +1,455 @@
+#include "minefield/engine/game.h"
+
+#include "minefield/engine/fog.h"
+#include "minefield/engine/parallel.h"
+#include "minefield/engine/utils.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+namespace game
+{
+    void collectPositions(Player &player, int count, Board &board, std::vector<Position> &targetList, const std::string &prompt, bool showCpuMessage, bool markMinesOnBoard)
+    {
+        targetList.clear();
+        std::string phaseLabel;
+
+        if (prompt == "Guess position")
+        {
+            phaseLabel = "GUESSING";
+        }
+        else
+        {
+            phaseLabel = "PLACEMENT";
+        }
+
+        std::cout << "\n === " << phaseLabel << " PHASE === \n === TURN: " << player.name << " ===\n\n";
+
+        while (targetList.size() < static_cast<size_t>(count))
+        {
+            Position pos;
+            if (player.isHuman)
+            {
+                pos = utils::requestPosition(prompt, board);
+            }
+            else
+            {
+                pos = utils::generateRandomPosition(board);
+            }
+            bool repeated = std::any_of(targetList.begin(), targetList.end(), [&](const Position &p){ return utils::samePosition(p, pos); });
+            if (!repeated)
+            {
+                targetList.push_back(pos);
+                if (markMinesOnBoard)
+                {
+                    utils::safeCellAccess(board, pos.column, pos.row, [](CellStatusFlags &status){ status |= CellStatusFlags::HasMine; });
+                }
+                if (!player.isHuman && showCpuMessage)
+                {
+                    std::cout << "CPU " << (markMinesOnBoard ? "places mine" : "guesses") << " at (" << pos.column + 1 << ", " << pos.row + 1 << ")\n";
+                }
+            }
+            else
+            {
+                if (player.isHuman)
+                {
+                    std::cout << "\nInvalid move! Position already chosen. Please choose another.\n";
+                }
+            }
+        }
+    }
+
+    void placeMines(Player &player, int quantity, Board &board)
+    {
+        collectPositions(player, quantity, board, player.currentMines, "\nMine location", true, true);
+    }
+
+    void collectGuessesFromPlayer(Player &player, int opponentMines, Board &board)
+    {
+        collectPositions(player, opponentMines, board, player.currentGuesses, "\nGuess position", true, false);
+    }
+
+    void detectAndRemoveCollisions(Player &p1, Player &p2, Board &board, std::ostream &out)
+    {
+        std::vector<Position> collisions;
+
+        std::vector<Position> newMines1 = utils::removeCollidingMines(p1.currentMines, p2.currentMines, collisions, board);
+        std::vector<Position> newMines2 = utils::keepNonCollidingMines(p2.currentMines, p1.currentMines);
+
+        int removedByP1 = p1.currentMines.size() - newMines1.size();
+        int removedByP2 = p2.currentMines.size() - newMines2.size();
+
+        p1.currentMines = newMines1;
+        p2.currentMines = newMines2;
+
+        p1.remainingMines = (p1.remainingMines >= removedByP1) ? p1.remainingMines - removedByP1 : 0;
+        p2.remainingMines = (p2.remainingMines >= removedByP2) ? p2.remainingMines - removedByP2 : 0;
+
+        for (const auto &colPos : collisions)
+        {
+            out << "\n === MINE COLLISION IN (" << colPos.column + 1 << ", " << colPos.row + 1 << ") ===\n";
+        }
+        if (!collisions.empty())
+        {
+            out << "\nMines removed - " << p1.name << ": " << removedByP1 << ", " << p2.name << ": " << removedByP2 << '\n';
+        }
+    }
+
+    void clearMines(Board &board)
+    {
+        parallel::forChunks(board.getWidth(), board.getHeight(), [&board](unsigned int, std::size_t first, std::size_t last)
+            {
+                for (std::size_t c = first; c < last; ++c)
+                {
+                    for (unsigned int r = 0; r < board.getHeight(); ++r)
+                    {
+                        utils::safeCellAccess(board, static_cast<unsigned int>(c), r, [](CellStatusFlags &status){ status = status & ~CellStatusFlags::HasMine; });
+                    }
+                }
+            });
+    }
+
+    int countHits(const Player &defender, const std::vector<Position> &attacks)
+    {
+        int hits = 0;
+        for (const auto &guess : attacks)
+        {
+            for (const auto &mine : defender.currentMines)
+            {
+                if (utils::samePosition(guess, mine))
+                {
+                    hits++;
+                    break;
+                }
+            }
+        }
+        return hits;
+    }
+
+    int resolveSelfDetonation(Player &player, Board &board, std::ostream &out)
+    {
+        int selfHits = 0;
+        std::vector<Position> updatedMines;
+
+        for (const auto &mine : player.currentMines)
+        {
+            bool destroyed = false;
+            for (const auto &guess : player.currentGuesses)
+            {
+                if (utils::samePosition(mine, guess))
+                {
+                    destroyed = true;
+                    break;
+                }
+            }
+
+            if (destroyed)
+            {
+                selfHits++;
+                utils::safeCellAccess(board, mine.column, mine.row, [](CellStatusFlags &status)
+                    {
+                        status |= CellStatusFlags::Disabled;
+                        status |= CellStatusFlags::SelfDetonated;
+                        status = status & ~CellStatusFlags::HasMine;
+                    });
+                out << player.name << " exploded their own mine at (" << (mine.column + 1) << ", " << (mine.row + 1) << ")!\n";
+            }
+            else
+            {
+                updatedMines.push_back(mine);
+            }
+        }
+        player.currentMines = updatedMines;
+        return selfHits;
+    }
+
+    void disableGuessedPositions(const std::vector<Position> &guesses, Board &board)
+    {
+        for (const auto &guess : guesses)
+        {
+            utils::safeCellAccess(board, guess.column, guess.row, [](CellStatusFlags &status){ status |= CellStatusFlags::Disabled | CellStatusFlags::WasGuessed; });
+        }
+    }
+
+    // Mines and self-guesses by cell for resolveGuesses. Entries hold the round's stamp above four bits: a mine
+    // of player 1, a mine of player 2, and each player guessing their own mine there. Entries from older rounds
+    // read as empty, so nothing is cleared between rounds; the index is per thread and only grows.
+    class MineIndex
+    {
+    public:
+        static constexpr std::uint32_t kMine[2] = {0x1, 0x2};
+        static constexpr std::uint32_t kSelfGuess[2] = {0x4, 0x8};
+
+        void reset(std::size_t cells)
+        {
+            if (entries.size() < cells || stamp == kLastStamp)
+            {
+                entries.assign(std::max(cells, entries.size()), 0);
+                stamp = 0;
+            }
+            stamp += 1U << kStampShift;
+        }
+
+        std::uint32_t bits(std::size_t cell) const
+        {
+            const std::uint32_t entry = entries[cell];
+            return ((entry & ~kBits) == stamp) ? entry & kBits : 0;
+        }
+
+        void set(std::size_t cell, std::uint32_t bit)
+        {
+            entries[cell] = stamp | bits(cell) | bit;
+        }
+
+    private:
+        static constexpr unsigned int kStampShift = 4;
+        static constexpr std::uint32_t kBits = (1U << kStampShift) - 1;
+        static constexpr std::uint32_t kLastStamp = ~kBits;
+
+        std::vector<std::uint32_t> entries;
+        std::uint32_t stamp = 0;
+    };
+
+    GuessTotals resolveGuesses(Player &p1, Player &p2, Board &board, std::ostream &out)
+    {
+        thread_local MineIndex index;
+        Player *players[2] = {&p1, &p2};
+        const unsigned int height = board.getHeight();
+        auto cellOf = [&board, height](const Position &position)
+        {
+            return board.isValidPosition(position.column, position.row) ? static_cast<std::size_t>(position.column) * height + position.row : std::size_t(-1);
+        };
+
+        // positions outside the board match nothing here, the pairwise scans compared them all the same
+        auto offBoard = [&board](const std::vector<Position> &positions)
+        {
+            return std::any_of(positions.begin(), positions.end(), [&board](const Position &p){ return !board.isValidPosition(p.column, p.row); });
+        };
+        if (offBoard(p1.currentMines) || offBoard(p2.currentMines) || offBoard(p1.currentGuesses) || offBoard(p2.currentGuesses))
+        {
+            GuessTotals totals;
+            totals.hits[0] = static_cast<unsigned int>(countHits(p2, p1.currentGuesses));
+            totals.hits[1] = static_cast<unsigned int>(countHits(p1, p2.currentGuesses));
+            p2.remainingMines = (p2.remainingMines >= totals.hits[0]) ? p2.remainingMines - totals.hits[0] : 0;
+            p1.remainingMines = (p1.remainingMines >= totals.hits[1]) ? p1.remainingMines - totals.hits[1] : 0;
+            for (int seat = 0; seat < 2; ++seat)
+            {
+                totals.selfHits[seat] = static_cast<unsigned int>(resolveSelfDetonation(*players[seat], board, out));
+                players[seat]->remainingMines = (players[seat]->remainingMines >= totals.selfHits[seat]) ? players[seat]->remainingMines - totals.selfHits[seat] : 0;
+            }
+            disableGuessedPositions(p1.currentGuesses, board);
+            disableGuessedPositions(p2.currentGuesses, board);
+            return totals;
+        }
+
+        index.reset(static_cast<std::size_t>(board.getWidth()) * height);
+        for (int seat = 0; seat < 2; ++seat)
+        {
+            for (const auto &mine : players[seat]->currentMines)
+            {
+                index.set(cellOf(mine), MineIndex::kMine[seat]);
+            }
+        }
+
+        // the single pass over the guesses: hits, self-guesses and the guessed flags
+        GuessTotals totals;
+        for (int seat = 0; seat < 2; ++seat)
+        {
+            for (const auto &guess : players[seat]->currentGuesses)
+            {
+                const std::size_t cell = cellOf(guess);
+                const std::uint32_t bits = index.bits(cell);
+                if (bits & MineIndex::kMine[1 - seat])
+                {
+                    totals.hits[seat]++;
+                }
+                if (bits & MineIndex::kMine[seat])
+                {
+                    index.set(cell, MineIndex::kSelfGuess[seat]);
+                }
+                utils::safeCellAccess(board, guess.column, guess.row, [](CellStatusFlags &status){ status |= CellStatusFlags::Disabled | CellStatusFlags::WasGuessed; });
+            }
+        }
+        p2.remainingMines = (p2.remainingMines >= totals.hits[0]) ? p2.remainingMines - totals.hits[0] : 0;
+        p1.remainingMines = (p1.remainingMines >= totals.hits[1]) ? p1.remainingMines - totals.hits[1] : 0;
+
+        // surviving mines are compacted in place, in their original order
+        for (int seat = 0; seat < 2; ++seat)
+        {
+            Player &player = *players[seat];
+            std::size_t kept = 0;
+            for (std::size_t i = 0; i < player.currentMines.size(); ++i)
+            {
+                const Position mine = player.currentMines[i];
+                if (index.bits(cellOf(mine)) & MineIndex::kSelfGuess[seat])
+                {
+                    totals.selfHits[seat]++;
+                    utils::safeCellAccess(board, mine.column, mine.row, [](CellStatusFlags &status)
+                        {
+                            status |= CellStatusFlags::Disabled;
+                            status |= CellStatusFlags::SelfDetonated;
+                            status = status & ~CellStatusFlags::HasMine;
+                        });
+                    out << player.name << " exploded their own mine at (" << (mine.column + 1) << ", " << (mine.row + 1) << ")!\n";
+                }
+                else
+                {
+                    player.currentMines[kept++] = mine;
+                }
+            }
+            player.currentMines.resize(kept);
+            player.remainingMines = (player.remainingMines >= totals.selfHits[seat]) ? player.remainingMines - totals.selfHits[seat] : 0;
+        }
+        return totals;
+    }
+
+    bool checkGameEnd(const Player &p1, const Player &p2, std::ostream &out)
+    {
+        if (p1.remainingMines <= 0 && p2.remainingMines <= 0)
+        {
+            out << "\n=========================\n=== DRAW: NO MINES ===\n=========================\n";
+            return true;
+        }
+        else if (p1.remainingMines <= 0)
+        {
+            out << "\n==================================\n=== " << p2.name << " WIN THE GAME! ===\n==================================\n";
+            return true;
+        }
+        else if (p2.remainingMines <= 0)
+        {
+            out << "\n==================================\n=== " << p1.name << " WIN THE GAME! ===\n==================================\n";
+            return true;
+        }
+        return false;
+    }
+
+    void runMainLoop(Player &p1, Player &p2, Board &board)
+    {
+        int round = 1;
+        bool finished = false;
+
+        // against the CPU the board shows the human's own mines; two humans share the screen, so it shows neither
+        fog::Views views(board);
+        const unsigned int viewer = (p1.isHuman && !p2.isHuman) ? 0 : fog::Views::kSpectator;
+
+        while (!finished)
+        {
+            std::cout << "\n===============\n=== ROUND " << round << " ===\n===============\n";
+            views.render(std::cout, viewer);
+
+            clearMines(board);
+            views.beginRound();
+            placeMines(p1, p1.remainingMines, board);
+            views.placeMines(0, p1.currentMines);
+            placeMines(p2, p2.remainingMines, board);
+            views.placeMines(1, p2.currentMines);
+            const std::vector<Position> placed = p2.currentMines; // every collided cell holds one of these
+            detectAndRemoveCollisions(p1, p2, board);
+            views.refresh(board, placed);
+
+            collectGuessesFromPlayer(p1, p2.remainingMines, board);
+            collectGuessesFromPlayer(p2, p1.remainingMines, board);
+
+            resolveGuesses(p1, p2, board);
+            views.refresh(board, p1.currentGuesses);
+            views.refresh(board, p2.currentGuesses);
+
+            std::cout << "\n=== ROUND " << round << " RESULTS ===\n";
+            views.render(std::cout, viewer);
+            std::cout << p1.name << " - Remaining mines: " << p1.remainingMines << "\n";
+            std::cout << p2.name << " - Remaining mines: " << p2.remainingMines << "\n";
+
+            finished = checkGameEnd(p1, p2);
+            round++;
+        }
+        std::cout << "\n=== GAME OVER ===\n";
+    }
+
+    bool chooseGameMode(bool &exitChosen)
+    {
+        unsigned int option = 0;
+        exitChosen = false;
+
+        while (option != 1 && option != 2 && option != 3)
+        {
+            std::cout << "1. Player vs CPU\n2. Player 1 vs Player 2\n3. Exit Game\n> ";
+            std::cin >> option;
+
+            if (std::cin.fail())
+            {
+                utils::clearInput();
+                option = 0;
+            }
+
+            if (option != 1 && option != 2 && option != 3)
+            {
+                std::cout << "\nInvalid option. Enter 1, 2, or 3.\n";
+            }
+        }
+
+        if (option == 3)
+        {
+            exitChosen = true;
+            return false;
+        }
+        else if (option == 1)
+        {
+            return true;
+        }
+        else // option == 2
+        {
+            return false;
+        }
+    }
+
+    int chooseMineCount(const Board &board)
+    {
+        unsigned int mines = 0;
+        bool validInput = false;
+
+        while (!validInput)
+        {
+            std::cout << "Choose the number of mines between " << Board::kMinMines << " and " << Board::kMaxMines << ".\n> ";
+            std::cin >> mines;
+
+            bool failedInput = std::cin.fail();
+            bool outOfRange = !board.isValidMineCount(mines);
+
+            if (failedInput)
+            {
+                std::cout << "Invalid input. Please enter a number.\n";
+                utils::clearInput();
+                mines = 0;
+            }
+            else if (outOfRange)
+            {
+                std::cout << "Invalid input. Please enter a value between " << Board::kMinMines << " and " << Board::kMaxMines << ".\n";
+            }
+            else
+            {
+                validInput = true;
+            }
+        }
+        return mines;
+    }
+
+    bool askPlayAgain()
+    {
+        const char YES = 'y';
+        const char NO = 'n';
+        char option = '\0';
+
+        std::cout << "Do you want to play again? (" << YES << "/" << NO << ")\n> ";
+        std::cin >> option;
+
+        while (std::cin.fail() || (option != YES && option != NO))
+        {
+            std::cout << "Invalid entry. Enter '" << YES << "' for <YES> or '" << NO << "' for <NO> \n> ";
+            utils::clearInput();
+            std::cin >> option;
+        }
+        return option == YES;
+    }
+}
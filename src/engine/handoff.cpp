@@ -0,0 +1,189 @@
+#include "minefield/engine/handoff.h"
+
+#include "minefield/engine/net.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace handoff
+{
+    void ImageWriter::bytes(const void *data, std::size_t size)
+    {
+        image.append(static_cast<const char *>(data), size);
+    }
+
+    void ImageWriter::text(const std::string &value)
+    {
+        this->value(static_cast<std::uint64_t>(value.size()));
+        bytes(value.data(), value.size());
+    }
+
+    const std::string &ImageWriter::data() const
+    {
+        return image;
+    }
+
+    ImageReader::ImageReader(const char *data, std::size_t size)
+        : data(data)
+        , size(size)
+    {
+    }
+
+    const char *ImageReader::view(std::size_t length)
+    {
+        if (length > size - offset)
+        {
+            return nullptr;
+        }
+        const char *first = data + offset;
+        offset += length;
+        return first;
+    }
+
+    bool ImageReader::bytes(void *target, std::size_t length)
+    {
+        const char *source = view(length);
+        if (!source)
+        {
+            return false;
+        }
+        std::memcpy(target, source, length);
+        return true;
+    }
+
+    bool ImageReader::text(std::string &value)
+    {
+        std::uint64_t length = 0;
+        const char *source = nullptr;
+        if (!this->value(length) || !(source = view(length)))
+        {
+            return false;
+        }
+        value.assign(source, length);
+        return true;
+    }
+
+#ifndef _WIN32
+    std::string channelPath(const std::string &address)
+    {
+        std::string host;
+        std::string port;
+        return net::isTcpAddress(address, host, port) ? "/tmp/minefield-api-" + port + ".handoff" : address + ".handoff";
+    }
+
+    int publish(const std::string &image)
+    {
+        const std::string name = "/minefield-handoff-" + std::to_string(getpid());
+        const int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd < 0)
+        {
+            return -1;
+        }
+        shm_unlink(name.c_str());
+        void *memory = MAP_FAILED;
+        if (ftruncate(fd, static_cast<off_t>(image.size())) != 0
+            || (!image.empty() && (memory = mmap(nullptr, image.size(), PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED))
+        {
+            close(fd);
+            return -1;
+        }
+        if (!image.empty())
+        {
+            std::memcpy(memory, image.data(), image.size());
+            munmap(memory, image.size());
+        }
+        return fd;
+    }
+
+    const char *map(int fd, std::size_t &size)
+    {
+        struct stat info = {};
+        if (fstat(fd, &info) != 0 || info.st_size <= 0)
+        {
+            return nullptr;
+        }
+        size = static_cast<std::size_t>(info.st_size);
+        void *memory = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        return (memory == MAP_FAILED) ? nullptr : static_cast<const char *>(memory);
+    }
+
+    void release(const char *data, std::size_t size)
+    {
+        munmap(const_cast<char *>(data), size);
+    }
+
+    // each message is the number of descriptors it carries, the descriptors riding along as ancillary data
+    constexpr std::uint32_t kBatch = 200;
+
+    bool sendDescriptors(int channel, const std::vector<int> &fds)
+    {
+        const std::uint64_t total = fds.size();
+        if (!net::sendAll(channel, reinterpret_cast<const char *>(&total), sizeof(total)))
+        {
+            return false;
+        }
+        alignas(cmsghdr) char control[CMSG_SPACE(kBatch * sizeof(int))];
+        for (std::size_t first = 0; first < fds.size(); first += kBatch)
+        {
+            std::uint32_t count = static_cast<std::uint32_t>(std::min<std::size_t>(kBatch, fds.size() - first));
+            iovec payload = {&count, sizeof(count)};
+            msghdr message = {};
+            message.msg_iov = &payload;
+            message.msg_iovlen = 1;
+            message.msg_control = control;
+            message.msg_controllen = CMSG_SPACE(count * sizeof(int));
+            cmsghdr *header = CMSG_FIRSTHDR(&message);
+            header->cmsg_level = SOL_SOCKET;
+            header->cmsg_type = SCM_RIGHTS;
+            header->cmsg_len = CMSG_LEN(count * sizeof(int));
+            std::memcpy(CMSG_DATA(header), fds.data() + first, count * sizeof(int));
+            if (sendmsg(channel, &message, 0) != static_cast<ssize_t>(sizeof(count)))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool receiveDescriptors(int channel, std::vector<int> &fds)
+    {
+        std::uint64_t total = 0;
+        if (recv(channel, &total, sizeof(total), MSG_WAITALL) != static_cast<ssize_t>(sizeof(total)))
+        {
+            return false;
+        }
+        alignas(cmsghdr) char control[CMSG_SPACE(kBatch * sizeof(int))];
+        while (fds.size() < total)
+        {
+            std::uint32_t count = 0;
+            iovec payload = {&count, sizeof(count)};
+            msghdr message = {};
+            message.msg_iov = &payload;
+            message.msg_iovlen = 1;
+            message.msg_control = control;
+            message.msg_controllen = sizeof(control);
+            if (recvmsg(channel, &message, MSG_WAITALL) != static_cast<ssize_t>(sizeof(count)) || (message.msg_flags & MSG_CTRUNC))
+            {
+                return false;
+            }
+            const cmsghdr *header = CMSG_FIRSTHDR(&message);
+            if (!header || header->cmsg_level != SOL_SOCKET || header->cmsg_type != SCM_RIGHTS || header->cmsg_len != CMSG_LEN(count * sizeof(int)))
+            {
+                return false;
+            }
+            const std::size_t first = fds.size();
+            fds.resize(first + count);
+            std::memcpy(fds.data() + first, CMSG_DATA(header), count * sizeof(int));
+        }
+        return true;
+    }
+#endif
+}
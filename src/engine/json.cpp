@@ -0,0 +1,678 @@
+#include "minefield/engine/json.h"
+
+#include <algorithm>
+#include <charconv>
+#include <new>
+
+namespace json
+{
+    constexpr unsigned int kMaxDepth = 64;
+
+    Writer::Writer(char *buffer, std::size_t capacity, std::string *queue)
+        : buffer(buffer)
+        , capacity(capacity)
+        , queue(queue)
+        , start(queue ? queue->size() : 0)
+    {
+    }
+
+    bool Writer::flush()
+    {
+        if (!queue)
+        {
+            return false;
+        }
+        try
+        {
+            queue->append(buffer, used);
+        }
+        catch (const std::bad_alloc &)
+        {
+            return false;
+        }
+        used = 0;
+        return true;
+    }
+
+    bool Writer::reserve(std::size_t bytes)
+    {
+        if (!queue)
+        {
+            return true; // a plain writer never allocates
+        }
+        try
+        {
+            queue->reserve(queue->size() + used + bytes);
+        }
+        catch (const std::bad_alloc &)
+        {
+            return false;
+        }
+        return true;
+    }
+
+    void Writer::put(char ch)
+    {
+        if (used == capacity && !flush())
+        {
+            error = true;
+            return;
+        }
+        buffer[used++] = ch;
+    }
+
+    void Writer::put(const char *text, std::size_t length)
+    {
+        while (length > 0)
+        {
+            if (used == capacity && !flush())
+            {
+                error = true;
+                return;
+            }
+            const std::size_t chunk = std::min(length, capacity - used);
+            std::copy(text, text + chunk, buffer + used);
+            used += chunk;
+            text += chunk;
+            length -= chunk;
+        }
+    }
+
+    // comma before every element of a container but the first; a value right after its key needs none
+    void Writer::separate()
+    {
+        if (afterKey)
+        {
+            afterKey = false;
+            return;
+        }
+        if (depth == 0)
+        {
+            return;
+        }
+        const std::uint64_t bit = 1ULL << (depth - 1);
+        if (hasElements & bit)
+        {
+            put(',');
+        }
+        hasElements |= bit;
+    }
+
+    void Writer::escaped(std::string_view text)
+    {
+        constexpr char kHex[] = "0123456789abcdef";
+        std::size_t plain = 0;
+        for (std::size_t i = 0; i < text.size(); ++i)
+        {
+            const unsigned char ch = static_cast<unsigned char>(text[i]);
+            if (ch >= 0x20 && ch != '"' && ch != '\\')
+            {
+                continue;
+            }
+            put(text.data() + plain, i - plain);
+            plain = i + 1;
+            const char escape[] = {'\\', 'u', '0', '0', kHex[ch >> 4], kHex[ch & 0xF]};
+            switch (ch)
+            {
+            case '"':
+            case '\\':
+                put('\\');
+                put(static_cast<char>(ch));
+                break;
+            case '\n':
+                put("\\n", 2);
+                break;
+            case '\t':
+                put("\\t", 2);
+                break;
+            case '\r':
+                put("\\r", 2);
+                break;
+            default:
+                put(escape, sizeof(escape));
+                break;
+            }
+        }
+        put(text.data() + plain, text.size() - plain);
+    }
+
+    Writer &Writer::beginObject()
+    {
+        separate();
+        put('{');
+        if (++depth > kMaxDepth)
+        {
+            error = true;
+            depth = kMaxDepth;
+        }
+        hasElements &= ~(1ULL << (depth - 1));
+        return *this;
+    }
+
+    Writer &Writer::endObject()
+    {
+        put('}');
+        depth = (depth > 0) ? depth - 1 : 0;
+        return *this;
+    }
+
+    Writer &Writer::beginArray()
+    {
+        separate();
+        put('[');
+        if (++depth > kMaxDepth)
+        {
+            error = true;
+            depth = kMaxDepth;
+        }
+        hasElements &= ~(1ULL << (depth - 1));
+        return *this;
+    }
+
+    Writer &Writer::endArray()
+    {
+        put(']');
+        depth = (depth > 0) ? depth - 1 : 0;
+        return *this;
+    }
+
+    Writer &Writer::key(std::string_view name)
+    {
+        separate();
+        put('"');
+        escaped(name);
+        put("\":", 2);
+        afterKey = true;
+        return *this;
+    }
+
+    Writer &Writer::value(std::string_view text)
+    {
+        separate();
+        put('"');
+        escaped(text);
+        put('"');
+        return *this;
+    }
+
+    Writer &Writer::value(const char *text)
+    {
+        return value(std::string_view(text));
+    }
+
+    Writer &Writer::value(std::uint64_t number)
+    {
+        separate();
+        char digits[20];
+        const std::to_chars_result written = std::to_chars(digits, digits + sizeof(digits), number);
+        put(digits, static_cast<std::size_t>(written.ptr - digits));
+        return *this;
+    }
+
+    Writer &Writer::value(unsigned int number)
+    {
+        return value(static_cast<std::uint64_t>(number));
+    }
+
+    Writer &Writer::value(bool flag)
+    {
+        separate();
+        if (flag)
+        {
+            put("true", 4);
+        }
+        else
+        {
+            put("false", 5);
+        }
+        return *this;
+    }
+
+    Writer &Writer::beginString()
+    {
+        separate();
+        put('"');
+        return *this;
+    }
+
+    Writer &Writer::endString()
+    {
+        put('"');
+        return *this;
+    }
+
+    bool Writer::finish()
+    {
+        put('\n');
+        if (queue && !error && !flush())
+        {
+            error = true;
+        }
+        if (queue)
+        {
+            if (error)
+            {
+                queue->resize(start); // never leave half a message for the reader
+            }
+            start = queue->size();
+        }
+        return !error;
+    }
+
+    void Writer::reset()
+    {
+        if (queue)
+        {
+            queue->resize(start);
+        }
+        used = 0;
+        error = false;
+        afterKey = false;
+        depth = 0;
+        hasElements = 0;
+    }
+
+    bool Writer::failed() const
+    {
+        return error;
+    }
+
+    std::size_t Writer::size() const
+    {
+        return used;
+    }
+
+    const char *Writer::data() const
+    {
+        return buffer;
+    }
+
+    void writeBoard(Writer &writer, const Board &board)
+    {
+        constexpr char kDigits[] = "0123456789abcdefghijklmnopqrstuv";
+        static_assert(static_cast<CellFlagsType>(CellStatusFlags::HadCollision) < 32, "every flag combination must fit one digit");
+
+        writer.key("width").value(board.getWidth());
+        writer.key("height").value(board.getHeight());
+        writer.key("cells").beginString();
+        const CellStatusFlags *cells = board.cells();
+        const std::size_t total = static_cast<std::size_t>(board.getWidth()) * board.getHeight();
+        char chunk[512];
+        for (std::size_t first = 0; first < total; first += sizeof(chunk))
+        {
+            const std::size_t count = std::min(sizeof(chunk), total - first);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                chunk[i] = kDigits[static_cast<CellFlagsType>(cells[first + i]) & 0x1F];
+            }
+            writer.put(chunk, count);
+        }
+        writer.endString();
+    }
+
+    Document::Document(Token *tokens, std::size_t capacity)
+        : tokens(tokens)
+        , capacity(capacity)
+    {
+    }
+
+    bool Document::parse(char *input, std::size_t size)
+    {
+        text = input;
+        length = size;
+        count = 0;
+        depth = 0;
+        std::size_t position = 0;
+        skipSpace(position);
+        if (!parseValue(position))
+        {
+            return false;
+        }
+        skipSpace(position);
+        return position == length;
+    }
+
+    std::uint32_t Document::root() const
+    {
+        return 0;
+    }
+
+    const Token &Document::token(std::uint32_t index) const
+    {
+        return tokens[index];
+    }
+
+    std::uint32_t Document::find(std::uint32_t object, std::string_view key) const
+    {
+        if (object >= count || tokens[object].type != TokenType::Object)
+        {
+            return 0;
+        }
+        std::uint32_t member = object + 1;
+        for (std::uint32_t i = 0; i < tokens[object].children; ++i)
+        {
+            if (string(member) == key)
+            {
+                return member + 1;
+            }
+            member = tokens[member + 1].end;
+        }
+        return 0;
+    }
+
+    std::uint32_t Document::firstChild(std::uint32_t container) const
+    {
+        return (tokens[container].children > 0) ? container + 1 : 0;
+    }
+
+    std::uint32_t Document::nextSibling(std::uint32_t index) const
+    {
+        return tokens[index].end;
+    }
+
+    std::string_view Document::string(std::uint32_t index) const
+    {
+        const Token &value = tokens[index];
+        return (value.type == TokenType::String) ? std::string_view(text + value.start, value.length) : std::string_view();
+    }
+
+    bool Document::number(std::uint32_t index, std::uint64_t &value) const
+    {
+        const Token &number = tokens[index];
+        if (number.type != TokenType::Number)
+        {
+            return false;
+        }
+        const char *first = text + number.start;
+        const char *last = first + number.length;
+        const std::from_chars_result parsed = std::from_chars(first, last, value);
+        return parsed.ec == std::errc() && parsed.ptr == last;
+    }
+
+    void Document::skipSpace(std::size_t &position) const
+    {
+        while (position < length && (text[position] == ' ' || text[position] == '\t' || text[position] == '\n' || text[position] == '\r'))
+        {
+            position++;
+        }
+    }
+
+    bool Document::push(std::uint32_t &index)
+    {
+        if (count == capacity)
+        {
+            return false;
+        }
+        index = static_cast<std::uint32_t>(count++);
+        tokens[index] = Token{};
+        return true;
+    }
+
+    bool Document::parseValue(std::size_t &position)
+    {
+        if (position >= length)
+        {
+            return false;
+        }
+        std::uint32_t index = 0;
+        const char opening = text[position];
+        if (opening == '{' || opening == '[')
+        {
+            const bool object = (opening == '{');
+            const char closing = object ? '}' : ']';
+            if (!push(index) || ++depth > kMaxDepth)
+            {
+                return false;
+            }
+            tokens[index].type = object ? TokenType::Object : TokenType::Array;
+            tokens[index].start = static_cast<std::uint32_t>(position);
+            position++;
+            skipSpace(position);
+            if (position < length && text[position] == closing)
+            {
+                position++;
+            }
+            else
+            {
+                while (true)
+                {
+                    skipSpace(position);
+                    if (object)
+                    {
+                        std::uint32_t key = 0;
+                        if (position >= length || text[position] != '"' || !push(key) || !parseString(position, tokens[key]))
+                        {
+                            return false;
+                        }
+                        tokens[key].end = key + 1;
+                        skipSpace(position);
+                        if (position >= length || text[position] != ':')
+                        {
+                            return false;
+                        }
+                        position++;
+                        skipSpace(position);
+                    }
+                    if (!parseValue(position))
+                    {
+                        return false;
+                    }
+                    tokens[index].children++;
+                    skipSpace(position);
+                    if (position < length && text[position] == ',')
+                    {
+                        position++;
+                        continue;
+                    }
+                    if (position < length && text[position] == closing)
+                    {
+                        position++;
+                        break;
+                    }
+                    return false;
+                }
+            }
+            depth--;
+            tokens[index].length = static_cast<std::uint32_t>(position) - tokens[index].start;
+            tokens[index].end = static_cast<std::uint32_t>(count);
+            return true;
+        }
+
+        if (!push(index))
+        {
+            return false;
+        }
+        tokens[index].end = index + 1;
+        switch (opening)
+        {
+        case '"':
+            return parseString(position, tokens[index]);
+        case 't':
+            return parseLiteral(position, "true", TokenType::True);
+        case 'f':
+            return parseLiteral(position, "false", TokenType::False);
+        case 'n':
+            return parseLiteral(position, "null", TokenType::Null);
+        default:
+            return parseNumber(position, tokens[index]);
+        }
+    }
+
+    // unescapes into the text itself; the decoded string is never longer than its escaped form
+    bool Document::parseString(std::size_t &position, Token &token)
+    {
+        token.type = TokenType::String;
+        position++;
+        const std::size_t start = position;
+        std::size_t write = position;
+        while (position < length)
+        {
+            const char ch = text[position];
+            if (ch == '"')
+            {
+                token.start = static_cast<std::uint32_t>(start);
+                token.length = static_cast<std::uint32_t>(write - start);
+                position++;
+                return true;
+            }
+            if (static_cast<unsigned char>(ch) < 0x20)
+            {
+                return false;
+            }
+            if (ch != '\\')
+            {
+                text[write++] = ch;
+                position++;
+                continue;
+            }
+            if (position + 1 >= length)
+            {
+                return false;
+            }
+            const char escape = text[position + 1];
+            position += 2;
+            switch (escape)
+            {
+            case '"':
+            case '\\':
+            case '/':
+                text[write++] = escape;
+                break;
+            case 'b':
+                text[write++] = '\b';
+                break;
+            case 'f':
+                text[write++] = '\f';
+                break;
+            case 'n':
+                text[write++] = '\n';
+                break;
+            case 'r':
+                text[write++] = '\r';
+                break;
+            case 't':
+                text[write++] = '\t';
+                break;
+            case 'u':
+            {
+                auto readHex = [&](std::uint32_t &code)
+                {
+                    if (position + 4 > length)
+                    {
+                        return false;
+                    }
+                    const std::from_chars_result parsed = std::from_chars(text + position, text + position + 4, code, 16);
+                    position += 4;
+                    return parsed.ptr == text + position;
+                };
+                std::uint32_t code = 0;
+                if (!readHex(code))
+                {
+                    return false;
+                }
+                // a high surrogate must be followed by the escaped low one
+                if (code >= 0xD800 && code < 0xDC00)
+                {
+                    std::uint32_t low = 0;
+                    if (position + 2 > length || text[position] != '\\' || text[position + 1] != 'u')
+                    {
+                        return false;
+                    }
+                    position += 2;
+                    if (!readHex(low) || low < 0xDC00 || low >= 0xE000)
+                    {
+                        return false;
+                    }
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                }
+                if (code < 0x80)
+                {
+                    text[write++] = static_cast<char>(code);
+                }
+                else if (code < 0x800)
+                {
+                    text[write++] = static_cast<char>(0xC0 | (code >> 6));
+                    text[write++] = static_cast<char>(0x80 | (code & 0x3F));
+                }
+                else if (code < 0x10000)
+                {
+                    text[write++] = static_cast<char>(0xE0 | (code >> 12));
+                    text[write++] = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    text[write++] = static_cast<char>(0x80 | (code & 0x3F));
+                }
+                else
+                {
+                    text[write++] = static_cast<char>(0xF0 | (code >> 18));
+                    text[write++] = static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+                    text[write++] = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    text[write++] = static_cast<char>(0x80 | (code & 0x3F));
+                }
+                break;
+            }
+            default:
+                return false;
+            }
+        }
+        return false;
+    }
+
+    bool Document::parseNumber(std::size_t &position, Token &token)
+    {
+        auto digits = [&]()
+        {
+            const std::size_t first = position;
+            while (position < length && text[position] >= '0' && text[position] <= '9')
+            {
+                position++;
+            }
+            return position > first;
+        };
+
+        token.type = TokenType::Number;
+        token.start = static_cast<std::uint32_t>(position);
+        if (position < length && text[position] == '-')
+        {
+            position++;
+        }
+        if (!digits())
+        {
+            return false;
+        }
+        if (position < length && text[position] == '.')
+        {
+            position++;
+            if (!digits())
+            {
+                return false;
+            }
+        }
+        if (position < length && (text[position] == 'e' || text[position] == 'E'))
+        {
+            position++;
+            if (position < length && (text[position] == '+' || text[position] == '-'))
+            {
+                position++;
+            }
+            if (!digits())
+            {
+                return false;
+            }
+        }
+        token.length = static_cast<std::uint32_t>(position) - token.start;
+        return true;
+    }
+
+    bool Document::parseLiteral(std::size_t &position, std::string_view literal, TokenType type)
+    {
+        if (std::string_view(text + position, std::min(literal.size(), length - position)) != literal)
+        {
+            return false;
+        }
+        Token &value = tokens[count - 1];
+        value.type = type;
+        value.start = static_cast<std::uint32_t>(position);
+        value.length = static_cast<std::uint32_t>(literal.size());
+        position += literal.size();
+        return true;
+    }
+}
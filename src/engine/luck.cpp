@@ -0,0 +1,235 @@
+#include "minefield/engine/luck.h"
+
+#include "minefield/engine/game.h"
+#include "minefield/engine/utils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <utility>
+
+namespace luck
+{
+    // symmetry bits: 1 mirrors columns, 2 mirrors rows, 4 transposes (square boards only)
+    constexpr unsigned int kSymmetries = 8;
+
+    Position sourceCell(unsigned int symmetry, unsigned int column, unsigned int row, unsigned int width, unsigned int height)
+    {
+        if (symmetry & 4)
+        {
+            std::swap(column, row);
+        }
+        return {(symmetry & 1) ? width - 1 - column : column, (symmetry & 2) ? height - 1 - row : row};
+    }
+
+    std::uint64_t hashState(const Board &board, unsigned int symmetry, std::uint64_t seed)
+    {
+        const CellStatusFlags *cells = board.cells();
+        const unsigned int width = board.getWidth();
+        const unsigned int height = board.getHeight();
+        std::uint64_t hash = seed;
+        std::uint64_t word = 0;
+        unsigned int bits = 0;
+        for (unsigned int c = 0; c < width; ++c)
+        {
+            for (unsigned int r = 0; r < height; ++r)
+            {
+                const Position source = sourceCell(symmetry, c, r, width, height);
+                word = (word << 1) | (hasFlag(cells[source.column * height + source.row], CellStatusFlags::Disabled) ? 1 : 0);
+                if (++bits == 64)
+                {
+                    hash = utils::mixSeed(hash, word);
+                    word = 0;
+                    bits = 0;
+                }
+            }
+        }
+        return utils::mixSeed(hash, word);
+    }
+
+    ExpectationCache::ExpectationCache(unsigned int samples, std::size_t capacity)
+        : samples(std::max(samples, 1U))
+        , entries(capacity)
+    {
+    }
+
+    cache::Stats ExpectationCache::stats() const
+    {
+        return entries.stats();
+    }
+
+    double ExpectationCache::savedMilliseconds() const
+    {
+        const cache::Stats counts = entries.stats();
+        return counts.misses ? 1e-6 * missNanoseconds.load() * counts.hits / counts.misses : 0.0;
+    }
+
+    Expectation ExpectationCache::lookup(const Board &board, const sim::Seat &first, const sim::Seat &second, unsigned int mines1, unsigned int mines2)
+    {
+        std::uint64_t seed = utils::mixSeed(board.getWidth(), board.getHeight());
+        seed = utils::mixSeed(seed, (static_cast<std::uint64_t>(mines1) << 32) | mines2);
+        seed = utils::mixSeed(seed, (static_cast<std::uint64_t>(first.strategy) << 32) | static_cast<std::uint64_t>(second.strategy));
+
+        // a transpose only keeps the dimensions of a square board
+        const unsigned int symmetries = (board.getWidth() == board.getHeight()) ? kSymmetries : kSymmetries / 2;
+        unsigned int canonical = 0;
+        std::uint64_t key = hashState(board, 0, seed);
+        for (unsigned int symmetry = 1; symmetry < symmetries; ++symmetry)
+        {
+            const std::uint64_t hash = hashState(board, symmetry, seed);
+            if (hash < key)
+            {
+                key = hash;
+                canonical = symmetry;
+            }
+        }
+
+        Expectation expectation;
+        if (entries.find(key, expectation))
+        {
+            return expectation;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        Board canonicalBoard = sim::makeBoard({board.getWidth(), board.getHeight(), 0});
+        for (unsigned int c = 0; c < board.getWidth(); ++c)
+        {
+            for (unsigned int r = 0; r < board.getHeight(); ++r)
+            {
+                const Position source = sourceCell(canonical, c, r, board.getWidth(), board.getHeight());
+                if (board.isDisabled(source.column, source.row))
+                {
+                    utils::safeCellAccess(canonicalBoard, c, r, [](CellStatusFlags &status){ status |= CellStatusFlags::Disabled; });
+                }
+            }
+        }
+        // computed without holding anything; two workers racing on the same state store the same value
+        expectation = sample(canonicalBoard, first, second, mines1, mines2, key);
+        entries.insert(key, expectation);
+        missNanoseconds += static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        return expectation;
+    }
+
+    Expectation ExpectationCache::sample(const Board &board, const sim::Seat &first, const sim::Seat &second, unsigned int mines1, unsigned int mines2, std::uint64_t seed) const
+    {
+        Expectation total;
+        for (unsigned int s = 0; s < samples; ++s)
+        {
+            Board copy = board;
+            Player p1 = makePlayer(false, "CPU 1", mines1);
+            Player p2 = makePlayer(false, "CPU 2", mines2);
+            const sim::Seat seat1 = {first.strategy, utils::mixSeed(seed, 2ULL * s), false};
+            const sim::Seat seat2 = {second.strategy, utils::mixSeed(seed, 2ULL * s + 1), false};
+            sim::placeAndGuess(seat1, seat2, p1, p2, copy, 1, nullptr);
+            const game::GuessTotals totals = game::resolveGuesses(p1, p2, copy, utils::nullStream());
+            total.hits1 += totals.hits[0];
+            total.hits2 += totals.hits[1];
+            total.loss1 += mines1 - p1.remainingMines;
+            total.loss2 += mines2 - p2.remainingMines;
+        }
+        total.hits1 /= samples;
+        total.hits2 /= samples;
+        total.loss1 /= samples;
+        total.loss2 /= samples;
+        return total;
+    }
+
+    GameLuck analyzeGame(const sim::GameReplay &replay, ExpectationCache &cache)
+    {
+        Board board = sim::makeBoard(replay.config);
+        Player p1 = makePlayer(false, "CPU 1", replay.config.mines);
+        Player p2 = makePlayer(false, "CPU 2", replay.config.mines);
+        std::ostream &quiet = utils::nullStream();
+
+        GameLuck result;
+        for (const auto &record : replay.rounds)
+        {
+            const unsigned int mines1 = p1.remainingMines;
+            const unsigned int mines2 = p2.remainingMines;
+            const Expectation expected = cache.lookup(board, replay.first, replay.second, mines1, mines2);
+
+            game::clearMines(board);
+            p1.currentMines = record.mines1;
+            p2.currentMines = record.mines2;
+            for (const auto &mine : record.mines1)
+            {
+                utils::safeCellAccess(board, mine.column, mine.row, [](CellStatusFlags &status){ status |= CellStatusFlags::HasMine; });
+            }
+            for (const auto &mine : record.mines2)
+            {
+                utils::safeCellAccess(board, mine.column, mine.row, [](CellStatusFlags &status){ status |= CellStatusFlags::HasMine; });
+            }
+            game::detectAndRemoveCollisions(p1, p2, board, quiet);
+            p1.currentGuesses = record.guesses1;
+            p2.currentGuesses = record.guesses2;
+
+            RoundLuck round;
+            round.expectedHits1 = expected.hits1;
+            round.expectedHits2 = expected.hits2;
+            const game::GuessTotals totals = game::resolveGuesses(p1, p2, board, quiet);
+            round.actualHits1 = totals.hits[0];
+            round.actualHits2 = totals.hits[1];
+            round.expectedLoss1 = expected.loss1;
+            round.expectedLoss2 = expected.loss2;
+            round.actualLoss1 = mines1 - p1.remainingMines;
+            round.actualLoss2 = mines2 - p2.remainingMines;
+
+            result.skill += round.expectedLoss2 - round.expectedLoss1;
+            result.luck += (round.actualLoss2 - round.expectedLoss2) - (round.actualLoss1 - round.expectedLoss1);
+            result.rounds.push_back(round);
+        }
+        result.outcome = sim::outcomeOf(p1, p2);
+        return result;
+    }
+
+    std::vector<GameLuck> analyzeArchive(const std::vector<sim::GameReplay> &archive, ExpectationCache &cache, unsigned int workers)
+    {
+        std::vector<GameLuck> results(archive.size());
+        sim::runParallel(workers, archive.size(), [&](std::uint64_t index){ return analyzeGame(archive[index], cache); },
+            [&](std::uint64_t index, const GameLuck &luck)
+            {
+                results[index] = luck;
+                return true;
+            });
+        return results;
+    }
+
+    std::ostream &operator<<(std::ostream &stream, const std::vector<GameLuck> &games)
+    {
+        std::uint64_t decisive = 0;
+        std::uint64_t wonByLuck = 0;
+        double winnerSkill = 0.0;
+        double winnerLuck = 0.0;
+        double absoluteLuck = 0.0;
+        for (const auto &game : games)
+        {
+            absoluteLuck += std::abs(game.luck);
+            if (game.outcome == sim::Outcome::Draw)
+            {
+                continue;
+            }
+            // seen from the winner: flip the sign when seat 2 won
+            const double sign = (game.outcome == sim::Outcome::FirstSeatWins) ? 1.0 : -1.0;
+            decisive++;
+            winnerSkill += sign * game.skill;
+            winnerLuck += sign * game.luck;
+            if (sign * game.skill <= 0.0 && sign * game.luck > 0.0)
+            {
+                wonByLuck++;
+            }
+        }
+        stream << "\n === LUCK ANALYSIS === \n";
+        stream << "games: " << games.size() << ", decisive: " << decisive << '\n';
+        if (!games.empty())
+        {
+            stream << "mean |luck| per game: " << absoluteLuck / games.size() << " mines\n";
+        }
+        if (decisive > 0)
+        {
+            stream << "winner's expected mine edge (skill): " << winnerSkill / decisive << '\n';
+            stream << "winner's unexpected edge (luck):     " << winnerLuck / decisive << '\n';
+            stream << "won without a skill edge: " << 100.0 * wonByLuck / decisive << "%\n";
+        }
+        return stream;
+    }
+}
@@ -0,0 +1,97 @@
+#include "minefield/engine/memory.h"
+
+#include <new>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+namespace memory
+{
+    struct BlockHeader
+    {
+        Backing backing;
+        std::size_t mappedBytes;
+    };
+
+    std::atomic<bool> &hugePagesEnabled()
+    {
+        static std::atomic<bool> enabled{false};
+        return enabled;
+    }
+
+    Counters &counters()
+    {
+        static Counters instance;
+        return instance;
+    }
+
+    void *allocate(std::size_t bytes)
+    {
+        void *base = nullptr;
+        BlockHeader header = {Backing::Heap, 0};
+#ifndef _WIN32
+        if (hugePagesEnabled().load(std::memory_order_relaxed) && bytes >= kHugeThreshold)
+        {
+            const std::size_t mapped = (bytes + kHeaderSize + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+#ifdef MAP_HUGETLB
+            base = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            header = {Backing::Explicit, mapped};
+#endif
+            if (base == nullptr || base == MAP_FAILED)
+            {
+                base = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                header = {Backing::Transparent, mapped};
+#ifdef MADV_HUGEPAGE
+                if (base != MAP_FAILED)
+                {
+                    madvise(base, mapped, MADV_HUGEPAGE);
+                }
+#endif
+            }
+            if (base == MAP_FAILED)
+            {
+                base = nullptr;
+            }
+        }
+#endif
+        if (base == nullptr)
+        {
+            base = ::operator new(bytes + kHeaderSize, std::align_val_t{kHeaderSize});
+            header = {Backing::Heap, 0};
+        }
+        switch (header.backing)
+        {
+        case Backing::Explicit:
+            counters().explicitHuge++;
+            break;
+        case Backing::Transparent:
+            counters().transparent++;
+            break;
+        case Backing::Heap:
+        default:
+            counters().heap++;
+            break;
+        }
+        *static_cast<BlockHeader *>(base) = header;
+        return static_cast<char *>(base) + kHeaderSize;
+    }
+
+    void deallocate(void *block)
+    {
+        if (block == nullptr)
+        {
+            return;
+        }
+        void *base = static_cast<char *>(block) - kHeaderSize;
+        const BlockHeader header = *static_cast<BlockHeader *>(base);
+#ifndef _WIN32
+        if (header.backing != Backing::Heap)
+        {
+            munmap(base, header.mappedBytes);
+            return;
+        }
+#endif
+        ::operator delete(base, std::align_val_t{kHeaderSize});
+    }
+}
@@ -0,0 +1,162 @@
+#include "minefield/engine/net.h"
+
+#ifndef _WIN32
+#include <algorithm>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace net
+{
+    bool isTcpAddress(const std::string &address, std::string &host, std::string &port)
+    {
+        const std::size_t colon = address.rfind(':');
+        if (address.empty() || address[0] == '/' || colon == std::string::npos)
+        {
+            return false;
+        }
+        host = address.substr(0, colon);
+        port = address.substr(colon + 1);
+        return true;
+    }
+
+    int openSocket(const std::string &address, bool listening)
+    {
+        std::string host;
+        std::string port;
+        if (!isTcpAddress(address, host, port))
+        {
+            sockaddr_un local = {};
+            local.sun_family = AF_UNIX;
+            if (address.size() >= sizeof(local.sun_path))
+            {
+                return -1;
+            }
+            std::copy(address.begin(), address.end(), local.sun_path);
+            const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (listening)
+            {
+                unlink(address.c_str());
+            }
+            const sockaddr *target = reinterpret_cast<const sockaddr *>(&local);
+            const bool ok = listening ? (bind(fd, target, sizeof(local)) == 0 && listen(fd, SOMAXCONN) == 0) : (connect(fd, target, sizeof(local)) == 0);
+            if (fd >= 0 && !ok)
+            {
+                close(fd);
+                return -1;
+            }
+            return fd;
+        }
+
+        addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = listening ? AI_PASSIVE : 0;
+        addrinfo *found = nullptr;
+        if (getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &found) != 0)
+        {
+            return -1;
+        }
+        int fd = -1;
+        for (addrinfo *candidate = found; candidate && fd < 0; candidate = candidate->ai_next)
+        {
+            fd = socket(candidate->ai_family, candidate->ai_socktype, candidate->ai_protocol);
+            if (fd < 0)
+            {
+                continue;
+            }
+            const int reuse = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+            const bool ok = listening ? (bind(fd, candidate->ai_addr, candidate->ai_addrlen) == 0 && listen(fd, SOMAXCONN) == 0)
+                                      : (connect(fd, candidate->ai_addr, candidate->ai_addrlen) == 0);
+            if (!ok)
+            {
+                close(fd);
+                fd = -1;
+            }
+        }
+        freeaddrinfo(found);
+        return fd;
+    }
+
+    bool sendAll(int fd, const char *data, std::size_t size)
+    {
+        std::size_t sent = 0;
+        while (sent < size)
+        {
+            const ssize_t n = send(fd, data + sent, size - sent, 0);
+            if (n <= 0)
+            {
+                return false;
+            }
+            sent += static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+
+    bool setNonBlocking(int fd)
+    {
+        const int flags = fcntl(fd, F_GETFL, 0);
+        return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+    }
+
+    bool sendPending(int fd, std::string &buffer)
+    {
+        std::size_t sent = 0;
+        while (sent < buffer.size())
+        {
+            const ssize_t n = send(fd, buffer.data() + sent, buffer.size() - sent, 0);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            {
+                break;
+            }
+            if (n <= 0)
+            {
+                return false;
+            }
+            sent += static_cast<std::size_t>(n);
+        }
+        buffer.erase(0, sent);
+        return true;
+    }
+
+    bool sendLine(int fd, const std::string &line)
+    {
+        const std::string data = line + '\n';
+        return sendAll(fd, data.data(), data.size());
+    }
+
+    // reads whatever is available into buffer; false once the peer is gone
+    bool receive(int fd, std::string &buffer)
+    {
+        char chunk[512];
+        const ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0)
+        {
+            return false;
+        }
+        buffer.append(chunk, static_cast<std::size_t>(n));
+        return true;
+    }
+
+    bool takeLine(std::string &buffer, std::string &line)
+    {
+        const std::size_t end = buffer.find('\n');
+        if (end == std::string::npos)
+        {
+            return false;
+        }
+        line = buffer.substr(0, end);
+        buffer.erase(0, end + 1);
+        return true;
+    }
+}
+#endif
@@ -0,0 +1,144 @@
+#include "minefield/engine/numa.h"
+
+#include "minefield/engine/sim.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace numa
+{
+    std::vector<unsigned int> parseCpuList(const std::string &list)
+    {
+        std::vector<unsigned int> cpus;
+        std::stringstream stream(list);
+        std::string range;
+        while (std::getline(stream, range, ','))
+        {
+            const std::size_t dash = range.find('-');
+            const unsigned int first = static_cast<unsigned int>(std::stoul(range.substr(0, dash)));
+            const unsigned int last = (dash == std::string::npos) ? first : static_cast<unsigned int>(std::stoul(range.substr(dash + 1)));
+            for (unsigned int cpu = first; cpu <= last; ++cpu)
+            {
+                cpus.push_back(cpu);
+            }
+        }
+        return cpus;
+    }
+
+    Topology detectTopology()
+    {
+        Topology topology;
+        // node numbers can have holes (offline or hot-removed nodes), so the online list names them
+        std::ifstream online("/sys/devices/system/node/online");
+        std::string nodes;
+        if (online && std::getline(online, nodes))
+        {
+            for (const unsigned int node : parseCpuList(nodes))
+            {
+                std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+                std::string list;
+                std::vector<unsigned int> cpus;
+                if (file && std::getline(file, list))
+                {
+                    cpus = parseCpuList(list);
+                }
+                if (!cpus.empty())
+                {
+                    topology.nodes.push_back(cpus);
+                    topology.ids.push_back(node);
+                }
+            }
+        }
+        if (topology.nodes.empty())
+        {
+            std::vector<unsigned int> cpus(sim::defaultWorkerCount());
+            for (unsigned int cpu = 0; cpu < cpus.size(); ++cpu)
+            {
+                cpus[cpu] = cpu;
+            }
+            topology.nodes.push_back(cpus);
+            topology.ids.push_back(0);
+        }
+        return topology;
+    }
+
+    bool pinCurrentThread(unsigned int cpu)
+    {
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+        (void)cpu;
+        return false;
+#endif
+    }
+
+    RunReport run(const shard::Job &job, const Topology &topology, unsigned int nodeCount, unsigned int workersPerNode)
+    {
+        static constexpr std::uint64_t kChunkGames = 1024;
+        nodeCount = std::min<unsigned int>(std::max(nodeCount, 1U), static_cast<unsigned int>(topology.nodes.size()));
+        workersPerNode = std::max(workersPerNode, 1U);
+
+        std::vector<WorkerSlot> slots(static_cast<std::size_t>(nodeCount) * workersPerNode);
+        alignas(64) std::atomic<std::uint64_t> nextChunk{0};
+        const auto start = std::chrono::steady_clock::now();
+
+        std::vector<std::thread> threads;
+        for (unsigned int node = 0; node < nodeCount; ++node)
+        {
+            const std::vector<unsigned int> &cpus = topology.nodes[node];
+            for (unsigned int w = 0; w < workersPerNode; ++w)
+            {
+                WorkerSlot &slot = slots[static_cast<std::size_t>(node) * workersPerNode + w];
+                const unsigned int cpu = cpus[w % cpus.size()];
+                threads.emplace_back([&job, &slot, &nextChunk, cpu]
+                    {
+                        slot.pinned = pinCurrentThread(cpu);
+                        shard::Stats local;
+                        while (true)
+                        {
+                            const std::uint64_t first = nextChunk.fetch_add(1, std::memory_order_relaxed) * kChunkGames;
+                            if (first >= job.games)
+                            {
+                                break;
+                            }
+                            local.merge(shard::playRange(job, first, std::min(kChunkGames, job.games - first)));
+                        }
+                        slot.stats = local;
+                    });
+            }
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+
+        RunReport report;
+        report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        for (unsigned int node = 0; node < nodeCount; ++node)
+        {
+            NodeReport nodeReport;
+            nodeReport.node = (node < topology.ids.size()) ? topology.ids[node] : node;
+            nodeReport.workers = workersPerNode;
+            for (unsigned int w = 0; w < workersPerNode; ++w)
+            {
+                const WorkerSlot &slot = slots[static_cast<std::size_t>(node) * workersPerNode + w];
+                nodeReport.stats.merge(slot.stats);
+                report.pinned = report.pinned && slot.pinned;
+            }
+            report.total.merge(nodeReport.stats);
+            report.nodes.push_back(nodeReport);
+        }
+        return report;
+    }
+}
@@ -0,0 +1,304 @@
+#include "minefield/engine/partition.h"
+
+#include "minefield/engine/game.h"
+#include "minefield/engine/utils.h"
+
+#include <algorithm>
+
+namespace partition
+{
+    // calls onMatch for every entry of [first, last) whose cell also appears in [other, otherLast); both sorted by cell
+    template <typename Entry, typename OnMatchFnT>
+    void matchSorted(const Entry *first, const Entry *last, const Entry *other, const Entry *otherLast, OnMatchFnT onMatch)
+    {
+        for (; first != last; ++first)
+        {
+            while (other != otherLast && other->cell < first->cell)
+            {
+                ++other;
+            }
+            if (other == otherLast)
+            {
+                return;
+            }
+            if (other->cell == first->cell)
+            {
+                onMatch(*first);
+            }
+        }
+    }
+
+    RoundResolver::RoundResolver(sim::WorkerPool &pool, unsigned int tiles)
+        : pool(pool)
+        , tiles(1)
+    {
+        while (this->tiles < std::max(tiles, 1U))
+        {
+            this->tiles *= 2;
+        }
+        counters.resize(this->tiles);
+    }
+
+    void RoundResolver::setup(const Board &board, std::size_t count)
+    {
+        const std::uint64_t cells = static_cast<std::uint64_t>(board.getWidth()) * board.getHeight();
+        shift = 0;
+        while (((cells - 1) >> shift) >= tiles)
+        {
+            shift++;
+        }
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            List &list = lists[k];
+            list.entries.resize(list.positions->size());
+            list.histogram.assign(static_cast<std::size_t>(tiles) * tiles, 0);
+            list.offsets.assign(tiles + 1, 0);
+            list.dropped.assign(list.positions->size(), 0);
+        }
+        std::fill(counters.begin(), counters.end(), Counters{});
+    }
+
+    template <typename TileFnT>
+    void RoundResolver::forEachTile(TileFnT onTile)
+    {
+        for (unsigned int tile = 0; tile < tiles; ++tile)
+        {
+            pool.submit([&onTile, tile]{ onTile(tile); });
+        }
+        pool.wait();
+    }
+
+    void RoundResolver::scatter(const Board &board, std::size_t count)
+    {
+        setup(board, count);
+        const unsigned int height = board.getHeight();
+        auto chunkOf = [this](std::size_t size, unsigned int chunk)
+        {
+            return std::make_pair(size * chunk / tiles, size * (chunk + 1) / tiles);
+        };
+
+        // the lists are cut into as many chunks as there are tiles
+        forEachTile([&](unsigned int chunk)
+            {
+                for (std::size_t k = 0; k < count; ++k)
+                {
+                    const std::vector<Position> &positions = *lists[k].positions;
+                    std::size_t *histogram = &lists[k].histogram[static_cast<std::size_t>(chunk) * tiles];
+                    const auto [first, last] = chunkOf(positions.size(), chunk);
+                    for (std::size_t i = first; i < last; ++i)
+                    {
+                        histogram[(static_cast<std::size_t>(positions[i].column) * height + positions[i].row) >> shift]++;
+                    }
+                }
+            });
+
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            List &list = lists[k];
+            std::size_t running = 0;
+            for (unsigned int tile = 0; tile < tiles; ++tile)
+            {
+                list.offsets[tile] = running;
+                for (unsigned int chunk = 0; chunk < tiles; ++chunk)
+                {
+                    std::size_t &slot = list.histogram[static_cast<std::size_t>(chunk) * tiles + tile];
+                    const std::size_t size = slot;
+                    slot = running;
+                    running += size;
+                }
+            }
+            list.offsets[tiles] = running;
+        }
+
+        forEachTile([&](unsigned int chunk)
+            {
+                for (std::size_t k = 0; k < count; ++k)
+                {
+                    const std::vector<Position> &positions = *lists[k].positions;
+                    std::size_t *cursor = &lists[k].histogram[static_cast<std::size_t>(chunk) * tiles];
+                    const auto [first, last] = chunkOf(positions.size(), chunk);
+                    for (std::size_t i = first; i < last; ++i)
+                    {
+                        const std::uint32_t cell = static_cast<std::uint32_t>(static_cast<std::size_t>(positions[i].column) * height + positions[i].row);
+                        lists[k].entries[cursor[cell >> shift]++] = {cell, static_cast<std::uint32_t>(i)};
+                    }
+                }
+            });
+    }
+
+    const RoundResolver::Entry *RoundResolver::begin(std::size_t list, unsigned int tile) const
+    {
+        return lists[list].entries.data() + lists[list].offsets[tile];
+    }
+
+    const RoundResolver::Entry *RoundResolver::end(std::size_t list, unsigned int tile) const
+    {
+        return lists[list].entries.data() + lists[list].offsets[tile + 1];
+    }
+
+    unsigned int RoundResolver::sum(std::size_t counter) const
+    {
+        unsigned int total = 0;
+        for (const auto &tile : counters)
+        {
+            total += tile.values[counter];
+        }
+        return total;
+    }
+
+    void RoundResolver::keepSurvivors(std::vector<Position> &positions, const std::vector<std::uint8_t> &dropped)
+    {
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < positions.size(); ++i)
+        {
+            if (!dropped[i])
+            {
+                positions[kept++] = positions[i];
+            }
+        }
+        positions.resize(kept);
+    }
+
+    unsigned int RoundResolver::detectAndRemoveCollisions(Player &p1, Player &p2, Board &board)
+    {
+        if (p1.currentMines.size() + p2.currentMines.size() < kSerialThreshold)
+        {
+            const std::size_t before = p1.currentMines.size();
+            game::detectAndRemoveCollisions(p1, p2, board, utils::nullStream());
+            return static_cast<unsigned int>(before - p1.currentMines.size());
+        }
+
+        lists[0].positions = &p1.currentMines;
+        lists[1].positions = &p2.currentMines;
+        scatter(board, 2);
+
+        forEachTile([&](unsigned int tile)
+            {
+                unsigned int *values = counters[tile].values;
+                for (std::size_t k = 0; k < 2; ++k)
+                {
+                    std::sort(lists[k].entries.begin() + lists[k].offsets[tile], lists[k].entries.begin() + lists[k].offsets[tile + 1],
+                        [](const Entry &a, const Entry &b){ return a.cell < b.cell; });
+                }
+                matchSorted(begin(0, tile), end(0, tile), begin(1, tile), end(1, tile), [&](const Entry &mine)
+                    {
+                        const Position &position = p1.currentMines[mine.element];
+                        lists[0].dropped[mine.element] = 1;
+                        values[0]++;
+                        board.safeCellAccess(position.column, position.row, [](CellStatusFlags &status)
+                            {
+                                status |= CellStatusFlags::HadCollision | CellStatusFlags::Disabled;
+                                status = status & ~CellStatusFlags::HasMine;
+                            });
+                    });
+                matchSorted(begin(1, tile), end(1, tile), begin(0, tile), end(0, tile), [&](const Entry &mine)
+                    {
+                        lists[1].dropped[mine.element] = 1;
+                        values[1]++;
+                    });
+            });
+
+        const unsigned int removedByP1 = sum(0);
+        const unsigned int removedByP2 = sum(1);
+        keepSurvivors(p1.currentMines, lists[0].dropped);
+        keepSurvivors(p2.currentMines, lists[1].dropped);
+        p1.remainingMines = (p1.remainingMines >= removedByP1) ? p1.remainingMines - removedByP1 : 0;
+        p2.remainingMines = (p2.remainingMines >= removedByP2) ? p2.remainingMines - removedByP2 : 0;
+        return removedByP1;
+    }
+
+    game::GuessTotals RoundResolver::resolveGuesses(Player &p1, Player &p2, Board &board)
+    {
+        if (p1.currentMines.size() + p2.currentMines.size() + p1.currentGuesses.size() + p2.currentGuesses.size() < kSerialThreshold)
+        {
+            return game::resolveGuesses(p1, p2, board, utils::nullStream());
+        }
+
+        game::GuessTotals totals;
+        // 0 and 1: mines of each seat, 2 and 3: their guesses
+        lists[0].positions = &p1.currentMines;
+        lists[1].positions = &p2.currentMines;
+        lists[2].positions = &p1.currentGuesses;
+        lists[3].positions = &p2.currentGuesses;
+        scatter(board, 4);
+
+        forEachTile([&](unsigned int tile)
+            {
+                unsigned int *values = counters[tile].values;
+                for (std::size_t k = 0; k < 4; ++k)
+                {
+                    std::sort(lists[k].entries.begin() + lists[k].offsets[tile], lists[k].entries.begin() + lists[k].offsets[tile + 1],
+                        [](const Entry &a, const Entry &b){ return a.cell < b.cell; });
+                }
+                for (std::size_t seat = 0; seat < 2; ++seat)
+                {
+                    const std::size_t own = seat;
+                    const std::size_t opponent = 1 - seat;
+                    const std::size_t guesses = 2 + seat;
+                    Player &player = seat ? p2 : p1;
+                    matchSorted(begin(guesses, tile), end(guesses, tile), begin(opponent, tile), end(opponent, tile), [&](const Entry &){ values[seat]++; });
+                    matchSorted(begin(own, tile), end(own, tile), begin(guesses, tile), end(guesses, tile), [&](const Entry &mine)
+                        {
+                            const Position &position = player.currentMines[mine.element];
+                            lists[own].dropped[mine.element] = 1;
+                            values[2 + seat]++;
+                            board.safeCellAccess(position.column, position.row, [](CellStatusFlags &status)
+                                {
+                                    status |= CellStatusFlags::Disabled | CellStatusFlags::SelfDetonated;
+                                    status = status & ~CellStatusFlags::HasMine;
+                                });
+                        });
+                }
+                for (std::size_t k = 2; k < 4; ++k)
+                {
+                    const std::vector<Position> &guesses = *lists[k].positions;
+                    for (const Entry *guess = begin(k, tile); guess != end(k, tile); ++guess)
+                    {
+                        const Position &position = guesses[guess->element];
+                        board.safeCellAccess(position.column, position.row, [](CellStatusFlags &status){ status |= CellStatusFlags::Disabled | CellStatusFlags::WasGuessed; });
+                    }
+                }
+            });
+
+        for (int seat = 0; seat < 2; ++seat)
+        {
+            totals.hits[seat] = sum(seat);
+            totals.selfHits[seat] = sum(2 + seat);
+        }
+        p2.remainingMines = (p2.remainingMines >= totals.hits[0]) ? p2.remainingMines - totals.hits[0] : 0;
+        p1.remainingMines = (p1.remainingMines >= totals.hits[1]) ? p1.remainingMines - totals.hits[1] : 0;
+        keepSurvivors(p1.currentMines, lists[0].dropped);
+        keepSurvivors(p2.currentMines, lists[1].dropped);
+        p1.remainingMines = (p1.remainingMines >= totals.selfHits[0]) ? p1.remainingMines - totals.selfHits[0] : 0;
+        p2.remainingMines = (p2.remainingMines >= totals.selfHits[1]) ? p2.remainingMines - totals.selfHits[1] : 0;
+        return totals;
+    }
+
+    RoundResolver &threadResolver()
+    {
+        constexpr unsigned int kTiles = 64;
+        static sim::WorkerPool pool(sim::defaultWorkerCount());
+        thread_local RoundResolver resolver(pool, kTiles);
+        return resolver;
+    }
+
+    unsigned int detectAndRemoveCollisions(Player &p1, Player &p2, Board &board)
+    {
+        if (p1.currentMines.size() + p2.currentMines.size() < RoundResolver::kSerialThreshold)
+        {
+            const std::size_t before = p1.currentMines.size();
+            game::detectAndRemoveCollisions(p1, p2, board, utils::nullStream());
+            return static_cast<unsigned int>(before - p1.currentMines.size());
+        }
+        return threadResolver().detectAndRemoveCollisions(p1, p2, board);
+    }
+
+    game::GuessTotals resolveGuesses(Player &p1, Player &p2, Board &board)
+    {
+        if (p1.currentMines.size() + p2.currentMines.size() + p1.currentGuesses.size() + p2.currentGuesses.size() < RoundResolver::kSerialThreshold)
+        {
+            return game::resolveGuesses(p1, p2, board, utils::nullStream());
+        }
+        return threadResolver().resolveGuesses(p1, p2, board);
+    }
+}
@@ -0,0 +1,71 @@
+#include "minefield/engine/profiling.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+namespace profiling
+{
+    TlbMissCounter::TlbMissCounter()
+    {
+#ifdef __linux__
+        perf_event_attr attr = {};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.inherit = 1; // sweeps run on threads started after the counter; their misses are added when they exit
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    TlbMissCounter::~TlbMissCounter()
+    {
+#ifndef _WIN32
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+#endif
+    }
+
+    bool TlbMissCounter::valid() const
+    {
+        return fd >= 0;
+    }
+
+    void TlbMissCounter::start()
+    {
+#ifdef __linux__
+        if (fd >= 0)
+        {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    std::uint64_t TlbMissCounter::stop()
+    {
+        std::uint64_t count = 0;
+#ifdef __linux__
+        if (fd >= 0)
+        {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd, &count, sizeof(count)) != static_cast<ssize_t>(sizeof(count)))
+            {
+                count = 0;
+            }
+        }
+#endif
+        return count;
+    }
+}
@@ -0,0 +1,174 @@
+#include "minefield/engine/session.h"
+
+#include "minefield/engine/game.h"
+#include "minefield/engine/partition.h"
+#include "minefield/engine/utils.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace session
+{
+    Game::Game(const sim::GameConfig &config)
+        : board(sim::makeBoard(config))
+    {
+        seats[0] = {false, "Seat 1", config.mines, {}, {}};
+        seats[1] = {false, "Seat 2", config.mines, {}, {}};
+    }
+
+    std::uint32_t CellMarks::fresh(std::size_t cells)
+    {
+        if (stamps.size() < cells || current == std::numeric_limits<std::uint32_t>::max())
+        {
+            stamps.assign(std::max(cells, stamps.size()), 0);
+            current = 0;
+        }
+        return ++current;
+    }
+
+    std::uint32_t &CellMarks::operator[](std::size_t cell)
+    {
+        return stamps[cell];
+    }
+
+    std::size_t cellIndex(const Board &board, const Position &cell)
+    {
+        return static_cast<std::size_t>(cell.column) * board.getHeight() + cell.row;
+    }
+
+    bool freeCell(const Board &board, const Position &cell)
+    {
+        return board.isValidPosition(cell.column, cell.row) && !board.isDisabled(cell.column, cell.row);
+    }
+
+    void expectedCounts(const Game &game, std::uint32_t mineCount[2], std::uint32_t maxGuessCount[2])
+    {
+        const std::uint32_t freeCells = utils::countFreeCells(game.board);
+        for (int seat = 0; seat < 2; ++seat)
+        {
+            mineCount[seat] = std::min(game.seats[seat].remainingMines, freeCells);
+            maxGuessCount[seat] = std::min(game.seats[1 - seat].remainingMines, freeCells);
+        }
+    }
+
+    // Cells must be free and listed once per list. Cells holding mines of both seats are disabled by the
+    // collision before anyone guesses, so they cannot be guessed either.
+    RoundStatus validateRound(const Game &game, const RoundInput &input, CellMarks &marks, std::uint32_t &collisions)
+    {
+        if (game.finished)
+        {
+            return RoundStatus::GameOver;
+        }
+        const Board &board = game.board;
+        const std::size_t cells = static_cast<std::size_t>(board.getWidth()) * board.getHeight();
+        const std::uint32_t freeCells = utils::countFreeCells(board);
+        for (int seat = 0; seat < 2; ++seat)
+        {
+            const std::uint32_t count = input.mineCount[seat];
+            if (count != std::min(game.seats[seat].remainingMines, freeCells) || (count > 0 && !input.mines[seat]))
+            {
+                return RoundStatus::InvalidMove;
+            }
+        }
+
+        const std::uint32_t first = marks.fresh(cells);
+        const std::uint32_t second = marks.fresh(cells);
+        const std::uint32_t collided = marks.fresh(cells);
+        for (std::uint32_t i = 0; i < input.mineCount[0]; ++i)
+        {
+            const Position &mine = input.mines[0][i];
+            if (!freeCell(board, mine) || marks[cellIndex(board, mine)] == first)
+            {
+                return RoundStatus::InvalidMove;
+            }
+            marks[cellIndex(board, mine)] = first;
+        }
+        collisions = 0;
+        for (std::uint32_t i = 0; i < input.mineCount[1]; ++i)
+        {
+            const Position &mine = input.mines[1][i];
+            if (!freeCell(board, mine))
+            {
+                return RoundStatus::InvalidMove;
+            }
+            std::uint32_t &mark = marks[cellIndex(board, mine)];
+            if (mark == second || mark == collided)
+            {
+                return RoundStatus::InvalidMove;
+            }
+            if (mark == first)
+            {
+                collisions++;
+            }
+            mark = (mark == first) ? collided : second;
+        }
+
+        for (int seat = 0; seat < 2; ++seat)
+        {
+            const unsigned int opponentMines = game.seats[1 - seat].remainingMines;
+            const std::uint32_t count = input.guessCount[seat];
+            const std::uint32_t expected = std::min((opponentMines > collisions) ? opponentMines - collisions : 0, freeCells - collisions);
+            if (count != expected || (count > 0 && !input.guesses[seat]))
+            {
+                return RoundStatus::InvalidMove;
+            }
+            const std::uint32_t guessed = marks.fresh(cells);
+            for (std::uint32_t i = 0; i < count; ++i)
+            {
+                const Position &guess = input.guesses[seat][i];
+                if (!freeCell(board, guess))
+                {
+                    return RoundStatus::InvalidMove;
+                }
+                std::uint32_t &mark = marks[cellIndex(board, guess)];
+                if (mark == collided || mark == guessed)
+                {
+                    return RoundStatus::InvalidMove;
+                }
+                mark = guessed;
+            }
+        }
+        return RoundStatus::Ok;
+    }
+
+    // same phases as sim::placeAndGuess followed by the end check of sim::playGame, with the given positions
+    RoundStatus playRound(Game &game, const RoundInput &input, CellMarks &marks, RoundResult &result)
+    {
+        result = RoundResult{};
+        const RoundStatus status = validateRound(game, input, marks, result.collisions);
+        if (status != RoundStatus::Ok)
+        {
+            return status;
+        }
+
+        Player &p1 = game.seats[0];
+        Player &p2 = game.seats[1];
+        std::ostream &quiet = utils::nullStream();
+
+        game::clearMines(game.board);
+        for (int seat = 0; seat < 2; ++seat)
+        {
+            game.seats[seat].currentMines.assign(input.mines[seat], input.mines[seat] + input.mineCount[seat]);
+            for (const auto &mine : game.seats[seat].currentMines)
+            {
+                utils::safeCellAccess(game.board, mine.column, mine.row, [](CellStatusFlags &flags){ flags |= CellStatusFlags::HasMine; });
+            }
+        }
+        partition::detectAndRemoveCollisions(p1, p2, game.board);
+
+        for (int seat = 0; seat < 2; ++seat)
+        {
+            game.seats[seat].currentGuesses.assign(input.guesses[seat], input.guesses[seat] + input.guessCount[seat]);
+        }
+        const game::GuessTotals totals = partition::resolveGuesses(p1, p2, game.board);
+        result.hits[0] = totals.hits[0];
+        result.hits[1] = totals.hits[1];
+
+        if (game::checkGameEnd(p1, p2, quiet) || utils::countFreeCells(game.board) == 0)
+        {
+            game.finished = true;
+            game.outcome = sim::outcomeOf(p1, p2);
+        }
+        return RoundStatus::Ok;
+    }
+}
@@ -0,0 +1,282 @@
+#include "minefield/engine/shard.h"
+
+#include "minefield/engine/net.h"
+#include "minefield/engine/utils.h"
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <vector>
+
+#ifndef _WIN32
+#include <csignal>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace shard
+{
+    Stats playRange(const Job &job, std::uint64_t first, std::uint64_t count)
+    {
+        Stats stats;
+        for (std::uint64_t g = first; g < first + count; ++g)
+        {
+            const sim::Seat seat1 = {job.first, utils::mixSeed(job.seed, 2 * g), false};
+            const sim::Seat seat2 = {job.second, utils::mixSeed(job.seed, 2 * g + 1), false};
+            const sim::GameResult result = sim::playGame(job.config, seat1, seat2);
+            stats.wins += (result.outcome == sim::Outcome::FirstSeatWins) ? 1 : 0;
+            stats.draws += (result.outcome == sim::Outcome::Draw) ? 1 : 0;
+            stats.losses += (result.outcome == sim::Outcome::SecondSeatWins) ? 1 : 0;
+            stats.rounds += result.rounds;
+        }
+        return stats;
+    }
+
+    std::ostream &operator<<(std::ostream &stream, const Stats &stats)
+    {
+        const double games = static_cast<double>(std::max<std::uint64_t>(stats.games(), 1));
+        stream << "games: " << stats.games() << " (W " << stats.wins << " / D " << stats.draws << " / L " << stats.losses << ")\n";
+        stream << "first seat score: " << (stats.wins + 0.5 * stats.draws) / games << '\n';
+        stream << "mean rounds: " << stats.rounds / games << '\n';
+        return stream;
+    }
+
+#ifndef _WIN32
+    struct Connection
+    {
+        std::string buffer;
+        bool busy = false;
+        std::uint64_t first = 0;
+        std::uint64_t count = 0;
+    };
+
+    // local workers replaced after dying, per process asked for; beyond that they are not started again
+    constexpr unsigned int kMaxRespawnsPerProcess = 3;
+
+    // "host:port" is TCP, anything else a Unix socket path. The worker is this very binary: /proc/self/exe
+    // finds it where argv[0] is only a name looked up in PATH, and execvp covers systems without /proc.
+    pid_t spawnWorker(const char *executable, const std::string &address)
+    {
+        const pid_t pid = fork();
+        if (pid == 0)
+        {
+            char *const arguments[] = {const_cast<char *>(executable), const_cast<char *>("worker"), const_cast<char *>("--connect"),
+                const_cast<char *>(address.c_str()), nullptr};
+            execv("/proc/self/exe", arguments);
+            execvp(executable, arguments);
+            _exit(127);
+        }
+        return pid;
+    }
+
+    bool coordinate(const Job &job, const std::string &address, unsigned int processes, std::uint64_t rangeSize, const char *executable, CoordinatorReport &report)
+    {
+        std::signal(SIGPIPE, SIG_IGN);
+        const int listener = net::openSocket(address, true);
+        if (listener < 0)
+        {
+            std::cout << "Cannot listen on " << address << '\n';
+            return false;
+        }
+
+        std::deque<std::pair<std::uint64_t, std::uint64_t>> pending;
+        for (std::uint64_t first = 0; first < job.games; first += rangeSize)
+        {
+            pending.emplace_back(first, std::min(rangeSize, job.games - first));
+        }
+        std::vector<pid_t> children;
+        for (unsigned int i = 0; i < processes; ++i)
+        {
+            children.push_back(spawnWorker(executable, address));
+        }
+
+        std::ostringstream config;
+        config << "CONFIG " << job.config.width << ' ' << job.config.height << ' ' << job.config.mines << ' ' << cpu::strategyName(job.first) << ' '
+               << cpu::strategyName(job.second) << ' ' << job.seed;
+
+        std::map<int, Connection> connections;
+        std::uint64_t completed = 0;
+        bool everConnected = false;
+        auto drop = [&](int fd)
+        {
+            Connection &connection = connections[fd];
+            if (connection.busy)
+            {
+                pending.emplace_front(connection.first, connection.count);
+                report.reissued++;
+            }
+            close(fd);
+            connections.erase(fd);
+        };
+
+        while (completed < job.games)
+        {
+            // hand pending ranges to idle workers
+            for (auto &[fd, connection] : connections)
+            {
+                if (!connection.busy && !pending.empty())
+                {
+                    std::tie(connection.first, connection.count) = pending.front();
+                    pending.pop_front();
+                    connection.busy = true;
+                    net::sendLine(fd, "RANGE " + std::to_string(connection.first) + ' ' + std::to_string(connection.count));
+                }
+            }
+
+            std::vector<pollfd> polled = {{listener, POLLIN, 0}};
+            for (const auto &entry : connections)
+            {
+                polled.push_back({entry.first, POLLIN, 0});
+            }
+            poll(polled.data(), polled.size(), 200);
+
+            if (polled[0].revents & POLLIN)
+            {
+                const int fd = accept(listener, nullptr, nullptr);
+                if (fd >= 0)
+                {
+                    connections[fd] = Connection();
+                    everConnected = true;
+                    net::sendLine(fd, config.str());
+                }
+            }
+            for (std::size_t i = 1; i < polled.size(); ++i)
+            {
+                const int fd = polled[i].fd;
+                if (!(polled[i].revents & (POLLIN | POLLHUP | POLLERR)))
+                {
+                    continue;
+                }
+                Connection &connection = connections[fd];
+                if (!net::receive(fd, connection.buffer))
+                {
+                    drop(fd);
+                    continue;
+                }
+                std::string line;
+                while (net::takeLine(connection.buffer, line))
+                {
+                    std::istringstream message(line);
+                    std::string kind;
+                    std::uint64_t first = 0;
+                    std::uint64_t count = 0;
+                    Stats stats;
+                    message >> kind >> first >> count >> stats.wins >> stats.draws >> stats.losses >> stats.rounds;
+                    if (kind == "RESULT" && connection.busy && first == connection.first && count == connection.count && stats.games() == count)
+                    {
+                        report.stats.merge(stats);
+                        completed += count;
+                        connection.busy = false;
+                    }
+                }
+            }
+
+            // replace local workers that died while work remains, up to a limit: a worker that cannot start
+            // or cannot connect would otherwise be respawned forever
+            bool localWorkers = false;
+            for (auto &child : children)
+            {
+                if (child > 0 && waitpid(child, nullptr, WNOHANG) == child)
+                {
+                    child = -1;
+                    if (completed < job.games && report.respawned < kMaxRespawnsPerProcess * processes)
+                    {
+                        child = spawnWorker(executable, address);
+                        report.respawned++;
+                    }
+                }
+                localWorkers = localWorkers || child > 0;
+            }
+            if (processes > 0 && !localWorkers && connections.empty() && completed < job.games)
+            {
+                std::cout << (everConnected ? "Local workers kept exiting" : "No worker ever connected") << " after " << report.respawned << " respawns\n";
+                break;
+            }
+        }
+
+        for (const auto &entry : connections)
+        {
+            net::sendLine(entry.first, "DONE");
+            close(entry.first);
+        }
+        close(listener);
+        for (const pid_t child : children)
+        {
+            if (child > 0)
+            {
+                waitpid(child, nullptr, 0);
+            }
+        }
+        std::string host;
+        std::string port;
+        if (!net::isTcpAddress(address, host, port))
+        {
+            unlink(address.c_str());
+        }
+        return completed >= job.games;
+    }
+
+    int work(const std::string &address)
+    {
+        int fd = -1;
+        for (int attempt = 0; attempt < 50 && fd < 0; ++attempt)
+        {
+            fd = net::openSocket(address, false);
+            if (fd < 0)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+        }
+        if (fd < 0)
+        {
+            std::cout << "Cannot connect to " << address << '\n';
+            return 1;
+        }
+
+        Job job;
+        std::string buffer;
+        std::string line;
+        while (net::receive(fd, buffer))
+        {
+            while (net::takeLine(buffer, line))
+            {
+                std::istringstream message(line);
+                std::string kind;
+                message >> kind;
+                if (kind == "CONFIG")
+                {
+                    std::string first;
+                    std::string second;
+                    message >> job.config.width >> job.config.height >> job.config.mines >> first >> second >> job.seed;
+                    cpu::parseStrategy(first, job.first);
+                    cpu::parseStrategy(second, job.second);
+                }
+                else if (kind == "RANGE")
+                {
+                    std::uint64_t first = 0;
+                    std::uint64_t count = 0;
+                    message >> first >> count;
+                    const Stats stats = playRange(job, first, count);
+                    std::ostringstream reply;
+                    reply << "RESULT " << first << ' ' << count << ' ' << stats.wins << ' ' << stats.draws << ' ' << stats.losses << ' ' << stats.rounds;
+                    if (!net::sendLine(fd, reply.str()))
+                    {
+                        close(fd);
+                        return 1;
+                    }
+                }
+                else if (kind == "DONE")
+                {
+                    close(fd);
+                    return 0;
+                }
+            }
+        }
+        close(fd);
+        return 0;
+    }
+#endif
+}
@@ -0,0 +1,401 @@
+#include "minefield/engine/sim.h"
+
+#include "minefield/engine/game.h"
+#include "minefield/engine/partition.h"
+#include "minefield/engine/utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+
+namespace sim
+{
+    Board makeBoard(const GameConfig &config)
+    {
+        return Board(config.width, config.height, Board::kMaxSimulationSize);
+    }
+
+    void collectCpuPositions(const Seat &seat, Player &player, unsigned int count, Board &board, unsigned int round, std::vector<Position> &targetList, bool markMinesOnBoard)
+    {
+        targetList.clear();
+        const unsigned int wanted = std::min(count, utils::countFreeCells(board));
+        const std::uint64_t phaseSeed = utils::mixSeed(seat.seed, 2ULL * round + (markMinesOnBoard ? 0 : 1));
+        while (targetList.size() < wanted)
+        {
+            const std::uint64_t decisionSeed = utils::mixSeed(phaseSeed, targetList.size());
+            Position pos;
+            if (markMinesOnBoard)
+            {
+                pos = cpu::choosePlacement(seat.strategy, player, board, targetList, decisionSeed, seat.antithetic);
+                utils::safeCellAccess(board, pos.column, pos.row, [](CellStatusFlags &status){ status |= CellStatusFlags::HasMine; });
+            }
+            else
+            {
+                pos = cpu::chooseGuess(seat.strategy, player, board, targetList, decisionSeed, seat.antithetic);
+            }
+            targetList.push_back(pos);
+        }
+    }
+
+    Outcome outcomeOf(const Player &p1, const Player &p2)
+    {
+        if (p1.remainingMines == p2.remainingMines)
+        {
+            return Outcome::Draw;
+        }
+        return (p1.remainingMines > p2.remainingMines) ? Outcome::FirstSeatWins : Outcome::SecondSeatWins;
+    }
+
+    void placeAndGuess(const Seat &first, const Seat &second, Player &p1, Player &p2, Board &board, unsigned int round, RoundRecord *record)
+    {
+        game::clearMines(board);
+        collectCpuPositions(first, p1, p1.remainingMines, board, round, p1.currentMines, true);
+        collectCpuPositions(second, p2, p2.remainingMines, board, round, p2.currentMines, true);
+        if (record)
+        {
+            record->mines1 = p1.currentMines;
+            record->mines2 = p2.currentMines;
+        }
+        partition::detectAndRemoveCollisions(p1, p2, board);
+
+        collectCpuPositions(first, p1, p2.remainingMines, board, round, p1.currentGuesses, false);
+        collectCpuPositions(second, p2, p1.remainingMines, board, round, p2.currentGuesses, false);
+        if (record)
+        {
+            record->guesses1 = p1.currentGuesses;
+            record->guesses2 = p2.currentGuesses;
+        }
+    }
+
+    GameResult playGame(const GameConfig &config, const Seat &first, const Seat &second, GameReplay *replay)
+    {
+        Board board = makeBoard(config);
+        Player p1 = makePlayer(false, "CPU 1", config.mines);
+        Player p2 = makePlayer(false, "CPU 2", config.mines);
+        std::ostream &quiet = utils::nullStream();
+
+        GameResult result;
+        bool finished = false;
+        while (!finished)
+        {
+            result.rounds++;
+            RoundRecord *record = nullptr;
+            if (replay)
+            {
+                replay->rounds.emplace_back();
+                record = &replay->rounds.back();
+            }
+            placeAndGuess(first, second, p1, p2, board, result.rounds, record);
+            partition::resolveGuesses(p1, p2, board);
+
+            finished = game::checkGameEnd(p1, p2, quiet) || utils::countFreeCells(board) == 0;
+        }
+        result.outcome = outcomeOf(p1, p2);
+        if (replay)
+        {
+            replay->config = config;
+            replay->first = first;
+            replay->second = second;
+            replay->result = result;
+        }
+        return result;
+    }
+
+    double scoreFor(const GameResult &result, bool firstSeat)
+    {
+        if (result.outcome == Outcome::Draw)
+        {
+            return 0.5;
+        }
+        return ((result.outcome == Outcome::FirstSeatWins) == firstSeat) ? 1.0 : 0.0;
+    }
+
+    ComparisonReport compareStrategies(const GameConfig &config, CpuStrategy candidate, CpuStrategy incumbent, CpuStrategy reference, unsigned int pairs, std::uint64_t seed)
+    {
+        constexpr unsigned int kGamesPerSide = 4;
+
+        double sumCandidate = 0.0;
+        double sumSqCandidate = 0.0;
+        double sumIncumbent = 0.0;
+        double sumSqIncumbent = 0.0;
+        double sumDiff = 0.0;
+        double sumSqDiff = 0.0;
+
+        for (unsigned int i = 0; i < pairs; ++i)
+        {
+            const std::uint64_t testedSeed = utils::mixSeed(seed, 2ULL * i);
+            const std::uint64_t referenceSeed = utils::mixSeed(seed, 2ULL * i + 1);
+            double pairCandidate = 0.0;
+            double pairIncumbent = 0.0;
+
+            for (const bool antithetic : {false, true})
+            {
+                for (const bool testedFirst : {true, false})
+                {
+                    // the swapped game also swaps seeds, so it mirrors the original seat for seat
+                    const Seat opponent = {reference, testedFirst ? referenceSeed : testedSeed, antithetic};
+                    for (const bool isCandidate : {true, false})
+                    {
+                        const Seat seat = {isCandidate ? candidate : incumbent, testedFirst ? testedSeed : referenceSeed, antithetic};
+                        const GameResult result = testedFirst ? playGame(config, seat, opponent) : playGame(config, opponent, seat);
+                        const double score = scoreFor(result, testedFirst);
+                        if (isCandidate)
+                        {
+                            pairCandidate += score;
+                            sumCandidate += score;
+                            sumSqCandidate += score * score;
+                        }
+                        else
+                        {
+                            pairIncumbent += score;
+                            sumIncumbent += score;
+                            sumSqIncumbent += score * score;
+                        }
+                    }
+                }
+            }
+
+            const double diff = (pairCandidate - pairIncumbent) / kGamesPerSide;
+            sumDiff += diff;
+            sumSqDiff += diff * diff;
+        }
+
+        ComparisonReport report;
+        report.candidate = candidate;
+        report.incumbent = incumbent;
+        report.reference = reference;
+        report.pairs = pairs;
+        report.games = pairs * kGamesPerSide * 2;
+        if (pairs < 2)
+        {
+            return report;
+        }
+
+        const double n = pairs;
+        const double gamesPerSide = n * kGamesPerSide;
+        report.candidateScore = sumCandidate / gamesPerSide;
+        report.incumbentScore = sumIncumbent / gamesPerSide;
+        report.difference = sumDiff / n;
+
+        const double varCandidate = (sumSqCandidate - gamesPerSide * report.candidateScore * report.candidateScore) / (gamesPerSide - 1);
+        const double varIncumbent = (sumSqIncumbent - gamesPerSide * report.incumbentScore * report.incumbentScore) / (gamesPerSide - 1);
+        const double varDiff = (sumSqDiff - n * report.difference * report.difference) / (n - 1);
+        report.standardError = std::sqrt(std::max(varDiff, 0.0) / n);
+
+        // independent sampling with the same games: var = (varCandidate + varIncumbent) / gamesPerSide
+        const double independentVariance = (varCandidate + varIncumbent) / gamesPerSide;
+        const double pairedVariance = varDiff / n;
+        report.varianceReduction = (pairedVariance > 0.0) ? independentVariance / pairedVariance : std::numeric_limits<double>::infinity();
+        return report;
+    }
+
+    std::ostream &operator<<(std::ostream &stream, const ComparisonReport &report)
+    {
+        constexpr double kZ95 = 1.96;
+        stream << "\n === STRATEGY COMPARISON === \n";
+        stream << "candidate " << cpu::strategyName(report.candidate) << " vs incumbent " << cpu::strategyName(report.incumbent)
+               << ", both against " << cpu::strategyName(report.reference) << '\n';
+        stream << "pairs: " << report.pairs << ", games: " << report.games << '\n';
+        stream << std::fixed << std::setprecision(4);
+        stream << "candidate score: " << report.candidateScore << '\n';
+        stream << "incumbent score: " << report.incumbentScore << '\n';
+        stream << "difference:      " << report.difference << " +/- " << kZ95 * report.standardError << " (95%)\n";
+        stream << std::setprecision(2);
+        stream << "variance reduction vs independent runs: x" << report.varianceReduction << '\n';
+        if (report.difference != 0.0)
+        {
+            // paired games needed for the observed difference to clear the 95% interval
+            const double pairsNeeded = std::ceil(kZ95 * kZ95 * report.standardError * report.standardError * report.pairs / (report.difference * report.difference));
+            const double pairedGames = pairsNeeded * report.games / std::max(report.pairs, 1U);
+            stream << std::setprecision(0);
+            stream << "games to resolve the difference: " << pairedGames << " paired, ~" << pairedGames * report.varianceReduction << " independent\n";
+        }
+        stream.unsetf(std::ios::floatfield);
+        stream << std::setprecision(6);
+        return stream;
+    }
+
+    unsigned int defaultWorkerCount()
+    {
+        return std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    WorkerPool::WorkerPool(unsigned int workers)
+    {
+        for (unsigned int w = 0; w < std::max(workers, 1U); ++w)
+        {
+            threads.emplace_back([this]{ work(); });
+        }
+    }
+
+    WorkerPool::~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closing = true;
+        }
+        jobAvailable.notify_all();
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    void WorkerPool::submit(std::function<void()> job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.push_back(std::move(job));
+            pending++;
+        }
+        jobAvailable.notify_one();
+    }
+
+    void WorkerPool::wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        allDone.wait(lock, [this]{ return pending == 0; });
+    }
+
+    void WorkerPool::work()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true)
+        {
+            jobAvailable.wait(lock, [this]{ return closing || !jobs.empty(); });
+            if (jobs.empty())
+            {
+                return;
+            }
+            std::function<void()> job = std::move(jobs.front());
+            jobs.pop_front();
+            lock.unlock();
+            job();
+            lock.lock();
+            if (--pending == 0)
+            {
+                allDone.notify_all();
+            }
+        }
+    }
+
+    GameResult playMatchGame(const GameConfig &config, CpuStrategy a, CpuStrategy b, std::uint64_t seed, std::uint64_t index, bool &aFirst)
+    {
+        const std::uint64_t pair = index / 2;
+        aFirst = (index % 2 == 0);
+        const Seat first = {aFirst ? a : b, utils::mixSeed(seed, 2 * pair), false};
+        const Seat second = {aFirst ? b : a, utils::mixSeed(seed, 2 * pair + 1), false};
+        return playGame(config, first, second);
+    }
+
+    SprtReport runSprt(const GameConfig &config, CpuStrategy a, CpuStrategy b, const SprtSettings &settings)
+    {
+        SprtReport report;
+        report.first = a;
+        report.second = b;
+        report.settings = settings;
+        report.lowerBound = std::log(settings.beta / (1.0 - settings.alpha));
+        report.upperBound = std::log((1.0 - settings.beta) / settings.alpha);
+
+        const double s0 = 0.5;
+        const double s1 = 0.5 + settings.delta;
+        constexpr std::uint64_t kMinGames = 20;
+
+        auto play = [&](std::uint64_t index)
+        {
+            bool aFirst = true;
+            GameResult result = playMatchGame(config, a, b, settings.seed, index, aFirst);
+            // encode A's point of view so the consumer does not need the seat
+            if (!aFirst && result.outcome != Outcome::Draw)
+            {
+                result.outcome = (result.outcome == Outcome::FirstSeatWins) ? Outcome::SecondSeatWins : Outcome::FirstSeatWins;
+            }
+            return result;
+        };
+        auto consume = [&](std::uint64_t, const GameResult &result)
+        {
+            report.tally.add(scoreFor(result, true));
+            const double variance = report.tally.variance();
+            if (report.tally.games() < kMinGames || variance <= 0.0)
+            {
+                return true;
+            }
+            const double n = static_cast<double>(report.tally.games());
+            report.llr = n * (s1 - s0) * (2.0 * report.tally.mean() - s0 - s1) / (2.0 * variance);
+            if (report.llr >= report.upperBound)
+            {
+                report.decision = SprtDecision::AcceptH1;
+            }
+            else if (report.llr <= report.lowerBound)
+            {
+                report.decision = SprtDecision::AcceptH0;
+            }
+            return report.decision == SprtDecision::Undecided;
+        };
+        runParallel(settings.workers, settings.maxGames, play, consume);
+        return report;
+    }
+
+    std::ostream &operator<<(std::ostream &stream, const SprtReport &report)
+    {
+        stream << "\n === SPRT MATCH === \n";
+        stream << cpu::strategyName(report.first) << " vs " << cpu::strategyName(report.second) << ", H1: score >= " << 0.5 + report.settings.delta
+               << " (alpha " << report.settings.alpha << ", beta " << report.settings.beta << ")\n";
+        stream << "games: " << report.tally.games() << " (W " << report.tally.wins << " / D " << report.tally.draws << " / L " << report.tally.losses << ")\n";
+        stream << "score: " << report.tally.mean() << '\n';
+        stream << "LLR: " << report.llr << " in [" << report.lowerBound << ", " << report.upperBound << "]\n";
+        switch (report.decision)
+        {
+        case SprtDecision::AcceptH1:
+            stream << "decision: H1, " << cpu::strategyName(report.first) << " is stronger\n";
+            break;
+        case SprtDecision::AcceptH0:
+            stream << "decision: H0, no gain of " << report.settings.delta << " or more\n";
+            break;
+        case SprtDecision::Undecided:
+        default:
+            stream << "decision: none after " << report.settings.maxGames << " games\n";
+            break;
+        }
+        return stream;
+    }
+
+    PrecisionReport estimateScore(const GameConfig &config, CpuStrategy first, CpuStrategy second, const PrecisionSettings &settings)
+    {
+        constexpr double kZ95 = 1.96;
+        PrecisionReport report;
+        report.first = first;
+        report.second = second;
+        report.settings = settings;
+
+        auto play = [&](std::uint64_t index)
+        {
+            const Seat seat1 = {first, utils::mixSeed(settings.seed, 2 * index), false};
+            const Seat seat2 = {second, utils::mixSeed(settings.seed, 2 * index + 1), false};
+            return playGame(config, seat1, seat2);
+        };
+        auto consume = [&](std::uint64_t, const GameResult &result)
+        {
+            report.tally.add(scoreFor(result, true));
+            report.halfWidth = kZ95 * std::sqrt(report.tally.variance() / static_cast<double>(report.tally.games()));
+            report.reached = report.tally.games() >= settings.minGames && report.halfWidth < settings.epsilon;
+            return !report.reached;
+        };
+        runParallel(settings.workers, settings.maxGames, play, consume);
+        return report;
+    }
+
+    std::ostream &operator<<(std::ostream &stream, const PrecisionReport &report)
+    {
+        stream << "\n === SCORE ESTIMATE === \n";
+        stream << cpu::strategyName(report.first) << " (first seat) vs " << cpu::strategyName(report.second) << '\n';
+        stream << "games: " << report.tally.games() << " (W " << report.tally.wins << " / D " << report.tally.draws << " / L " << report.tally.losses << ")\n";
+        stream << "score: " << report.tally.mean() << " +/- " << report.halfWidth << " (95%)\n";
+        if (!report.reached)
+        {
+            stream << "target +/- " << report.settings.epsilon << " not reached within " << report.settings.maxGames << " games\n";
+        }
+        return stream;
+    }
+}
@@ -0,0 +1,162 @@
+#include "minefield/engine/sweep.h"
+
+#include "minefield/engine/utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+namespace sweep
+{
+    double halfWidth(const Point &point)
+    {
+        constexpr double kZ95 = 1.96;
+        const double games = static_cast<double>(point.tally.games());
+        return (games > 1) ? kZ95 * std::sqrt(point.tally.variance() / games) : 1.0;
+    }
+
+    double priority(const Point &point, double threshold)
+    {
+        const double width = halfWidth(point);
+        const bool straddles = std::abs(point.tally.mean() - threshold) <= width;
+        return straddles ? 2.0 * width : width;
+    }
+
+    void writeHeader(std::ostream &out)
+    {
+        out << "width,height,mines,games,score,half_width,first_wins,draws,second_wins,mean_rounds,status\n";
+    }
+
+    void writePoint(std::ostream &out, const Point &point, double threshold)
+    {
+        const double games = static_cast<double>(std::max<std::uint64_t>(point.tally.games(), 1));
+        const double score = point.tally.mean();
+        const char *status = "unresolved";
+        if (point.resolved)
+        {
+            status = (std::abs(score - threshold) <= halfWidth(point)) ? "balanced" : (score > threshold ? "first" : "second");
+        }
+        out << point.config.width << ',' << point.config.height << ',' << point.config.mines << ',' << point.tally.games() << ',' << score << ','
+            << halfWidth(point) << ',' << point.tally.wins / games << ',' << point.tally.draws / games << ',' << point.tally.losses / games << ','
+            << point.rounds / games << ',' << status << '\n';
+        out.flush();
+    }
+
+    // plays count games of one configuration starting at game index firstGame and folds them into the point
+    void playBatch(const Settings &settings, std::size_t pointIndex, Point &point, std::uint64_t firstGame, std::uint64_t count, std::mutex &mutex)
+    {
+        const std::uint64_t configSeed = utils::mixSeed(settings.seed, pointIndex);
+        sim::MatchTally tally;
+        double rounds = 0.0;
+        for (std::uint64_t g = firstGame; g < firstGame + count; ++g)
+        {
+            const sim::Seat seat1 = {settings.first, utils::mixSeed(configSeed, 2 * g), false};
+            const sim::Seat seat2 = {settings.second, utils::mixSeed(configSeed, 2 * g + 1), false};
+            const sim::GameResult result = sim::playGame(point.config, seat1, seat2);
+            tally.add(sim::scoreFor(result, true));
+            rounds += result.rounds;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        point.tally.wins += tally.wins;
+        point.tally.draws += tally.draws;
+        point.tally.losses += tally.losses;
+        point.tally.sum += tally.sum;
+        point.tally.sumSq += tally.sumSq;
+        point.rounds += rounds;
+    }
+
+    std::vector<Point> run(const Settings &settings, std::ostream &out, std::ostream &progress)
+    {
+        constexpr std::uint64_t kGamesPerJob = 64;
+
+        std::vector<Point> points;
+        for (const unsigned int size : settings.sizes)
+        {
+            for (const unsigned int mines : settings.mines)
+            {
+                if (size >= Board::kMinSize && size <= Board::kMaxSimulationSize && mines >= 1 && mines <= size * size)
+                {
+                    Point point;
+                    point.config = {size, size, mines};
+                    points.push_back(point);
+                }
+            }
+        }
+
+        writeHeader(out);
+        sim::WorkerPool pool(settings.workers);
+        std::mutex mutex;
+        std::uint64_t spent = 0;
+        unsigned int step = 0;
+
+        while (spent < settings.budget)
+        {
+            // allocation: untouched points get the initial batch, the rest share batchGames by priority
+            std::vector<std::pair<std::size_t, std::uint64_t>> allocation;
+            double totalPriority = 0.0;
+            for (const auto &point : points)
+            {
+                if (!point.resolved && point.nextGame > 0)
+                {
+                    totalPriority += priority(point, settings.threshold);
+                }
+            }
+            for (std::size_t p = 0; p < points.size(); ++p)
+            {
+                if (points[p].resolved)
+                {
+                    continue;
+                }
+                std::uint64_t games = settings.initialGames;
+                if (points[p].nextGame > 0)
+                {
+                    const double share = priority(points[p], settings.threshold) / totalPriority;
+                    games = std::max<std::uint64_t>(kGamesPerJob, static_cast<std::uint64_t>(share * settings.batchGames));
+                }
+                games = std::min(games, settings.budget - spent);
+                if (games > 0)
+                {
+                    allocation.emplace_back(p, games);
+                    spent += games;
+                }
+            }
+            if (allocation.empty())
+            {
+                break;
+            }
+
+            for (const auto &[p, games] : allocation)
+            {
+                for (std::uint64_t offset = 0; offset < games; offset += kGamesPerJob)
+                {
+                    const std::uint64_t first = points[p].nextGame + offset;
+                    const std::uint64_t count = std::min(kGamesPerJob, games - offset);
+                    pool.submit([&settings, &points, &mutex, p, first, count]{ playBatch(settings, p, points[p], first, count, mutex); });
+                }
+                points[p].nextGame += games;
+            }
+            pool.wait();
+
+            unsigned int open = 0;
+            for (auto &point : points)
+            {
+                if (!point.resolved && halfWidth(point) < settings.epsilon)
+                {
+                    point.resolved = true;
+                    writePoint(out, point, settings.threshold);
+                }
+                open += point.resolved ? 0 : 1;
+            }
+            progress << "step " << ++step << ": " << spent << " games played, " << open << " of " << points.size() << " configurations open\n";
+        }
+
+        for (const auto &point : points)
+        {
+            if (!point.resolved)
+            {
+                writePoint(out, point, settings.threshold);
+            }
+        }
+        return points;
+    }
+}
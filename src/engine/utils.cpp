@@ -0,0 +1,202 @@
+#include "minefield/engine/utils.h"
+
+#include "minefield/engine/parallel.h"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+namespace utils
+{
+    void clearInput()
+    {
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+
+    Position generateRandomPosition(const Board &board)
+    {
+        Position pos;
+        bool found = false;
+        while (!found)
+        {
+            pos.column = rand() % board.getWidth();
+            pos.row = rand() % board.getHeight();
+            if (!board.isDisabled(pos.column, pos.row))
+            {
+                found = true;
+            }
+        }
+        return pos;
+    }
+
+    std::vector<Position> collectFreeCells(const Board &board, const std::vector<Position> &skip)
+    {
+        std::vector<Position> cells;
+        for (unsigned int c = 0; c < board.getWidth(); ++c)
+        {
+            for (unsigned int r = 0; r < board.getHeight(); ++r)
+            {
+                const Position pos = {c, r};
+                bool skipped = std::any_of(skip.begin(), skip.end(), [&](const Position &p){ return samePosition(p, pos); });
+                if (!board.isDisabled(c, r) && !skipped)
+                {
+                    cells.push_back(pos);
+                }
+            }
+        }
+        return cells;
+    }
+
+    unsigned int countFreeCells(const Board &board)
+    {
+        return parallel::sumChunks<unsigned int>(board.getWidth(), board.getHeight(), [&board](std::size_t first, std::size_t last)
+            {
+                unsigned int count = 0;
+                for (std::size_t c = first; c < last; ++c)
+                {
+                    for (unsigned int r = 0; r < board.getHeight(); ++r)
+                    {
+                        if (!board.isDisabled(static_cast<unsigned int>(c), r))
+                        {
+                            count++;
+                        }
+                    }
+                }
+                return count;
+            });
+    }
+
+    Position pickByKey(const Board &board, const std::vector<Position> &candidates, std::uint64_t decisionSeed, bool antithetic)
+    {
+        Position best = candidates.front();
+        std::uint64_t bestKey = 0;
+        bool first = true;
+        for (const auto &cell : candidates)
+        {
+            const std::uint64_t key = mixSeed(decisionSeed, static_cast<std::uint64_t>(cell.row) * board.getWidth() + cell.column);
+            if (first || (antithetic ? key > bestKey : key < bestKey))
+            {
+                best = cell;
+                bestKey = key;
+                first = false;
+            }
+        }
+        return best;
+    }
+
+    std::ostream &nullStream()
+    {
+        thread_local std::ostream stream(nullptr);
+        return stream;
+    }
+
+    std::vector<Position> removeCollidingMines(const std::vector<Position> &ownMines, const std::vector<Position> &opponentMines, std::vector<Position> &collisions, Board &board)
+    {
+        std::vector<Position> result;
+        for (const auto &mine : ownMines)
+        {
+            bool found = false;
+
+            for (const auto &oppMine : opponentMines)
+            {
+                if (utils::samePosition(mine, oppMine))
+                {
+                    found = true;
+                    collisions.push_back(mine);
+                    utils::safeCellAccess(board, mine.column, mine.row, [](CellStatusFlags &status)
+                        {
+                            status |= CellStatusFlags::HadCollision;
+                            status |= CellStatusFlags::Disabled;
+                            status = status & ~CellStatusFlags::HasMine; 
+                        });
+                    break;
+                }
+            }
+            if (!found)
+            {
+                result.push_back(mine);
+            }
+        }
+        return result;
+    }
+
+    std::vector<Position> keepNonCollidingMines(const std::vector<Position> &ownMines, const std::vector<Position> &opponentMines)
+    {
+        std::vector<Position> result;
+
+        for (const auto &mine : ownMines)
+        {
+            bool found = false;
+            for (const auto &oppMine : opponentMines)
+            {
+                if (samePosition(mine, oppMine))
+                {
+                    found = true;
+                    break;
+                }
+            }
+            if (!found)
+            {
+                result.push_back(mine);
+            }
+        }
+        return result;
+    }
+
+    Position requestPosition(const std::string &prompt, const Board &board)
+    {
+        unsigned int col = 0;
+        unsigned int row = 0;
+        bool valid = false;
+
+        while (!valid)
+        {
+            std::cout << prompt << " --> [column] [row] \nInput example: 2 5\n> ";
+            std::cin >> col >> row;
+            if (std::cin.fail())
+            {
+                std::cout << "Invalid input.\n";
+                clearInput();
+                continue;
+            }
+            col--;
+            row--;
+            if (!board.isValidPosition(col, row) || board.isDisabled(col, row))
+            {
+                std::cout << "\nPosition invalid or already used.\n";
+            }
+            else
+            {
+                valid = true;
+            }
+        }
+        return {col, row};
+    }
+
+    unsigned int chooseValidDimension(const std::string &prompt, int min_val, int max_val)
+    {
+        unsigned int input = 0;
+        bool validInput = false;
+        while (!validInput)
+        {
+            std::cout << prompt << " (" << min_val << "-" << max_val << ")\n> ";
+            std::cin >> input;
+            if (std::cin.fail())
+            {
+                std::cout << "\nInvalid input. Please enter a number.\n";
+                clearInput();
+                input = 0;
+            }
+            else if (input <static_cast<unsigned int>(min_val) || input> static_cast<unsigned int>(max_val))
+            {
+                std::cout << "\nInvalid input. Please enter a value between " << min_val << " and " << max_val << ".\n";
+            }
+            else
+            {
+                validInput = true;
+            }
+        }
+        return input;
+    }
+}
@@ -0,0 +1,74 @@
+#include "minefield/heapfree/fixed.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+// Plays games on the heap-free core and prints the tally and the last events of the final game:
+//   minefield.heapfree [games] [seed]
+// Seats are seeded like the engine's match commands, cautious first against random, on 4x4 boards with 3 mines.
+// The point of the executable is its link: with the heap-free check on, every allocation function is
+// wrapped to an undefined symbol, so nothing reachable from here may allocate.
+
+constexpr unsigned int kWidth = 4;
+constexpr unsigned int kHeight = 4;
+constexpr unsigned int kMines = 3;
+constexpr std::size_t kKeptEvents = 32;
+
+static heapfree::EventRing<kKeptEvents> events;
+
+const char *eventName(heapfree::EventKind kind)
+{
+    switch (kind)
+    {
+    case heapfree::EventKind::Placed:
+        return "placed";
+    case heapfree::EventKind::Collision:
+        return "collision";
+    case heapfree::EventKind::Guessed:
+        return "guessed";
+    case heapfree::EventKind::Hit:
+        return "hit";
+    case heapfree::EventKind::SelfDetonated:
+    default:
+        return "self-detonated";
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const std::uint64_t games = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    const std::uint64_t seed = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 1;
+    const sim::GameConfig config = {kWidth, kHeight, kMines};
+
+    std::uint64_t outcomes[3] = {0, 0, 0};
+    std::uint64_t rounds = 0;
+    for (std::uint64_t g = 0; g < games; ++g)
+    {
+        const sim::Seat first = {CpuStrategy::Cautious, utils::mixSeed(seed, 2 * g), false};
+        const sim::Seat second = {CpuStrategy::Random, utils::mixSeed(seed, 2 * g + 1), false};
+        sim::GameResult result;
+        events.clear();
+        if (!heapfree::playGame<kWidth, kHeight, kMines>(config, first, second, result, events))
+        {
+            std::printf("The configuration does not fit the board capacity\n");
+            return 1;
+        }
+        outcomes[static_cast<std::size_t>(result.outcome)]++;
+        rounds += result.rounds;
+    }
+
+    std::printf("games: %llu, first seat wins: %llu, draws: %llu, second seat wins: %llu, mean rounds: %.3f\n", static_cast<unsigned long long>(games),
+        static_cast<unsigned long long>(outcomes[1]), static_cast<unsigned long long>(outcomes[0]), static_cast<unsigned long long>(outcomes[2]),
+        games ? static_cast<double>(rounds) / static_cast<double>(games) : 0.0);
+    if (games > 0)
+    {
+        std::printf("last game, %llu earlier events dropped:\n", static_cast<unsigned long long>(events.dropped()));
+        for (std::size_t i = 0; i < events.size(); ++i)
+        {
+            const heapfree::Event &event = events[i];
+            std::printf("  round %u, seat %u %s (%u, %u)\n", event.round, event.seat + 1U, eventName(event.kind), event.position.column + 1, event.position.row + 1);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,908 @@
+#include "minefield/engine/analysis.h"
+#include "minefield/engine/analytic.h"
+#include "minefield/engine/api.h"
+#include "minefield/engine/archive.h"
+#include "minefield/engine/board.h"
+#include "minefield/engine/catalog.h"
+#include "minefield/engine/columnar.h"
+#include "minefield/engine/cpu.h"
+#include "minefield/engine/explore.h"
+#include "minefield/engine/game.h"
+#include "minefield/engine/luck.h"
+#include "minefield/engine/numa.h"
+#include "minefield/engine/player.h"
+#include "minefield/engine/shard.h"
+#include "minefield/engine/sim.h"
+#include "minefield/engine/sweep.h"
+#include "minefield/engine/utils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+// command line entry points: minefield <command> [--option value]...
+namespace tools
+{
+    struct Options
+    {
+        std::string command;
+        std::map<std::string, std::string> values;
+    };
+
+    bool parseOptions(int argc, char *argv[], Options &options)
+    {
+        options.command = argv[1];
+        for (int i = 2; i < argc; i += 2)
+        {
+            const std::string key = argv[i];
+            if (key.rfind("--", 0) != 0 || i + 1 >= argc)
+            {
+                std::cout << "Invalid option: " << key << '\n';
+                return false;
+            }
+            options.values[key.substr(2)] = argv[i + 1];
+        }
+        return true;
+    }
+
+    std::uint64_t getNumber(const Options &options, const std::string &key, std::uint64_t fallback)
+    {
+        auto it = options.values.find(key);
+        return (it != options.values.end()) ? std::stoull(it->second) : fallback;
+    }
+
+    bool getStrategy(const Options &options, const std::string &key, CpuStrategy fallback, CpuStrategy &strategy)
+    {
+        auto it = options.values.find(key);
+        if (it == options.values.end())
+        {
+            strategy = fallback;
+            return true;
+        }
+        if (!cpu::parseStrategy(it->second, strategy))
+        {
+            std::cout << "Unknown strategy: " << it->second << '\n';
+            return false;
+        }
+        return true;
+    }
+
+    sim::GameConfig getGameConfig(const Options &options)
+    {
+        sim::GameConfig config;
+        config.width = static_cast<unsigned int>(getNumber(options, "width", config.width));
+        config.height = static_cast<unsigned int>(getNumber(options, "height", config.height));
+        config.mines = static_cast<unsigned int>(getNumber(options, "mines", config.mines));
+        return config;
+    }
+
+    // every reachable round start state of a small board, checked against the rule invariants
+    int runExplore(const Options &options)
+    {
+        explore::Settings settings;
+        settings.config = getGameConfig(options);
+        settings.config.mines = static_cast<unsigned int>(getNumber(options, "mines", 1));
+        settings.workers = static_cast<unsigned int>(getNumber(options, "threads", sim::defaultWorkerCount()));
+        settings.maxMoveClasses = getNumber(options, "max-classes", settings.maxMoveClasses);
+        settings.maxTraces = static_cast<unsigned int>(getNumber(options, "traces", settings.maxTraces));
+
+        const auto start = std::chrono::steady_clock::now();
+        const explore::Report report = explore::exploreStates(settings);
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << report << "explored in " << elapsed.count() << " ms\n";
+
+        const bool violated = std::any_of(report.violations.begin(), report.violations.end(), [](std::uint64_t count){ return count > 0; });
+        return violated ? 1 : 0;
+    }
+
+    int runCompare(const Options &options)
+    {
+        CpuStrategy candidate;
+        CpuStrategy incumbent;
+        CpuStrategy reference;
+        if (!getStrategy(options, "candidate", CpuStrategy::Cautious, candidate) || !getStrategy(options, "incumbent", CpuStrategy::Random, incumbent)
+            || !getStrategy(options, "reference", CpuStrategy::Random, reference))
+        {
+            return 1;
+        }
+        const unsigned int pairs = static_cast<unsigned int>(getNumber(options, "pairs", 10000));
+        const std::uint64_t seed = getNumber(options, "seed", static_cast<std::uint64_t>(std::time(nullptr)));
+        std::cout << sim::compareStrategies(getGameConfig(options), candidate, incumbent, reference, pairs, seed);
+        return 0;
+    }
+
+    double getReal(const Options &options, const std::string &key, double fallback)
+    {
+        auto it = options.values.find(key);
+        return (it != options.values.end()) ? std::stod(it->second) : fallback;
+    }
+
+    int runSprt(const Options &options)
+    {
+        CpuStrategy a;
+        CpuStrategy b;
+        if (!getStrategy(options, "a", CpuStrategy::Cautious, a) || !getStrategy(options, "b", CpuStrategy::Random, b))
+        {
+            return 1;
+        }
+        sim::SprtSettings settings;
+        settings.delta = getReal(options, "delta", settings.delta);
+        settings.alpha = getReal(options, "alpha", settings.alpha);
+        settings.beta = getReal(options, "beta", settings.beta);
+        settings.maxGames = getNumber(options, "max-games", settings.maxGames);
+        settings.workers = static_cast<unsigned int>(getNumber(options, "threads", sim::defaultWorkerCount()));
+        settings.seed = getNumber(options, "seed", static_cast<std::uint64_t>(std::time(nullptr)));
+        std::cout << sim::runSprt(getGameConfig(options), a, b, settings);
+        return 0;
+    }
+
+    int runEstimate(const Options &options)
+    {
+        CpuStrategy first;
+        CpuStrategy second;
+        if (!getStrategy(options, "first", CpuStrategy::Random, first) || !getStrategy(options, "second", CpuStrategy::Random, second))
+        {
+            return 1;
+        }
+        sim::PrecisionSettings settings;
+        settings.epsilon = getReal(options, "epsilon", settings.epsilon);
+        settings.minGames = getNumber(options, "min-games", settings.minGames);
+        settings.maxGames = getNumber(options, "max-games", settings.maxGames);
+        settings.workers = static_cast<unsigned int>(getNumber(options, "threads", sim::defaultWorkerCount()));
+        settings.seed = getNumber(options, "seed", static_cast<std::uint64_t>(std::time(nullptr)));
+        std::cout << sim::estimateScore(getGameConfig(options), first, second, settings);
+        return 0;
+    }
+
+    // exact Random-vs-Random outcome, optionally checked against a Monte Carlo run of the simulator
+    int runExact(const Options &options)
+    {
+        const sim::GameConfig config = getGameConfig(options);
+        const auto start = std::chrono::steady_clock::now();
+        const analytic::OutcomeDistribution exact = analytic::randomGameOutcome(config);
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::cout << "\n === EXACT RANDOM-VS-RANDOM OUTCOME === \n";
+        std::cout << "first seat wins: " << exact.firstSeatWins << "\ndraws: " << exact.draws << "\nsecond seat wins: " << exact.secondSeatWins
+                  << "\nexpected rounds: " << exact.expectedRounds << "\nsolved in " << elapsed.count() << " ms\n";
+
+        const std::uint64_t games = getNumber(options, "validate", 0);
+        if (games == 0)
+        {
+            return 0;
+        }
+        const std::uint64_t seed = getNumber(options, "seed", static_cast<std::uint64_t>(std::time(nullptr)));
+        sim::MatchTally tally;
+        double rounds = 0.0;
+        auto play = [&](std::uint64_t index)
+        {
+            const sim::Seat first = {CpuStrategy::Random, utils::mixSeed(seed, 2 * index), false};
+            const sim::Seat second = {CpuStrategy::Random, utils::mixSeed(seed, 2 * index + 1), false};
+            return sim::playGame(config, first, second);
+        };
+        auto consume = [&](std::uint64_t, const sim::GameResult &result)
+        {
+            tally.add(sim::scoreFor(result, true));
+            rounds += result.rounds;
+            return true;
+        };
+        sim::runParallel(static_cast<unsigned int>(getNumber(options, "threads", sim::defaultWorkerCount())), games, play, consume);
+
+        const double n = static_cast<double>(tally.games());
+        auto deviation = [&](double simulated, double expected)
+        {
+            // distance in standard errors of a binomial proportion
+            const double error = std::sqrt(std::max(expected * (1.0 - expected), 1e-12) / n);
+            return (simulated - expected) / error;
+        };
+        std::cout << "\n === SIMULATED (" << tally.games() << " games) === \n";
+        std::cout << "first seat wins: " << tally.wins / n << " (" << deviation(tally.wins / n, exact.firstSeatWins) << " sigma)\n";
+        std::cout << "draws: " << tally.draws / n << " (" << deviation(tally.draws / n, exact.draws) << " sigma)\n";
+        std::cout << "second seat wins: " << tally.losses / n << " (" << deviation(tally.losses / n, exact.secondSeatWins) << " sigma)\n";
+        std::cout << "mean rounds: " << rounds / n << '\n';
+        return 0;
+    }
+
+    // plays and records games, then splits every result into skill and luck
+    // recorded games number first to first + count - 1 of a seed
+    std::vector<sim::GameReplay> playReplays(const sim::GameConfig &config, CpuStrategy first, CpuStrategy second, std::uint64_t seed,
+        std::uint64_t firstGame, std::uint64_t count, unsigned int workers)
+    {
+        std::vector<sim::GameReplay> replays(count);
+        sim::runParallel(workers, count,
+            [&](std::uint64_t index)
+            {
+                sim::GameReplay replay;
+                const sim::Seat seat1 = {first, utils::mixSeed(seed, 2 * (firstGame + index)), false};
+                const sim::Seat seat2 = {second, utils::mixSeed(seed, 2 * (firstGame + index) + 1), false};
+                sim::playGame(config, seat1, seat2, &replay);
+                return replay;
+            },
+            [&](std::uint64_t index, const sim::GameReplay &replay)
+            {
+                replays[index] = replay;
+                return true;
+            });
+        return replays;
+    }
+
+    int runLuck(const Options &options)
+    {
+        CpuStrategy first;
+        CpuStrategy second;
+        if (!getStrategy(options, "first", CpuStrategy::Cautious, first) || !getStrategy(options, "second", CpuStrategy::Random, second))
+        {
+            return 1;
+        }
+        const sim::GameConfig config = getGameConfig(options);
+        const std::uint64_t games = getNumber(options, "games", 10000);
+        const std::uint64_t seed = getNumber(options, "seed", static_cast<std::uint64_t>(std::time(nullptr)));
+        const unsigned int workers = static_cast<unsigned int>(getNumber(options, "threads", sim::defaultWorkerCount()));
+
+        const std::vector<sim::GameReplay> archive = playReplays(config, first, second, seed, 0, games, workers);
+
+        luck::ExpectationCache cache(static_cast<unsigned int>(getNumber(options, "samples", 256)),
+            static_cast<std::size_t>(getNumber(options, "cache-entries", luck::ExpectationCache::kDefaultCapacity)));
+        const auto start = std::chrono::steady_clock::now();
+        const std::vector<luck::GameLuck> results = luck::analyzeArchive(archive, cache, workers);
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::cout << results;
+        const cache::Stats cached = cache.stats();
+        std::cout << "states evaluated: " << cached.misses << ", cache hits: " << cached.hits << " (" << 100.0 * cached.hitRate() << "%)"
+                  << ", evictions: " << cached.evictions << ", analyzed in " << elapsed.count() << " ms, sampling saved ~" << cache.savedMilliseconds() << " ms\n";
+
+        const std::uint64_t show = std::min<std::uint64_t>(getNumber(options, "show", 0), results.size());
+        for (std::uint64_t g = 0; g < show; ++g)
+        {
+            std::cout << "\ngame " << g + 1 << ": skill " << results[g].skill << ", luck " << results[g].luck << '\n';
+            for (std::size_t r = 0; r < results[g].rounds.size(); ++r)
+            {
+                const luck::RoundLuck &round = results[g].rounds[r];
+                std::cout << "  round " << r + 1 << ": seat 1 hit " << round.actualHits1 << " (expected " << round.expectedHits1 << "), seat 2 hit "
+                          << round.actualHits2 << " (expected " << round.expectedHits2 << ")\n";
+            }
+        }
+        return 0;
+    }
+
+    // records games into a block-compressed archive, then reads it back to check it and time decoding
+    int runArchive(const Options &options)
+    {
+        CpuStrategy first;
+        CpuStrategy second;
+        if (!getStrategy(options, "first", CpuStrategy::Cautious, first) || !getStrategy(options, "second", CpuStrategy::Random, second))
+        {
+            return 1;
+        }
+        const sim::GameConfig config = getGameConfig(options);
+        const std::uint64_t games = getNumber(options, "games", 100000);
+        const std::uint64_t samples = getNumber(options, "train", 1000);
+        const std::uint64_t seed = getNumber(options, "seed", static_cast<std::uint64_t>(std::time(nullptr)));
+        const unsigned int workers = static_cast<unsigned int>(getNumber(options, "threads", sim::defaultWorkerCount()));
+        const unsigned int blockReplays = static_cast<unsigned int>(getNumber(options, "block", archive::kDefaultBlockReplays));
+        const std::string path = options.values.count("out") ? options.values.at("out") : "minefield-replays.mfra";
+
+        // the dictionary is trained on games played after the archived ones
+        const std::vector<sim::GameReplay> replays = playReplays(config, first, second, seed, 0, games, workers);
+        const archive::Dictionary dictionary = archive::Dictionary::train(playReplays(config, first, second, seed, games, samples, workers));
+
+        archive::Writer writer(path, dictionary, blockReplays);
+        for (const auto &replay : replays)
+        {
+            writer.add(replay);
+        }
+        if (!writer.finish())
+        {
+            std::cout << "Cannot write " << path << '\n';
+            return 1;
+        }
+        std::cout << "Wrote " << path << ", dictionary of " << dictionary.trainedContexts() << " trained contexts from " << samples << " games\n"
+                  << writer.stats();
+
+        archive::Reader reader;
+        if (!reader.open(path))
+        {
+            std::cout << "Cannot read " << path << " back\n";
+            return 1;
+        }
+        std::vector<sim::GameReplay> block;
+        std::string expected;
+        std::string decoded;
+        std::uint64_t mismatches = 0;
+        std::uint64_t rawBytes = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t b = 0; b < reader.blockCount(); ++b)
+        {
+            const archive::BlockInfo &info = reader.block(b);
+            if (!reader.readBlock(b, block))
+            {
+                mismatches += info.replays;
+                continue;
+            }
+            for (std::uint32_t i = 0; i < info.replays; ++i)
+            {
+                expected.clear();
+                decoded.clear();
+                archive::encodeReplay(replays[info.firstReplay + i], expected);
+                archive::encodeReplay(block[i], decoded);
+                mismatches += (expected != decoded) ? 1 : 0;
+            }
+            rawBytes += info.rawSize;
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "Read back " << reader.replayCount() << " games in " << elapsed.count() * 1000 << " ms ("
+                  << rawBytes / 1e6 / elapsed.count() << " MB/s of records, checks included), " << mismatches << " mismatches\n";
+
+        // any single game decodes its block only
+        if (games > 0)
+        {
+            sim::GameReplay replay;
+            const std::uint64_t index = games / 2;
+            const auto lookup = std::chrono::steady_clock::now();
+            const bool found = reader.readReplay(index, replay);
+            const std::chrono::duration<double, std::micro> took = std::chrono::steady_clock::now() - lookup;
+            std::cout << "Game " << index << (found ? " read in " : " not found after ") << took.count() << " us\n";
+            mismatches += found ? 0 : 1;
+        }
+        return mismatches ? 1 : 0;
+    }
+
+    // games of an archive picked through its catalog, which is built on first use
+    int runQuery(const Options &options)
+    {
+        const std::string path = options.values.count("archive") ? options.values.at("archive") : "minefield-replays.mfra";
+        const std::string catalogPath = options.values.count("catalog") ? options.values.at("catalog") : path + ".cat";
+        archive::Reader reader;
+        if (!reader.open(path))
+        {
+            std::cout << "Cannot read " << path << '\n';
+            return 1;
+        }
+        catalog::Catalog index;
+        if (getNumber(options, "rebuild", 0) != 0 || !index.open(catalogPath))
+        {
+            const auto start = std::chrono::steady_clock::now();
+            if (!catalog::build(reader, catalogPath) || !index.open(catalogPath))
+            {
+                std::cout << "Cannot build " << catalogPath << '\n';
+                return 1;
+            }
+            const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            std::cout << "Built " << catalogPath << " in " << elapsed.count() << " ms\n";
+        }
+
+        constexpr const char *kOutcomes[] = {"draw", "first", "second"}; // in sim::Outcome order
+        catalog::Query query;
+        const auto bound = [&](const char *key, unsigned int fallback)
+            {
+                return static_cast<unsigned int>(getNumber(options, key, fallback));
+            };
+        query.width = bound("width", catalog::Query::kAny);
+        query.height = bound("height", catalog::Query::kAny);
+        query.mines = bound("mines", catalog::Query::kAny);
+        query.minRounds = bound("min-rounds", 0);
+        query.maxRounds = bound("max-rounds", catalog::Query::kAny);
+        query.minCollisions = bound("min-collisions", 0);
+        query.maxCollisions = bound("max-collisions", catalog::Query::kAny);
+        if (options.values.count("outcome"))
+        {
+            const std::string &outcome = options.values.at("outcome");
+            query.outcome = static_cast<unsigned int>(std::find(std::begin(kOutcomes), std::end(kOutcomes), outcome) - std::begin(kOutcomes));
+            if (query.outcome == std::size(kOutcomes))
+            {
+                std::cout << "Unknown outcome: " << outcome << " (draw, first or second)\n";
+                return 1;
+            }
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        const catalog::Result result = index.run(query, reader);
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << result << "answered in " << elapsed.count() << " ms\n";
+
+        const std::uint64_t show = std::min<std::uint64_t>(getNumber(options, "show", 10), result.games.size());
+        for (std::uint64_t i = 0; i < show; ++i)
+        {
+            sim::GameReplay replay;
+            if (reader.readReplay(result.games[i], replay))
+            {
+                const catalog::Features features = catalog::featuresOf(replay);
+                std::cout << "  game " << result.games[i] << ": " << features.width << 'x' << features.height << ", " << features.mines << " mines, "
+                          << features.rounds << " rounds, " << features.collisions << " collisions, outcome " << kOutcomes[static_cast<std::size_t>(features.outcome)] << '\n';
+            }
+        }
+        return 0;
+    }
+
+    template <typename StateT>
+    int runAnalysis(const Options &options, const archive::Reader &reader, const analysis::Analysis<StateT> &job)
+    {
+        analysis::Settings settings;
+        settings.workers = static_cast<unsigned int>(getNumber(options, "threads", sim::defaultWorkerCount()));
+        settings.epochBlocks = getNumber(options, "epoch", settings.epochBlocks);
+        settings.checkpoint = options.values.count("checkpoint") ? options.values.at("checkpoint") : "";
+        settings.onProgress = [](const analysis::Progress &progress)
+            {
+                std::cout << "  " << progress.blocksDone << '/' << progress.blocks << " blocks";
+                if (progress.resumedBlocks)
+                {
+                    std::cout << " (" << progress.resumedBlocks << " resumed)";
+                }
+                std::cout << ", " << progress.games << " games in " << progress.seconds << " s, "
+                          << (progress.seconds > 0.0 ? progress.games / progress.seconds : 0.0) << " games/s, " << progress.steals << " steals\n";
+            };
+
+        StateT result;
+        if (!analysis::run(reader, job, settings, result))
+        {
+            std::cout << "Cannot analyze a malformed archive or checkpoint\n";
+            return 1;
+        }
+        std::cout << result;
+        if (!settings.checkpoint.empty())
+        {
+            std::remove(settings.checkpoint.c_str());
+        }
+        return 0;
+    }
+
+    int runAnalyze(const Options &options)
+    {
+        const std::string path = options.values.count("archive") ? options.values.at("archive") : "minefield-replays.mfra";
+        const std::string name = options.values.count("analysis") ? options.values.at("analysis") : "hits";
+        archive::Reader reader;
+        if (!reader.open(path))
+        {
+            std::cout << "Cannot read " << path << '\n';
+            return 1;
+        }
+        if (name == "hits")
+        {
+            return runAnalysis(options, reader, analysis::hitsByRound());
+        }
+        if (name == "heatmap")
+        {
+            return runAnalysis(options, reader, analysis::heatmap());
+        }
+        if (name == "fingerprint")
+        {
+            return runAnalysis(options, reader, analysis::fingerprint());
+        }
+        std::cout << "Unknown analysis: " << name << " (hits, heatmap or fingerprint)\n";
+        return 1;
+    }
+
+    // comma separated list of numbers, e.g. "3,4,8"
+    std::vector<unsigned int> getList(const Options &options, const std::string &key, const std::vector<unsigned int> &fallback)
+    {
+        auto it = options.values.find(key);
+        if (it == options.values.end())
+        {
+            return fallback;
+        }
+        std::vector<unsigned int> values;
+        std::stringstream stream(it->second);
+        std::string item;
+        while (std::getline(stream, item, ','))
+        {
+            values.push_back(static_cast<unsigned int>(std::stoul(item)));
+        }
+        return values;
+    }
+
+    int runSweep(const Options &options)
+    {
+        sweep::Settings settings;
+        if (!getStrategy(options, "first", settings.first, settings.first) || !getStrategy(options, "second", settings.second, settings.second))
+        {
+            return 1;
+        }
+        settings.sizes = getList(options, "sizes", settings.sizes);
+        settings.mines = getList(options, "mines", settings.mines);
+        settings.threshold = getReal(options, "threshold", settings.threshold);
+        settings.epsilon = getReal(options, "epsilon", settings.epsilon);
+        settings.initialGames = getNumber(options, "initial-games", settings.initialGames);
+        settings.batchGames = getNumber(options, "batch-games", settings.batchGames);
+        settings.budget = getNumber(options, "budget", settings.budget);
+        settings.workers = static_cast<unsigned int>(getNumber(options, "threads", sim::defaultWorkerCount()));
+        settings.seed = getNumber(options, "seed", static_cast<std::uint64_t>(std::time(nullptr)));
+
+        auto it = options.values.find("out");
+        if (it == options.values.end())
+        {
+            sweep::run(settings, std::cout, std::cout);
+            return 0;
+        }
+        std::ofstream file(it->second);
+        if (!file)
+        {
+            std::cout << "Cannot open " << it->second << '\n';
+            return 1;
+        }
+        sweep::run(settings, file, std::cout);
+        return 0;
+    }
+
+    // a column table of games played over every --sizes x --mines board, or of the games of --archive
+    int runTable(const Options &options)
+    {
+        const std::string path = options.values.count("out") ? options.values.at("out") : "minefield-results.mfct";
+        columnar::Writer writer(path);
+        const auto start = std::chrono::steady_clock::now();
+        if (options.values.count("archive"))
+        {
+            archive::Reader reader;
+            if (!reader.open(options.values.at("archive")))
+            {
+                std::cout << "Cannot read " << options.values.at("archive") << '\n';
+                return 1;
+            }
+            std::vector<sim::GameReplay> block;
+            for (std::size_t b = 0; b < reader.blockCount(); ++b)
+            {
+                if (!reader.readBlock(b, block))
+                {
+                    std::cout << "Cannot read block " << b << '\n';
+                    return 1;
+                }
+                for (const auto &replay : block)
+                {
+                    writer.add(columnar::rowOf(replay));
+                }
+            }
+        }
+        else
+        {
+            CpuStrategy first;
+            CpuStrategy second;
+            if (!getStrategy(options, "first", CpuStrategy::Cautious, first) || !getStrategy(options, "second", CpuStrategy::Random, second))
+            {
+                return 1;
+            }
+            std::vector<sim::GameConfig> configs;
+            for (const unsigned int size : getList(options, "sizes", {4, 6, 8}))
+            {
+                for (const unsigned int mines : getList(options, "mines", {1, 3, 5}))
+                {
+                    // the sweep's bounds: a config playGame would clamp records dimensions it was not played on
+                    if (size >= Board::kMinSize && size <= Board::kMaxSimulationSize && mines >= 1 && mines <= size * size)
+                    {
+                        configs.push_back({size, size, mines});
+                    }
+                }
+            }
+            if (configs.empty())
+            {
+                std::cout << "No board size in --sizes (" << Board::kMinSize << " to " << Board::kMaxSimulationSize
+                          << ") with a mine count in --mines that fits it\n";
+                return 1;
+            }
+            const std::uint64_t games = getNumber(options, "games", 1000000);
+            const std::uint64_t seed = getNumber(options, "seed", static_cast<std::uint64_t>(std::time(nullptr)));
+            sim::runParallel(static_cast<unsigned int>(getNumber(options, "threads", sim::defaultWorkerCount())), games,
+                [&](std::uint64_t index)
+                {
+                    sim::GameReplay replay;
+                    const sim::Seat seat1 = {first, utils::mixSeed(seed, 2 * index), false};
+                    const sim::Seat seat2 = {second, utils::mixSeed(seed, 2 * index + 1), false};
+                    sim::playGame(configs[index % configs.size()], seat1, seat2, &replay);
+                    return columnar::rowOf(replay);
+                },
+                [&](std::uint64_t, const columnar::Row &row)
+                {
+                    return writer.add(row);
+                });
+        }
+        if (!writer.finish())
+        {
+            std::cout << "Cannot write " << path << '\n';
+            return 1;
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "Wrote " << writer.rowCount() << " rows to " << path << " in " << elapsed.count() << " s\n";
+        return 0;
+    }
+
+    // e.g. select --where mines>=3 --group width,height
+    int runSelect(const Options &options)
+    {
+        const std::string path = options.values.count("table") ? options.values.at("table") : "minefield-results.mfct";
+        columnar::Table table;
+        if (!table.open(path))
+        {
+            std::cout << "Cannot read " << path << '\n';
+            return 1;
+        }
+        columnar::Query query;
+        std::string item;
+        std::stringstream where(options.values.count("where") ? options.values.at("where") : "");
+        while (std::getline(where, item, ','))
+        {
+            columnar::Predicate predicate;
+            if (!columnar::parsePredicate(item, predicate))
+            {
+                std::cout << "Cannot parse condition: " << item << " (column, then =, <, <=, > or >=, then a number)\n";
+                return 1;
+            }
+            query.where.push_back(predicate);
+        }
+        std::stringstream group(options.values.count("group") ? options.values.at("group") : "");
+        while (std::getline(group, item, ','))
+        {
+            columnar::Column column;
+            if (!columnar::parseColumn(item, column))
+            {
+                std::cout << "Unknown column: " << item << " (seed, width, height, mines, rounds, winner or collisions)\n";
+                return 1;
+            }
+            query.groupBy.push_back(column);
+        }
+
+        columnar::Result result;
+        if (!columnar::run(table, query, static_cast<unsigned int>(getNumber(options, "threads", sim::defaultWorkerCount())), result))
+        {
+            std::cout << "Cannot group by more than " << columnar::kMaxGroupColumns << " columns\n";
+            return 1;
+        }
+        std::cout << result;
+        return 0;
+    }
+
+    // coordinator: plays --games games over --processes local worker processes (0 plays them in-process)
+    int runShard(const Options &options, const char *executable)
+    {
+        shard::Job job;
+        if (!getStrategy(options, "first", CpuStrategy::Cautious, job.first) || !getStrategy(options, "second", CpuStrategy::Random, job.second))
+        {
+            return 1;
+        }
+        job.config = getGameConfig(options);
+        job.games = getNumber(options, "games", 1000000);
+        job.seed = getNumber(options, "seed", static_cast<std::uint64_t>(std::time(nullptr)));
+        const unsigned int processes = static_cast<unsigned int>(getNumber(options, "processes", sim::defaultWorkerCount()));
+        const std::uint64_t rangeSize = std::max<std::uint64_t>(getNumber(options, "range", 10000), 1);
+
+        const auto start = std::chrono::steady_clock::now();
+        std::cout << "\n === SHARDED SIMULATION === \n";
+        if (processes == 0)
+        {
+            std::cout << shard::playRange(job, 0, job.games);
+        }
+        else
+        {
+#ifndef _WIN32
+            auto it = options.values.find("listen");
+            const std::string address = (it != options.values.end()) ? it->second : "/tmp/minefield-" + std::to_string(getpid()) + ".sock";
+            shard::CoordinatorReport report;
+            if (!shard::coordinate(job, address, processes, rangeSize, executable, report))
+            {
+                return 1;
+            }
+            std::cout << report.stats;
+            std::cout << "ranges reissued: " << report.reissued << ", workers respawned: " << report.respawned << '\n';
+#else
+            (void)executable;
+            std::cout << "Worker processes are not supported on this platform; use --processes 0.\n";
+            return 1;
+#endif
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "elapsed: " << elapsed.count() << " s\n";
+        return 0;
+    }
+
+    int runWorker(const Options &options)
+    {
+#ifndef _WIN32
+        auto it = options.values.find("connect");
+        if (it == options.values.end())
+        {
+            std::cout << "Missing --connect <address>\n";
+            return 1;
+        }
+        return shard::work(it->second);
+#else
+        (void)options;
+        std::cout << "Worker processes are not supported on this platform.\n";
+        return 1;
+#endif
+    }
+
+    // NUMA-pinned run on every node, optionally preceded by runs on fewer nodes to report the scaling
+    int runNuma(const Options &options)
+    {
+        shard::Job job;
+        if (!getStrategy(options, "first", CpuStrategy::Cautious, job.first) || !getStrategy(options, "second", CpuStrategy::Random, job.second))
+        {
+            return 1;
+        }
+        job.config = getGameConfig(options);
+        job.games = getNumber(options, "games", 1000000);
+        job.seed = getNumber(options, "seed", static_cast<std::uint64_t>(std::time(nullptr)));
+
+        const numa::Topology topology = numa::detectTopology();
+        const unsigned int nodes = static_cast<unsigned int>(topology.nodes.size());
+        const unsigned int perNode = static_cast<unsigned int>(getNumber(options, "per-node", topology.nodes.front().size()));
+        const bool scaling = getNumber(options, "scaling", 1) != 0;
+
+        std::cout << "\n === NUMA SIMULATION === \n" << nodes << " node(s), " << perNode << " worker(s) per node\n";
+        double baseline = 0.0;
+        numa::RunReport report;
+        for (unsigned int used = scaling ? 1 : nodes; used <= nodes; ++used)
+        {
+            report = numa::run(job, topology, used, perNode);
+            baseline = (baseline > 0.0) ? baseline : report.gamesPerSecond();
+            const double speedup = report.gamesPerSecond() / baseline;
+            std::cout << used << " node(s): " << static_cast<std::uint64_t>(report.gamesPerSecond()) << " games/s, speedup x" << speedup << ", efficiency "
+                      << 100.0 * speedup / used << "%" << (report.pinned ? "" : " (unpinned)") << '\n';
+        }
+        for (const auto &node : report.nodes)
+        {
+            std::cout << "node " << node.node << ": " << node.stats.games() << " games\n";
+        }
+        std::cout << report.total;
+        return 0;
+    }
+
+    int runServe(const Options &options)
+    {
+#ifndef _WIN32
+        const std::string address = options.values.count("listen") ? options.values.at("listen") : "/tmp/minefield-api.sock";
+        const bool takeover = getNumber(options, "takeover", 0) != 0;
+        std::cout << (takeover ? "Taking over the JSON API on " : "Serving the JSON API on ") << address << '\n';
+        api::ServerReport report;
+        if (!api::serve(address, report, takeover))
+        {
+            std::cout << (takeover ? "Cannot take over from the server on " : "Cannot listen on ") << address << '\n';
+            return 1;
+        }
+        if (takeover)
+        {
+            std::cout << "Resumed " << report.resumedGames << " games and " << report.resumedClients << " clients after a pause of "
+                      << report.pauseMilliseconds << " ms\n";
+        }
+        std::cout << (report.handedOff ? "Handed off after " : "Shut down after ") << report.requests << " requests from " << report.connections << " connections\n";
+        return 0;
+#else
+        (void)options;
+        std::cout << "The JSON API is not supported on this platform.\n";
+        return 1;
+#endif
+    }
+
+    int run(int argc, char *argv[])
+    {
+        Options options;
+        if (!parseOptions(argc, argv, options))
+        {
+            return 1;
+        }
+        try
+        {
+            if (options.command == "compare")
+            {
+                return runCompare(options);
+            }
+            if (options.command == "sprt")
+            {
+                return runSprt(options);
+            }
+            if (options.command == "estimate")
+            {
+                return runEstimate(options);
+            }
+            if (options.command == "exact")
+            {
+                return runExact(options);
+            }
+            if (options.command == "luck")
+            {
+                return runLuck(options);
+            }
+            if (options.command == "sweep")
+            {
+                return runSweep(options);
+            }
+            if (options.command == "shard")
+            {
+                return runShard(options, argv[0]);
+            }
+            if (options.command == "worker")
+            {
+                return runWorker(options);
+            }
+            if (options.command == "numa")
+            {
+                return runNuma(options);
+            }
+            if (options.command == "serve")
+            {
+                return runServe(options);
+            }
+            if (options.command == "archive")
+            {
+                return runArchive(options);
+            }
+            if (options.command == "query")
+            {
+                return runQuery(options);
+            }
+            if (options.command == "analyze")
+            {
+                return runAnalyze(options);
+            }
+            if (options.command == "table")
+            {
+                return runTable(options);
+            }
+            if (options.command == "select")
+            {
+                return runSelect(options);
+            }
+            if (options.command == "explore")
+            {
+                return runExplore(options);
+            }
+        }
+        catch (const std::exception &e)
+        {
+            std::cout << "Invalid option value: " << e.what() << '\n';
+            return 1;
+        }
+        std::cout << "Unknown command: " << options.command << "\nCommands: compare, sprt, estimate, exact, luck, sweep, shard, worker, numa, serve, explore, archive, query, analyze, table, select\n";
+        return 1;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1)
+    {
+        return tools::run(argc, argv);
+    }
+
+    utils::initializeRandom();
+    bool playAgain = true;
+
+    while (playAgain)
+    {
+        std::cout << "\n======================\n=== MINEFIELD GAME ===\n======================\n";
+        bool exitChosen = false;
+        bool vsCPU = false;
+        vsCPU = game::chooseGameMode(exitChosen);
+        if (exitChosen)
+        {
+            break;
+        }
+
+        // board setup
+        std::cout << "\n=== BOARD DIMENSIONS ===\n";
+        unsigned int width = utils::chooseValidDimension("Board Width", Board::kMinSize, Board::kMaxSize);
+        unsigned int height = utils::chooseValidDimension("Board Height", Board::kMinSize, Board::kMaxSize);
+        Board board(width, height);
+        std::cout << board;
+
+        // mines setup
+        std::cout << "=== NUMBER OF MINES ===\n";
+        unsigned int mines = game::chooseMineCount(board);
+
+        // player setup
+        Player player1 = makePlayer(true, "Player 1", mines);
+        Player player2 = makePlayer(vsCPU ? false : true, vsCPU ? "CPU" : "Player 2", mines);
+
+        // the game
+        game::runMainLoop(player1, player2, board);
+        playAgain = game::askPlayAgain();
+    }
+    std::cout << "\nThanks for playing Minefield! See you next time.\n";
+    return 0;
+}
+
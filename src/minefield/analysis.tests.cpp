@@ -0,0 +1,163 @@
+#include "minefield/engine/analysis.h"
+#include "minefield/engine/archive.h"
+#include "minefield/engine/utils.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Map-reduce over an archive: the result against the games counted directly, on one worker and on three,
+// and a run stopped after a few epochs that resumes from its checkpoint to the result of an unbroken one.
+namespace
+{
+    constexpr unsigned int kGames = 600;
+    constexpr unsigned int kBlockReplays = 16;
+
+    struct Archive
+    {
+        Archive()
+            : path((std::filesystem::temp_directory_path() / "minefield-analysis-test.mfra").string())
+        {
+            archive::Dictionary dictionary;
+            archive::Writer writer(path, dictionary, kBlockReplays);
+            for (unsigned int i = 0; i < kGames; ++i)
+            {
+                sim::GameConfig config;
+                config.width = 4 + i % 3;
+                config.height = 4;
+                config.mines = 1 + i % 4;
+                sim::playGame(config, {CpuStrategy::Cautious, utils::mixSeed(2, 2 * i), false}, {CpuStrategy::Random, utils::mixSeed(2, 2 * i + 1), false}, &games.emplace_back());
+                writer.add(games.back());
+            }
+            EXPECT_TRUE(writer.finish());
+            EXPECT_TRUE(reader.open(path));
+        }
+
+        ~Archive()
+        {
+            std::filesystem::remove(path);
+        }
+
+        std::string path;
+        std::vector<sim::GameReplay> games;
+        archive::Reader reader;
+    };
+
+    bool contains(const std::vector<Position> &positions, const Position &position)
+    {
+        return std::any_of(positions.begin(), positions.end(), [&](const Position &p){ return p.column == position.column && p.row == position.row; });
+    }
+
+    std::string saved(const analysis::Analysis<analysis::HitsByRound> &hits, const analysis::HitsByRound &state)
+    {
+        std::string out;
+        hits.save(state, out);
+        return out;
+    }
+
+    TEST(Analysis, HitsByRoundCountsEveryGame)
+    {
+        const Archive source;
+        analysis::HitsByRound expected;
+        for (const auto &game : source.games)
+        {
+            for (std::size_t r = 0; r < game.rounds.size(); ++r)
+            {
+                const sim::RoundRecord &round = game.rounds[r];
+                for (int seat = 0; seat < 2; ++seat)
+                {
+                    if (expected.guesses[seat].size() <= r)
+                    {
+                        expected.guesses[seat].resize(r + 1);
+                        expected.hits[seat].resize(r + 1);
+                    }
+                    const auto &own = seat ? round.mines2 : round.mines1;
+                    const auto &opponent = seat ? round.mines1 : round.mines2;
+                    for (const Position &guess : seat ? round.guesses2 : round.guesses1)
+                    {
+                        expected.guesses[seat][r]++;
+                        expected.hits[seat][r] += (contains(opponent, guess) && !contains(own, guess)) ? 1 : 0;
+                    }
+                }
+            }
+        }
+
+        const auto hits = analysis::hitsByRound();
+        for (unsigned int workers : {1U, 3U})
+        {
+            SCOPED_TRACE(workers);
+            analysis::Settings settings;
+            settings.workers = workers;
+            settings.epochBlocks = 4;
+            analysis::Progress last;
+            settings.onProgress = [&](const analysis::Progress &progress){ last = progress; };
+            analysis::HitsByRound result;
+            ASSERT_TRUE(analysis::run(source.reader, hits, settings, result));
+            EXPECT_EQ(saved(hits, expected), saved(hits, result));
+            EXPECT_EQ(source.reader.blockCount(), last.blocksDone);
+            EXPECT_EQ(kGames, last.games);
+        }
+    }
+
+    TEST(Analysis, ResumesFromItsCheckpoint)
+    {
+        const Archive source;
+        const std::string checkpoint = source.path + ".checkpoint";
+        std::filesystem::remove(checkpoint);
+        const auto hits = analysis::hitsByRound();
+
+        analysis::Settings settings;
+        settings.workers = 2;
+        settings.epochBlocks = 5;
+        analysis::HitsByRound unbroken;
+        ASSERT_TRUE(analysis::run(source.reader, hits, settings, unbroken));
+
+        // stopped once three epochs are saved, as if the process had been killed
+        struct Stopped
+        {
+        };
+        settings.checkpoint = checkpoint;
+        settings.onProgress = [](const analysis::Progress &progress)
+            {
+                if (progress.blocksDone >= 15)
+                {
+                    throw Stopped();
+                }
+            };
+        analysis::HitsByRound stopped;
+        EXPECT_THROW(analysis::run(source.reader, hits, settings, stopped), Stopped);
+
+        analysis::Progress last;
+        settings.onProgress = [&](const analysis::Progress &progress){ last = progress; };
+        analysis::HitsByRound resumed;
+        ASSERT_TRUE(analysis::run(source.reader, hits, settings, resumed));
+        EXPECT_EQ(15U, last.resumedBlocks);
+        EXPECT_EQ(source.reader.blockCount(), last.blocksDone);
+        EXPECT_LT(last.games, kGames);
+        EXPECT_EQ(saved(hits, unbroken), saved(hits, resumed));
+
+        // a checkpoint is only taken up for the archive it was written for
+        std::uint64_t blocksDone = 0;
+        std::string state;
+        EXPECT_TRUE(analysis::readCheckpoint(checkpoint, source.reader, blocksDone, state));
+        EXPECT_EQ(source.reader.blockCount(), blocksDone);
+        ASSERT_TRUE(analysis::writeCheckpoint(checkpoint, source.reader, 3, state));
+        archive::Reader other;
+        {
+            const std::string otherPath = source.path + ".other";
+            archive::Dictionary dictionary;
+            archive::Writer writer(otherPath, dictionary, kBlockReplays);
+            writer.add(source.games.front());
+            ASSERT_TRUE(writer.finish());
+            ASSERT_TRUE(other.open(otherPath));
+            std::filesystem::remove(otherPath);
+        }
+        EXPECT_FALSE(analysis::readCheckpoint(checkpoint, other, blocksDone, state));
+        EXPECT_EQ(0U, blocksDone);
+        std::filesystem::remove(checkpoint);
+    }
+}
@@ -0,0 +1,56 @@
+#include "minefield/engine/analytic.h"
+#include "minefield/engine/utils.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+
+// The exact Random-vs-Random outcome against simulated games: every share of the outcome and the expected
+// rounds must lie within four standard errors of the simulated ones.
+namespace
+{
+    constexpr unsigned int kGames = 20000;
+
+    TEST(Analytic, Choose)
+    {
+        EXPECT_DOUBLE_EQ(1.0, analytic::choose(7, 0));
+        EXPECT_DOUBLE_EQ(10.0, analytic::choose(5, 2));
+        EXPECT_DOUBLE_EQ(10.0, analytic::choose(5, 3));
+        EXPECT_DOUBLE_EQ(1.0, analytic::choose(4, 4));
+        EXPECT_DOUBLE_EQ(0.0, analytic::choose(3, 5));
+    }
+
+    void expectNear(double exact, double simulated, double variance, const char *what)
+    {
+        const double error = std::sqrt(variance / kGames);
+        EXPECT_NEAR(exact, simulated, 4.0 * error) << what;
+    }
+
+    TEST(Analytic, MatchesSimulatedGames)
+    {
+        for (const sim::GameConfig config : {sim::GameConfig{4, 4, 3}, sim::GameConfig{5, 3, 2}, sim::GameConfig{2, 1, 1}})
+        {
+            SCOPED_TRACE(testing::Message() << config.width << "x" << config.height << ", " << config.mines << " mine(s)");
+            const analytic::OutcomeDistribution exact = analytic::randomGameOutcome(config);
+            EXPECT_NEAR(1.0, exact.firstSeatWins + exact.draws + exact.secondSeatWins, 1e-9);
+            EXPECT_NEAR(exact.firstSeatWins, exact.secondSeatWins, 1e-9); // neither seat moves first
+
+            double outcomes[3] = {0.0, 0.0, 0.0};
+            double rounds = 0.0;
+            double squaredRounds = 0.0;
+            for (std::uint64_t i = 0; i < kGames; ++i)
+            {
+                const sim::GameResult result = sim::playGame(config, {CpuStrategy::Random, utils::mixSeed(8, 2 * i), false}, {CpuStrategy::Random, utils::mixSeed(8, 2 * i + 1), false});
+                outcomes[static_cast<int>(result.outcome)] += 1.0 / kGames;
+                rounds += static_cast<double>(result.rounds) / kGames;
+                squaredRounds += static_cast<double>(result.rounds) * result.rounds / kGames;
+            }
+            const double firstWins = outcomes[static_cast<int>(sim::Outcome::FirstSeatWins)];
+            const double draws = outcomes[static_cast<int>(sim::Outcome::Draw)];
+            expectNear(exact.firstSeatWins, firstWins, exact.firstSeatWins * (1.0 - exact.firstSeatWins), "first seat wins");
+            expectNear(exact.draws, draws, exact.draws * (1.0 - exact.draws), "draws");
+            expectNear(exact.expectedRounds, rounds, squaredRounds - rounds * rounds, "rounds");
+        }
+    }
+}
@@ -0,0 +1,283 @@
+#include "minefield/engine/api.h"
+#include "minefield/engine/json.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+// Batched create, rounds and close through api::Handler, the cell caps, and requests running out of memory.
+// Running out of memory is simulated by failing a single allocation: this test binary replaces operator new,
+// which allocates as usual until a test arms allocationsBeforeFailure.
+namespace
+{
+    std::atomic<long> allocationsBeforeFailure{-1}; // negative while disarmed
+
+    void *allocate(std::size_t size)
+    {
+        if (allocationsBeforeFailure.load(std::memory_order_relaxed) >= 0 && allocationsBeforeFailure.fetch_sub(1) == 0)
+        {
+            throw std::bad_alloc();
+        }
+        if (void *block = std::malloc(size ? size : 1))
+        {
+            return block;
+        }
+        throw std::bad_alloc();
+    }
+}
+
+void *operator new(std::size_t size)
+{
+    return allocate(size);
+}
+
+void *operator new[](std::size_t size)
+{
+    return allocate(size);
+}
+
+void operator delete(void *block) noexcept
+{
+    std::free(block);
+}
+
+void operator delete[](void *block) noexcept
+{
+    std::free(block);
+}
+
+void operator delete(void *block, std::size_t) noexcept
+{
+    std::free(block);
+}
+
+void operator delete[](void *block, std::size_t) noexcept
+{
+    std::free(block);
+}
+
+namespace
+{
+    constexpr const char *kRounds = R"({"op":"rounds","rounds":[)"
+        R"({"game":1,"mines":[[[0,0],[0,1]],[[1,0],[1,1]]],"guesses":[[[2,0],[2,1]],[[3,0],[3,1]]]},)"
+        R"({"game":2,"mines":[[[0,0]],[[1,0],[1,1]]],"guesses":[[[2,0],[2,1]],[[3,0],[3,1]]]},)"
+        R"({"game":3,"mines":[[[0,0],[0,1]],[[0,0],[1,1]]],"guesses":[[[2,0]],[[3,0]]]},)"
+        R"({"game":99,"mines":[[],[]],"guesses":[[],[]]}]})";
+
+    // a handler with its outbox, answering through a writer small enough to flush in the middle of a reply
+    class Client
+    {
+    public:
+        explicit Client(std::uint64_t maxLiveCells = api::Handler::kMaxLiveCells)
+            : handler(maxLiveCells)
+        {
+        }
+
+        // the reply to request, one line; failAfter arms a single failing allocation for the request
+        std::string send(std::string request, long failAfter = -1)
+        {
+            json::Writer reply(buffer, sizeof(buffer), &outbox);
+            allocationsBeforeFailure = failAfter;
+            handler.handle(request.data(), request.size(), reply);
+            allocationsBeforeFailure = -1;
+            finished = reply.finish();
+            std::string line;
+            line.swap(outbox);
+            return line;
+        }
+
+        api::Handler handler;
+        bool finished = false;
+
+    private:
+        char buffer[16];
+        std::string outbox;
+    };
+
+    // the parsed reply, after checking it is exactly one well-formed line
+    class Reply
+    {
+    public:
+        explicit Reply(const std::string &line)
+            : text(line)
+            , tokens(1024)
+            , document(tokens.data(), tokens.size())
+        {
+            EXPECT_TRUE(!text.empty() && text.find('\n') == text.size() - 1) << line;
+            valid = !text.empty() && document.parse(text.data(), text.size() - 1);
+            EXPECT_TRUE(valid) << line;
+        }
+
+        std::uint32_t at(std::string_view key) const
+        {
+            return document.find(document.root(), key);
+        }
+
+        // of the whole reply unless an object in it is given
+        bool ok(std::uint32_t object = 0) const
+        {
+            return valid && document.token(document.find(object, "ok")).type == json::TokenType::True;
+        }
+
+        std::string_view error(std::uint32_t object = 0) const
+        {
+            return valid ? document.string(document.find(object, "error")) : std::string_view();
+        }
+
+        std::string text;
+        std::vector<json::Token> tokens;
+        json::Document document;
+        bool valid = false;
+    };
+
+    std::string state(Client &client, unsigned int game)
+    {
+        return client.send(R"({"op":"state","game":)" + std::to_string(game) + "}");
+    }
+
+    TEST(ApiBatch, CreateRoundsAndClose)
+    {
+        Client client;
+        const Reply created(client.send(R"({"op":"create","width":8,"height":8,"mines":2,"count":3})"));
+        ASSERT_TRUE(created.ok());
+        EXPECT_EQ(3U, created.document.token(created.at("games")).children);
+        EXPECT_EQ(3U, client.handler.gameCount());
+
+        // game 1 plays, game 2 places too few mines, game 3 collides and guesses one cell less, game 99 is unknown
+        const std::string before = state(client, 2);
+        const Reply played(client.send(kRounds));
+        ASSERT_TRUE(played.ok());
+        const std::uint32_t results = played.at("results");
+        ASSERT_EQ(4U, played.document.token(results).children);
+        std::uint32_t result = played.document.firstChild(results);
+        EXPECT_TRUE(played.ok(result));
+        result = played.document.nextSibling(result);
+        EXPECT_EQ("invalid move", played.error(result));
+        result = played.document.nextSibling(result);
+        EXPECT_TRUE(played.ok(result));
+        std::uint64_t collisions = 0;
+        EXPECT_TRUE(played.document.number(played.document.find(result, "collisions"), collisions));
+        EXPECT_EQ(1U, collisions);
+        result = played.document.nextSibling(result);
+        EXPECT_EQ("unknown game", played.error(result));
+        EXPECT_EQ(before, state(client, 2));
+
+        const Reply closed(client.send(R"({"op":"close","games":[1,2,99]})"));
+        std::uint64_t count = 0;
+        EXPECT_TRUE(closed.document.number(closed.at("closed"), count));
+        EXPECT_EQ(2U, count);
+        EXPECT_EQ(1U, client.handler.gameCount());
+        EXPECT_EQ("unknown game", Reply(state(client, 1)).error());
+        EXPECT_TRUE(Reply(state(client, 3)).ok());
+    }
+
+    TEST(ApiBatch, CellCaps)
+    {
+        Client client(1000);
+        EXPECT_EQ("create needs width, height and mines", Reply(client.send(R"({"op":"create","width":4,"height":4,"mines":17})")).error());
+        EXPECT_EQ("too many cells for one request", Reply(client.send(R"({"op":"create","width":4096,"height":4096,"mines":1,"count":5})")).error());
+        EXPECT_TRUE(Reply(client.send(R"({"op":"create","width":16,"height":16,"mines":1,"count":3})")).ok());
+        EXPECT_EQ("too many cells held by the server", Reply(client.send(R"({"op":"create","width":16,"height":16,"mines":1})")).error());
+        EXPECT_EQ(3U, client.handler.gameCount());
+
+        // closed games give their cells back
+        EXPECT_TRUE(Reply(client.send(R"({"op":"close","game":2})")).ok());
+        EXPECT_TRUE(Reply(client.send(R"({"op":"create","width":16,"height":16,"mines":1})")).ok());
+        EXPECT_EQ(3U, client.handler.gameCount());
+    }
+
+    TEST(ApiBatch, CreateRunningOutOfMemoryTakesItBack)
+    {
+        bool failed = false;
+        for (long failAfter = 0;; ++failAfter)
+        {
+            SCOPED_TRACE(failAfter);
+            Client client(6 * 16);
+            ASSERT_TRUE(Reply(client.send(R"({"op":"create","width":4,"height":4,"mines":1})")).ok());
+            const Reply reply(client.send(R"({"op":"create","width":4,"height":4,"mines":1,"count":5})", failAfter));
+            ASSERT_TRUE(client.finished);
+            if (reply.ok())
+            {
+                EXPECT_EQ(6U, client.handler.gameCount());
+                break;
+            }
+            failed = true;
+            EXPECT_EQ("out of memory", reply.error());
+            EXPECT_EQ(1U, client.handler.gameCount());
+
+            // the cells of the games taken back are free again
+            EXPECT_TRUE(Reply(client.send(R"({"op":"create","width":4,"height":4,"mines":1,"count":5})")).ok());
+        }
+        EXPECT_TRUE(failed);
+    }
+
+    TEST(ApiBatch, RoundsRunningOutOfMemoryCommitOneByOne)
+    {
+        Client reference;
+        reference.send(R"({"op":"create","width":8,"height":8,"mines":2,"count":3})");
+        std::vector<std::string> initial;
+        for (unsigned int game = 1; game <= 3; ++game)
+        {
+            initial.push_back(state(reference, game));
+        }
+        reference.send(kRounds);
+        std::vector<std::string> played;
+        for (unsigned int game = 1; game <= 3; ++game)
+        {
+            played.push_back(state(reference, game));
+        }
+
+        unsigned int closedGames = 0;
+        for (long failAfter = 0;; ++failAfter)
+        {
+            SCOPED_TRACE(failAfter);
+            Client client;
+            client.send(R"({"op":"create","width":8,"height":8,"mines":2,"count":3})");
+            const Reply reply(client.send(kRounds, failAfter));
+            ASSERT_TRUE(client.finished);
+            if (!reply.ok())
+            {
+                // nothing was played before the reply had its room
+                EXPECT_EQ("out of memory", reply.error());
+                for (unsigned int game = 1; game <= 3; ++game)
+                {
+                    EXPECT_EQ(initial[game - 1], state(client, game));
+                }
+                continue;
+            }
+            const std::uint32_t results = reply.at("results");
+            ASSERT_EQ(4U, reply.document.token(results).children);
+            bool clean = true;
+            std::uint32_t result = reply.document.firstChild(results);
+            for (unsigned int game = 1; game <= 3; ++game, result = reply.document.nextSibling(result))
+            {
+                const std::string_view error = reply.error(result);
+                if (error == "out of memory, game closed")
+                {
+                    EXPECT_EQ("unknown game", Reply(state(client, game)).error());
+                    closedGames++;
+                    clean = false;
+                }
+                else if (error == "out of memory")
+                {
+                    EXPECT_EQ(initial[game - 1], state(client, game));
+                    clean = false;
+                }
+                else
+                {
+                    // every round that went through is kept, whatever happened to the others
+                    EXPECT_EQ(played[game - 1], state(client, game));
+                }
+            }
+            if (clean)
+            {
+                break;
+            }
+        }
+        EXPECT_GT(closedGames, 0U);
+    }
+}
@@ -0,0 +1,91 @@
+#include "minefield/engine/archive.h"
+#include "minefield/engine/sim.h"
+#include "minefield/engine/utils.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// One archive block of recorded 4x4 games: coding it under a dictionary trained on other games against the
+// untrained uniform one, and decoding it back to bytes and to replays. The ratio counter is record bytes per
+// compressed byte.
+namespace
+{
+    std::vector<sim::GameReplay> playGames(std::uint64_t first, unsigned int count)
+    {
+        std::vector<sim::GameReplay> replays(count);
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            const sim::Seat seat1 = {CpuStrategy::Cautious, utils::mixSeed(7, 2 * (first + i)), false};
+            const sim::Seat seat2 = {CpuStrategy::Random, utils::mixSeed(7, 2 * (first + i) + 1), false};
+            sim::playGame(sim::GameConfig{}, seat1, seat2, &replays[i]);
+        }
+        return replays;
+    }
+
+    struct Block
+    {
+        archive::Dictionary dictionary;
+        std::string raw;
+        std::string compressed;
+
+        Block(bool trained, unsigned int games)
+            : dictionary(trained ? archive::Dictionary::train(playGames(games, 1000)) : archive::Dictionary())
+        {
+            for (const auto &replay : playGames(0, games))
+            {
+                archive::encodeReplay(replay, raw);
+            }
+            dictionary.compress(raw, compressed);
+        }
+    };
+
+    void BM_CompressBlock(benchmark::State &state)
+    {
+        Block block(state.range(0) != 0, archive::kDefaultBlockReplays);
+        std::string out;
+        for (auto _ : state)
+        {
+            block.dictionary.compress(block.raw, out);
+            benchmark::DoNotOptimize(out.data());
+        }
+        state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(block.raw.size()));
+        state.counters["ratio"] = static_cast<double>(block.raw.size()) / block.compressed.size();
+    }
+    BENCHMARK(BM_CompressBlock)->ArgName("trained")->Arg(0)->Arg(1);
+
+    void BM_DecompressBlock(benchmark::State &state)
+    {
+        Block block(state.range(0) != 0, archive::kDefaultBlockReplays);
+        std::string out;
+        for (auto _ : state)
+        {
+            block.dictionary.decompress(block.compressed.data(), block.compressed.size(), block.raw.size(), out);
+            benchmark::DoNotOptimize(out.data());
+        }
+        state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(block.raw.size()));
+        state.counters["ratio"] = static_cast<double>(block.raw.size()) / block.compressed.size();
+    }
+    BENCHMARK(BM_DecompressBlock)->ArgName("trained")->Arg(0)->Arg(1);
+
+    void BM_DecodeReplays(benchmark::State &state)
+    {
+        Block block(true, archive::kDefaultBlockReplays);
+        std::string out;
+        std::vector<sim::GameReplay> replays(archive::kDefaultBlockReplays);
+        for (auto _ : state)
+        {
+            block.dictionary.decompress(block.compressed.data(), block.compressed.size(), block.raw.size(), out);
+            const char *cursor = out.data();
+            for (auto &replay : replays)
+            {
+                archive::decodeReplay(cursor, out.data() + out.size(), replay);
+            }
+            benchmark::DoNotOptimize(replays.data());
+        }
+        state.SetItemsProcessed(state.iterations() * archive::kDefaultBlockReplays);
+    }
+    BENCHMARK(BM_DecodeReplays);
+}
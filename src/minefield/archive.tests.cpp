@@ -0,0 +1,188 @@
+#include "minefield/engine/archive.h"
+#include "minefield/engine/utils.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Replay archives: records, the rANS coder and whole archives read back game for game as they were written.
+namespace
+{
+    std::vector<sim::GameReplay> playGames(unsigned int count, std::uint64_t seed)
+    {
+        std::vector<sim::GameReplay> games(count);
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            sim::GameConfig config;
+            config.width = 3 + i % 7;
+            config.height = 3 + (i / 7) % 5;
+            config.mines = 1 + i % 3;
+            const CpuStrategy strategy = (i % 2 == 0) ? CpuStrategy::Cautious : CpuStrategy::Random;
+            sim::playGame(config, {strategy, utils::mixSeed(seed, 2 * i), false}, {CpuStrategy::Random, utils::mixSeed(seed, 2 * i + 1), i % 5 == 0}, &games[i]);
+        }
+        return games;
+    }
+
+    void expectSamePositions(const std::vector<Position> &expected, const std::vector<Position> &actual)
+    {
+        ASSERT_EQ(expected.size(), actual.size());
+        for (std::size_t i = 0; i < expected.size(); ++i)
+        {
+            EXPECT_EQ(expected[i].column, actual[i].column);
+            EXPECT_EQ(expected[i].row, actual[i].row);
+        }
+    }
+
+    void expectSameReplay(const sim::GameReplay &expected, const sim::GameReplay &actual)
+    {
+        EXPECT_EQ(expected.config.width, actual.config.width);
+        EXPECT_EQ(expected.config.height, actual.config.height);
+        EXPECT_EQ(expected.config.mines, actual.config.mines);
+        for (const auto &seats : {std::make_pair(&expected.first, &actual.first), std::make_pair(&expected.second, &actual.second)})
+        {
+            EXPECT_EQ(seats.first->strategy, seats.second->strategy);
+            EXPECT_EQ(seats.first->seed, seats.second->seed);
+            EXPECT_EQ(seats.first->antithetic, seats.second->antithetic);
+        }
+        EXPECT_EQ(expected.result.outcome, actual.result.outcome);
+        EXPECT_EQ(expected.result.rounds, actual.result.rounds);
+        ASSERT_EQ(expected.rounds.size(), actual.rounds.size());
+        for (std::size_t r = 0; r < expected.rounds.size(); ++r)
+        {
+            expectSamePositions(expected.rounds[r].mines1, actual.rounds[r].mines1);
+            expectSamePositions(expected.rounds[r].mines2, actual.rounds[r].mines2);
+            expectSamePositions(expected.rounds[r].guesses1, actual.rounds[r].guesses1);
+            expectSamePositions(expected.rounds[r].guesses2, actual.rounds[r].guesses2);
+        }
+    }
+
+    TEST(Archive, RecordsRoundTrip)
+    {
+        const std::vector<sim::GameReplay> games = playGames(200, 3);
+        std::string records;
+        for (const auto &game : games)
+        {
+            archive::encodeReplay(game, records);
+        }
+
+        const char *cursor = records.data();
+        const char *end = records.data() + records.size();
+        archive::ReplayView view;
+        for (const auto &game : games)
+        {
+            const char *start = cursor;
+            sim::GameReplay decoded;
+            ASSERT_TRUE(archive::decodeReplay(cursor, end, decoded));
+            expectSameReplay(game, decoded);
+
+            // the in-place view of the same record holds the same game
+            const char *viewCursor = start;
+            ASSERT_TRUE(view.parse(viewCursor, end));
+            EXPECT_EQ(cursor, viewCursor);
+            sim::GameReplay copied;
+            view.copyTo(copied);
+            expectSameReplay(game, copied);
+        }
+        EXPECT_EQ(end, cursor);
+
+        // every cut short record is refused
+        std::string record;
+        archive::encodeReplay(games[1], record);
+        for (std::size_t size = 0; size < record.size(); ++size)
+        {
+            const char *partial = record.data();
+            sim::GameReplay decoded;
+            EXPECT_FALSE(archive::decodeReplay(partial, record.data() + size, decoded)) << size;
+        }
+    }
+
+    TEST(Archive, DictionaryRoundTrip)
+    {
+        std::string records;
+        for (const auto &game : playGames(64, 5))
+        {
+            archive::encodeReplay(game, records);
+        }
+        std::string noise;
+        for (unsigned int i = 0; i < 4096; ++i)
+        {
+            noise.push_back(static_cast<char>(utils::mixSeed(9, i)));
+        }
+
+        const archive::Dictionary trained = archive::Dictionary::train(playGames(256, 4));
+        EXPECT_GT(trained.trainedContexts(), 0U);
+        std::string saved;
+        trained.save(saved);
+        archive::Dictionary loaded;
+        const archive::Dictionary &reloaded = loaded;
+        const char *cursor = saved.data();
+        ASSERT_TRUE(loaded.load(cursor, saved.data() + saved.size()));
+
+        for (const archive::Dictionary *dictionary : {&trained, &reloaded})
+        {
+            for (const std::string &raw : {records, noise, std::string()})
+            {
+                std::string compressed;
+                std::string decompressed;
+                dictionary->compress(raw, compressed);
+                ASSERT_TRUE(dictionary->decompress(compressed.data(), compressed.size(), raw.size(), decompressed));
+                EXPECT_EQ(raw, decompressed);
+            }
+        }
+
+        // the dictionary the games were drawn from codes them in fewer bytes than the uniform one
+        std::string trainedBytes;
+        std::string uniformBytes;
+        trained.compress(records, trainedBytes);
+        archive::Dictionary().compress(records, uniformBytes);
+        EXPECT_LT(trainedBytes.size(), uniformBytes.size());
+    }
+
+    TEST(Archive, ReadsBackWhatWasWritten)
+    {
+        const std::string path = (std::filesystem::temp_directory_path() / "minefield-archive-test.mfra").string();
+        const std::vector<sim::GameReplay> games = playGames(1000, 6);
+        const archive::Dictionary dictionary = archive::Dictionary::train(playGames(128, 7));
+        {
+            archive::Writer writer(path, dictionary, 64);
+            for (const auto &game : games)
+            {
+                ASSERT_TRUE(writer.add(game));
+            }
+            ASSERT_TRUE(writer.finish());
+            EXPECT_EQ(games.size(), writer.stats().replays);
+        }
+
+        archive::Reader reader;
+        ASSERT_TRUE(reader.open(path));
+        ASSERT_EQ(games.size(), reader.replayCount());
+        EXPECT_EQ((games.size() + 63) / 64, reader.blockCount());
+        std::size_t next = 0;
+        std::vector<sim::GameReplay> block;
+        for (std::size_t b = 0; b < reader.blockCount(); ++b)
+        {
+            ASSERT_EQ(next, reader.block(b).firstReplay);
+            ASSERT_TRUE(reader.readBlock(b, block));
+            for (const auto &game : block)
+            {
+                expectSameReplay(games[next++], game);
+            }
+        }
+        EXPECT_EQ(games.size(), next);
+
+        // random access, out of order
+        for (std::uint64_t index : {999ULL, 0ULL, 513ULL, 64ULL, 63ULL})
+        {
+            sim::GameReplay game;
+            ASSERT_TRUE(reader.readReplay(index, game));
+            expectSameReplay(games[index], game);
+        }
+        sim::GameReplay past;
+        EXPECT_FALSE(reader.readReplay(games.size(), past));
+        std::filesystem::remove(path);
+    }
+}
@@ -0,0 +1,78 @@
+#include "minefield/engine/bitplane.h"
+#include "minefield/engine/board.h"
+#include "minefield/engine/sim.h"
+#include "minefield/engine/utils.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+// Mines placed per second on a 1024x1024 board by four seats with 16384 mines each: through safeCellAccess
+// on one thread, checking the board for collisions, against fetch_or placement on the bitplanes.
+namespace
+{
+    constexpr unsigned int kSize = 1024;
+    constexpr unsigned int kSeats = 4;
+    constexpr unsigned int kMinesPerSeat = 16384;
+
+    std::vector<std::vector<Position>> makeMines()
+    {
+        std::vector<std::vector<Position>> mines(kSeats);
+        for (unsigned int seat = 0; seat < kSeats; ++seat)
+        {
+            for (unsigned int m = 0; m < kMinesPerSeat; ++m)
+            {
+                const std::uint64_t cell = utils::mixSeed(seat, m) % (kSize * kSize);
+                mines[seat].push_back({static_cast<unsigned int>(cell / kSize), static_cast<unsigned int>(cell % kSize)});
+            }
+        }
+        return mines;
+    }
+
+    void BM_SerialPlacement(benchmark::State &state)
+    {
+        const auto mines = makeMines();
+        Board board(kSize, kSize, Board::kMaxSimulationSize);
+        for (auto _ : state)
+        {
+            std::uint64_t collisions = 0;
+            for (const auto &list : mines)
+            {
+                for (const auto &mine : list)
+                {
+                    board.safeCellAccess(mine.column, mine.row, [&](CellStatusFlags &status)
+                        {
+                            collisions += hasFlag(status, CellStatusFlags::HasMine);
+                            status |= CellStatusFlags::HasMine;
+                        });
+                }
+            }
+            benchmark::DoNotOptimize(collisions);
+            for (const auto &list : mines)
+            {
+                for (const auto &mine : list)
+                {
+                    board.safeCellAccess(mine.column, mine.row, [](CellStatusFlags &status){ status = status & ~CellStatusFlags::HasMine; });
+                }
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * kSeats * kMinesPerSeat);
+    }
+    BENCHMARK(BM_SerialPlacement)->UseRealTime();
+
+    void BM_BitplanePlacement(benchmark::State &state)
+    {
+        const auto mines = makeMines();
+        const Board board(kSize, kSize, Board::kMaxSimulationSize);
+        bitplane::MinePlanes planes(board, kSeats);
+        sim::WorkerPool pool(static_cast<unsigned int>(state.range(0)));
+        for (auto _ : state)
+        {
+            planes.clear();
+            benchmark::DoNotOptimize(bitplane::placeAll(planes, mines, pool));
+        }
+        state.SetItemsProcessed(state.iterations() * kSeats * kMinesPerSeat);
+    }
+    BENCHMARK(BM_BitplanePlacement)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+}
@@ -0,0 +1,61 @@
+#include "minefield/engine/bitplane.h"
+#include "minefield/engine/game.h"
+#include "minefield/engine/player.h"
+#include "minefield/engine/utils.h"
+#include "positions.tests.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+// MinePlanes against game::detectAndRemoveCollisions: both seats' placements go through placeAll one per
+// chunk, so they race on the pool, and the planes written back must leave the board as the rules do.
+namespace
+{
+    TEST(MinePlanes, MatchesCollisionRules)
+    {
+        sim::WorkerPool pool(3);
+        for (unsigned int t = 0; t < 2000; ++t)
+        {
+            SCOPED_TRACE(t);
+            const unsigned int width = 3 + t % 9;
+            const unsigned int height = 2 + t % 7;
+            Board expectedBoard(width, height, Board::kMaxSimulationSize);
+            for (unsigned int i = 0; i < width * height / 5; ++i)
+            {
+                const std::uint64_t cell = utils::mixSeed(t, 100 + i) % (width * height);
+                expectedBoard.safeCellAccess(static_cast<unsigned int>(cell / height), static_cast<unsigned int>(cell % height), [](CellStatusFlags &status){ status |= CellStatusFlags::Disabled; });
+            }
+            Board board = expectedBoard;
+            bitplane::MinePlanes planes(board, 2);
+
+            const std::vector<std::vector<Position>> mines = {tests::freePositions(2ULL * t, 4, board), tests::freePositions(2ULL * t + 1, 4, board)};
+            Player p1 = makePlayer(false, "CPU 1", 4);
+            Player p2 = makePlayer(false, "CPU 2", 4);
+            p1.currentMines = mines[0];
+            p2.currentMines = mines[1];
+            for (const auto &list : mines)
+            {
+                for (const auto &mine : list)
+                {
+                    expectedBoard.safeCellAccess(mine.column, mine.row, [](CellStatusFlags &status){ status |= CellStatusFlags::HasMine; });
+                }
+            }
+            game::detectAndRemoveCollisions(p1, p2, expectedBoard, utils::nullStream());
+
+            bitplane::placeAll(planes, mines, pool, 1);
+            planes.applyTo(board);
+            EXPECT_EQ(p1.currentMines.size(), planes.survivors(0));
+            EXPECT_EQ(p2.currentMines.size(), planes.survivors(1));
+            for (unsigned int cell = 0; cell < width * height; ++cell)
+            {
+                ASSERT_EQ(static_cast<unsigned int>(expectedBoard.cells()[cell]), static_cast<unsigned int>(board.cells()[cell]));
+            }
+            if (!mines[0].empty())
+            {
+                EXPECT_EQ(bitplane::Placement::Duplicate, planes.place(0, mines[0][0].column, mines[0][0].row));
+            }
+        }
+    }
+}
@@ -0,0 +1,142 @@
+#include "minefield/capi/minefield_c.h"
+
+#include "minefield/engine/board.h"
+#include "minefield/engine/game.h"
+#include "minefield/engine/player.h"
+#include "minefield/engine/utils.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+// Per-call overhead of the C API against the same rounds played through the engine directly. Every round
+// places one mine per seat two cells ahead and guesses the two cells before them, so nothing is ever hit
+// and a 16x16 game lasts 127 rounds before the batch is reset.
+namespace
+{
+    constexpr std::uint32_t kSize = 16;
+    constexpr std::uint32_t kRounds = kSize * kSize / 2 - 1;
+
+    struct Script
+    {
+        std::vector<mf_position> cells;
+        std::vector<mf_round_input> rounds;
+
+        Script()
+        {
+            for (std::uint32_t index = 0; index < kSize * kSize; ++index)
+            {
+                cells.push_back({index / kSize, index % kSize});
+            }
+            for (std::uint32_t r = 0; r < kRounds; ++r)
+            {
+                mf_round_input input = {};
+                input.struct_size = sizeof(mf_round_input);
+                input.mines[0] = &cells[2 * r + 2];
+                input.mines[1] = &cells[2 * r + 3];
+                input.guesses[0] = &cells[2 * r];
+                input.guesses[1] = &cells[2 * r + 1];
+                input.mine_count[0] = input.mine_count[1] = 1;
+                input.guess_count[0] = input.guess_count[1] = 1;
+                rounds.push_back(input);
+            }
+        }
+    };
+
+    const Script &script()
+    {
+        static const Script instance;
+        return instance;
+    }
+
+    mf_batch *createBatch(std::uint32_t games)
+    {
+        const mf_batch_config config = {sizeof(mf_batch_config), kSize, kSize, 1, games};
+        mf_batch *batch = nullptr;
+        mf_batch_create(&config, &batch);
+        return batch;
+    }
+
+    void BM_EngineRound(benchmark::State &state)
+    {
+        const Script &rounds = script();
+        Board board(kSize, kSize, Board::kMaxSimulationSize);
+        Player p1 = makePlayer(false, "Seat 1", 1);
+        Player p2 = makePlayer(false, "Seat 2", 1);
+        std::uint32_t round = 0;
+        for (auto _ : state)
+        {
+            if (round == kRounds)
+            {
+                state.PauseTiming();
+                board = Board(kSize, kSize, Board::kMaxSimulationSize);
+                round = 0;
+                state.ResumeTiming();
+            }
+            const mf_round_input &input = rounds.rounds[round++];
+            const Position mine1 = {input.mines[0]->column, input.mines[0]->row};
+            const Position mine2 = {input.mines[1]->column, input.mines[1]->row};
+            game::clearMines(board);
+            p1.currentMines.assign(1, mine1);
+            p2.currentMines.assign(1, mine2);
+            utils::safeCellAccess(board, mine1.column, mine1.row, [](CellStatusFlags &status){ status |= CellStatusFlags::HasMine; });
+            utils::safeCellAccess(board, mine2.column, mine2.row, [](CellStatusFlags &status){ status |= CellStatusFlags::HasMine; });
+            game::detectAndRemoveCollisions(p1, p2, board, utils::nullStream());
+            p1.currentGuesses.assign(1, Position{input.guesses[0]->column, input.guesses[0]->row});
+            p2.currentGuesses.assign(1, Position{input.guesses[1]->column, input.guesses[1]->row});
+            benchmark::DoNotOptimize(game::resolveGuesses(p1, p2, board, utils::nullStream()));
+            benchmark::DoNotOptimize(game::checkGameEnd(p1, p2, utils::nullStream()) || utils::countFreeCells(board) == 0);
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+    BENCHMARK(BM_EngineRound);
+
+    // one call per iteration stepping state.range(0) games, all fed from the same caller-owned arrays
+    void BM_CApiRound(benchmark::State &state)
+    {
+        const std::uint32_t games = static_cast<std::uint32_t>(state.range(0));
+        const Script &rounds = script();
+        std::vector<mf_round_input> inputs(games);
+        std::vector<mf_round_result> results(games);
+        results[0].struct_size = sizeof(mf_round_result);
+        mf_batch *batch = createBatch(games);
+        std::uint32_t round = 0;
+        for (auto _ : state)
+        {
+            if (round == kRounds)
+            {
+                state.PauseTiming();
+                mf_batch_destroy(batch);
+                batch = createBatch(games);
+                round = 0;
+                state.ResumeTiming();
+            }
+            inputs.assign(games, rounds.rounds[round++]);
+            if (mf_batch_step(batch, 0, games, inputs.data(), results.data()) != MF_OK)
+            {
+                state.SkipWithError("round rejected");
+                break;
+            }
+            benchmark::DoNotOptimize(results.data());
+        }
+        mf_batch_destroy(batch);
+        state.SetItemsProcessed(state.iterations() * games);
+    }
+    BENCHMARK(BM_CApiRound)->Arg(1)->Arg(64);
+
+    // the zero-copy board read alone: a pointer and two sizes
+    void BM_CApiBoardView(benchmark::State &state)
+    {
+        mf_batch *batch = createBatch(1);
+        mf_board_view view = {};
+        view.struct_size = sizeof(mf_board_view);
+        for (auto _ : state)
+        {
+            mf_batch_board(batch, 0, &view);
+            benchmark::DoNotOptimize(view.cells[0]);
+        }
+        mf_batch_destroy(batch);
+    }
+    BENCHMARK(BM_CApiBoardView);
+}
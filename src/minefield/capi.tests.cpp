@@ -0,0 +1,176 @@
+#include "minefield/capi/minefield_c.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// The C API through the minefield.capi shared library: a batch played round by round, and structs passed
+// with the struct_size of another version, shorter than this one's or with fields this library does not know.
+namespace
+{
+    constexpr std::uint32_t kSentinel = 0xdeadbeef;
+
+    // the structs of a caller built against a newer minor version, with one field appended to each
+    struct NewerResult
+    {
+        mf_round_result result;
+        std::uint32_t appended;
+    };
+
+    struct NewerInput
+    {
+        mf_round_input input;
+        std::uint64_t appended;
+    };
+
+    struct NewerView
+    {
+        mf_board_view view;
+        std::uint32_t appended;
+    };
+
+    mf_batch *createBatch(std::uint32_t games)
+    {
+        mf_batch_config config = {};
+        config.struct_size = sizeof(config);
+        config.width = 4;
+        config.height = 4;
+        config.mines = 2;
+        config.games = games;
+        mf_batch *batch = nullptr;
+        EXPECT_EQ(MF_OK, mf_batch_create(&config, &batch));
+        return batch;
+    }
+
+    // seat 1 mines the first column, seat 2 the second, and each guesses two cells of the other's column
+    const mf_position kMines[2][2] = {{{0, 0}, {0, 1}}, {{1, 0}, {1, 1}}};
+    const mf_position kGuesses[2][2] = {{{1, 0}, {2, 0}}, {{0, 0}, {3, 0}}};
+
+    mf_round_input roundInput(std::uint32_t structSize)
+    {
+        mf_round_input input = {};
+        input.struct_size = structSize;
+        for (int seat = 0; seat < 2; ++seat)
+        {
+            input.mines[seat] = kMines[seat];
+            input.guesses[seat] = kGuesses[seat];
+            input.mine_count[seat] = 2;
+            input.guess_count[seat] = 2;
+        }
+        return input;
+    }
+
+    TEST(CApi, PlaysBatchedRounds)
+    {
+        EXPECT_EQ(static_cast<std::uint32_t>(MF_API_VERSION_MAJOR), mf_api_version() >> 16);
+        mf_batch *batch = createBatch(3);
+        ASSERT_NE(nullptr, batch);
+
+        std::uint32_t mines[2] = {};
+        std::uint32_t guesses[2] = {};
+        ASSERT_EQ(MF_OK, mf_batch_expected_counts(batch, 2, mines, guesses));
+        EXPECT_EQ(2U, mines[0]);
+        EXPECT_EQ(2U, guesses[1]);
+        EXPECT_EQ(MF_INVALID_ARGUMENT, mf_batch_expected_counts(batch, 3, mines, guesses));
+
+        // the middle game lists a mine twice and keeps the state it had
+        std::vector<mf_round_input> inputs(3, roundInput(sizeof(mf_round_input)));
+        const mf_position twice[2] = {{0, 0}, {0, 0}};
+        inputs[1].mines[0] = twice;
+        std::vector<mf_round_result> results(3);
+        for (auto &result : results)
+        {
+            result.struct_size = sizeof(result);
+        }
+        EXPECT_EQ(MF_INVALID_MOVE, mf_batch_step(batch, 0, 3, inputs.data(), results.data()));
+        for (int game : {0, 2})
+        {
+            EXPECT_EQ(MF_OK, results[game].status);
+            EXPECT_EQ(MF_ONGOING, results[game].outcome);
+            EXPECT_EQ(1U, results[game].hits[0]);
+            EXPECT_EQ(1U, results[game].hits[1]);
+            EXPECT_EQ(1U, results[game].remaining_mines[0]);
+            EXPECT_EQ(1U, results[game].remaining_mines[1]);
+        }
+        EXPECT_EQ(MF_INVALID_MOVE, results[1].status);
+        EXPECT_EQ(2U, results[1].remaining_mines[0]);
+
+        mf_board_view view = {};
+        view.struct_size = sizeof(view);
+        ASSERT_EQ(MF_OK, mf_batch_board(batch, 1, &view));
+        for (std::uint32_t cell = 0; cell < view.width * view.height; ++cell)
+        {
+            EXPECT_EQ(0U, view.cells[cell]);
+        }
+        ASSERT_EQ(MF_OK, mf_batch_board(batch, 0, &view));
+        EXPECT_EQ(4U, view.width);
+        EXPECT_EQ(4U, view.height);
+        EXPECT_NE(0U, view.cells[0 * 4 + 0] & MF_CELL_WAS_GUESSED); // seat 2 found seat 1's mine
+        EXPECT_NE(0U, view.cells[3 * 4 + 0] & MF_CELL_DISABLED);
+        mf_batch_destroy(batch);
+    }
+
+    TEST(CApi, ShortStructSizesAreRejected)
+    {
+        mf_batch_config config = {};
+        config.struct_size = offsetof(mf_batch_config, games); // one field short of version 1
+        config.width = 4;
+        config.height = 4;
+        config.mines = 2;
+        config.games = 1;
+        mf_batch *batch = nullptr;
+        EXPECT_EQ(MF_INVALID_ARGUMENT, mf_batch_create(&config, &batch));
+        EXPECT_EQ(nullptr, batch);
+
+        batch = createBatch(1);
+        ASSERT_NE(nullptr, batch);
+        mf_round_input input = roundInput(offsetof(mf_round_input, guess_count));
+        mf_round_result result = {};
+        result.struct_size = sizeof(result);
+        EXPECT_EQ(MF_INVALID_ARGUMENT, mf_batch_step(batch, 0, 1, &input, &result));
+        input.struct_size = sizeof(input);
+        result.struct_size = offsetof(mf_round_result, collisions);
+        EXPECT_EQ(MF_INVALID_ARGUMENT, mf_batch_step(batch, 0, 1, &input, &result));
+
+        mf_board_view view = {};
+        view.struct_size = offsetof(mf_board_view, height);
+        EXPECT_EQ(MF_INVALID_ARGUMENT, mf_batch_board(batch, 0, &view));
+        mf_batch_destroy(batch);
+    }
+
+    TEST(CApi, LongerStructsKeepTheirAppendedFields)
+    {
+        mf_batch *batch = createBatch(2);
+        ASSERT_NE(nullptr, batch);
+        NewerInput inputs[2];
+        NewerResult results[2];
+        for (int game = 0; game < 2; ++game)
+        {
+            inputs[game].input = roundInput(sizeof(NewerInput));
+            inputs[game].appended = kSentinel;
+            results[game].result = {};
+            results[game].result.struct_size = sizeof(NewerResult);
+            results[game].appended = kSentinel;
+        }
+
+        // the arrays are walked with the caller's stride, and nothing past the fields of this version is written
+        ASSERT_EQ(MF_OK, mf_batch_step(batch, 0, 2, &inputs[0].input, &results[0].result));
+        for (const NewerResult &result : results)
+        {
+            EXPECT_EQ(MF_OK, result.result.status);
+            EXPECT_EQ(1U, result.result.hits[0]);
+            EXPECT_EQ(1U, result.result.remaining_mines[1]);
+            EXPECT_EQ(kSentinel, result.appended);
+        }
+
+        NewerView view = {};
+        view.view.struct_size = sizeof(view);
+        view.appended = kSentinel;
+        ASSERT_EQ(MF_OK, mf_batch_board(batch, 1, &view.view));
+        EXPECT_EQ(4U, view.view.height);
+        EXPECT_EQ(kSentinel, view.appended);
+        mf_batch_destroy(batch);
+    }
+}
@@ -0,0 +1,86 @@
+#include "minefield/engine/archive.h"
+#include "minefield/engine/catalog.h"
+#include "minefield/engine/utils.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Catalog queries against a scan of every game: an archive of games on three board sizes and three mine
+// counts is indexed, and each query must return exactly the games whose features pass its filters.
+namespace
+{
+    constexpr unsigned int kGames = 12000;
+
+    bool matches(const catalog::Query &query, const catalog::Features &features)
+    {
+        return (query.width == ~0U || features.width == query.width) && (query.height == ~0U || features.height == query.height)
+            && (query.mines == ~0U || features.mines == query.mines) && (query.outcome == ~0U || static_cast<unsigned int>(features.outcome) == query.outcome)
+            && features.rounds >= query.minRounds && features.rounds <= query.maxRounds
+            && features.collisions >= query.minCollisions && features.collisions <= query.maxCollisions;
+    }
+
+    TEST(Catalog, QueryMatchesFullScan)
+    {
+        const std::filesystem::path directory = std::filesystem::temp_directory_path();
+        const std::string archivePath = (directory / "minefield-catalog-test.mfra").string();
+        const std::string catalogPath = (directory / "minefield-catalog-test.cat").string();
+
+        std::vector<sim::GameReplay> games;
+        {
+            archive::Dictionary dictionary;
+            archive::Writer writer(archivePath, dictionary, 256);
+            for (unsigned int i = 0; i < kGames; ++i)
+            {
+                sim::GameConfig config;
+                config.width = config.height = 4 + (i / (kGames / 3)) * 2;
+                config.mines = 2 + (i / 1400) % 3;
+                sim::GameReplay replay;
+                sim::playGame(config, {CpuStrategy::Cautious, utils::mixSeed(1, 2 * i), false}, {CpuStrategy::Random, utils::mixSeed(1, 2 * i + 1), false}, &replay);
+                writer.add(replay);
+                games.push_back(replay);
+            }
+            ASSERT_TRUE(writer.finish());
+        }
+        archive::Reader reader;
+        ASSERT_TRUE(reader.open(archivePath));
+        ASSERT_TRUE(catalog::build(reader, catalogPath));
+        catalog::Catalog index;
+        ASSERT_TRUE(index.open(catalogPath));
+
+        std::vector<catalog::Query> queries(8);
+        queries[0].width = 6;
+        queries[1].width = 8;
+        queries[1].mines = 3;
+        queries[1].minCollisions = 2;
+        queries[2].outcome = 0;
+        queries[2].minRounds = 5;
+        queries[3].minCollisions = 4;
+        queries[4].mines = 4;
+        queries[4].outcome = 2;
+        queries[5].maxRounds = 1;
+        queries[6].width = 4;
+        queries[6].height = 6;
+        queries[7].minRounds = 3;
+        queries[7].maxRounds = 3;
+        queries[7].width = 4;
+        for (std::size_t q = 0; q < queries.size(); ++q)
+        {
+            SCOPED_TRACE(q);
+            std::vector<std::uint64_t> expected;
+            for (std::uint64_t i = 0; i < games.size(); ++i)
+            {
+                if (matches(queries[q], catalog::featuresOf(games[i])))
+                {
+                    expected.push_back(i);
+                }
+            }
+            EXPECT_EQ(expected, index.run(queries[q], reader).games);
+        }
+        std::filesystem::remove(archivePath);
+        std::filesystem::remove(catalogPath);
+    }
+}
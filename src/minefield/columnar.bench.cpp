@@ -0,0 +1,73 @@
+#include "minefield/engine/columnar.h"
+#include "minefield/engine/utils.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+// Scans of a table of synthetic rows: the query of the request, win rate by board size where mines >= 3,
+// with and without the group-by, and a filter on a column whose row group extents rule nothing out.
+namespace
+{
+    constexpr std::uint64_t kRows = std::uint64_t{1} << 23;
+
+    const columnar::Table &syntheticTable()
+    {
+        static const std::string path = "columnar-bench.mfct";
+        static columnar::Table table;
+        static const bool ready = [&]
+            {
+                columnar::Writer writer(path);
+                for (std::uint64_t i = 0; i < kRows; ++i)
+                {
+                    const std::uint64_t bits = utils::mixSeed(11, i);
+                    columnar::Row row;
+                    row.seed = bits;
+                    row.width = row.height = 3 + static_cast<std::uint32_t>(bits % 6);
+                    row.mines = 1 + static_cast<std::uint32_t>((bits >> 8) % 5);
+                    row.rounds = 1 + static_cast<std::uint32_t>((bits >> 16) % 12);
+                    row.winner = static_cast<std::uint8_t>((bits >> 24) % 3);
+                    row.collisions = static_cast<std::uint32_t>((bits >> 32) % 4);
+                    writer.add(row);
+                }
+                const bool written = writer.finish() && table.open(path);
+                std::remove(path.c_str()); // the mapping outlives the name
+                return written;
+            }();
+        (void)ready;
+        return table;
+    }
+
+    void runQuery(benchmark::State &state, const columnar::Query &query)
+    {
+        const columnar::Table &table = syntheticTable();
+        columnar::Result result;
+        for (auto _ : state)
+        {
+            columnar::run(table, query, static_cast<unsigned int>(state.range(0)), result);
+            benchmark::DoNotOptimize(result.groups.data());
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(table.rowCount()));
+        state.counters["matched"] = static_cast<double>(result.rowsMatched);
+    }
+
+    void BM_WinRateBySize(benchmark::State &state)
+    {
+        columnar::Query query;
+        query.where.push_back({columnar::Column::Mines, 3, ~std::uint64_t{0}});
+        query.groupBy = {columnar::Column::Width, columnar::Column::Height};
+        runQuery(state, query);
+    }
+    BENCHMARK(BM_WinRateBySize)->ArgName("threads")->Arg(1)->Arg(4)->UseRealTime();
+
+    void BM_FilterOnly(benchmark::State &state)
+    {
+        columnar::Query query;
+        query.where.push_back({columnar::Column::Mines, 3, ~std::uint64_t{0}});
+        query.where.push_back({columnar::Column::Rounds, 0, 5});
+        runQuery(state, query);
+    }
+    BENCHMARK(BM_FilterOnly)->ArgName("threads")->Arg(1)->Arg(4)->UseRealTime();
+}
@@ -0,0 +1,253 @@
+#include "minefield/engine/archive.h"
+#include "minefield/engine/columnar.h"
+#include "minefield/engine/utils.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+// Columnar tables: predicates parsed from text, queries against a scan of every row, and files whose trailer
+// or directory point outside of them refused by Table::open.
+namespace
+{
+    constexpr std::uint64_t kRows = 3 * columnar::kRowGroupRows / 2;
+    constexpr std::size_t kTrailer = 3 * sizeof(std::uint64_t) + sizeof(std::uint32_t);
+    constexpr std::size_t kEntry = sizeof(std::uint64_t) + sizeof(std::uint32_t) + 2 * columnar::kColumns * sizeof(std::uint64_t);
+
+    columnar::Row syntheticRow(std::uint64_t i)
+    {
+        const std::uint64_t bits = utils::mixSeed(7, i);
+        columnar::Row row;
+        row.seed = bits;
+        row.width = row.height = 3 + static_cast<std::uint32_t>(bits % 6);
+        row.mines = 1 + static_cast<std::uint32_t>((bits >> 8) % 5);
+        row.rounds = 1 + static_cast<std::uint32_t>((bits >> 16) % 12);
+        row.winner = static_cast<std::uint8_t>((bits >> 24) % 3);
+        row.collisions = static_cast<std::uint32_t>((bits >> 32) % 4);
+        return row;
+    }
+
+    std::string tablePath(const char *name)
+    {
+        return (std::filesystem::temp_directory_path() / name).string();
+    }
+
+    std::string writeTable(const char *name)
+    {
+        const std::string path = tablePath(name);
+        columnar::Writer writer(path);
+        for (std::uint64_t i = 0; i < kRows; ++i)
+        {
+            writer.add(syntheticRow(i));
+        }
+        EXPECT_TRUE(writer.finish());
+        return path;
+    }
+
+    std::string readFile(const std::string &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    constexpr std::uint64_t kAll = ~std::uint64_t{0};
+
+    // min > max: the predicate matches nothing
+    void expectEmpty(const columnar::Predicate &predicate)
+    {
+        EXPECT_GT(predicate.min, predicate.max);
+    }
+
+    TEST(Columnar, ParsesPredicates)
+    {
+        struct Case
+        {
+            const char *text;
+            columnar::Column column;
+            std::uint64_t min;
+            std::uint64_t max;
+        };
+        const Case cases[] = {
+            {"mines>=3", columnar::Column::Mines, 3, kAll},
+            {"width=4", columnar::Column::Width, 4, 4},
+            {"rounds<10", columnar::Column::Rounds, 0, 9},
+            {"rounds<=10", columnar::Column::Rounds, 0, 10},
+            {"collisions>2", columnar::Column::Collisions, 3, kAll},
+            {"winner=first", columnar::Column::Winner, 1, 1},
+            {"winner>=1", columnar::Column::Winner, 1, kAll},
+            {"seed<=18446744073709551615", columnar::Column::Seed, 0, kAll},
+        };
+        for (const Case &expected : cases)
+        {
+            SCOPED_TRACE(expected.text);
+            columnar::Predicate predicate;
+            ASSERT_TRUE(columnar::parsePredicate(expected.text, predicate));
+            EXPECT_EQ(expected.column, predicate.column);
+            EXPECT_EQ(expected.min, predicate.min);
+            EXPECT_EQ(expected.max, predicate.max);
+        }
+
+        columnar::Predicate predicate;
+        ASSERT_TRUE(columnar::parsePredicate("rounds<0", predicate));
+        expectEmpty(predicate);
+        ASSERT_TRUE(columnar::parsePredicate("seed>18446744073709551615", predicate));
+        expectEmpty(predicate);
+        for (const char *text : {"mines", "depth=3", "mines>=", "mines>=x", "mines=-1", "width=first", "=3"})
+        {
+            EXPECT_FALSE(columnar::parsePredicate(text, predicate)) << text;
+        }
+    }
+
+    // what run has to find, from the rows themselves
+    std::vector<columnar::Group> scan(const columnar::Query &query)
+    {
+        std::map<std::array<std::uint64_t, columnar::kMaxGroupColumns>, columnar::Group> groups;
+        for (std::uint64_t i = 0; i < kRows; ++i)
+        {
+            const columnar::Row row = syntheticRow(i);
+            const auto value = [&](columnar::Column column) -> std::uint64_t
+                {
+                    const std::uint64_t values[columnar::kColumns] = {row.seed, row.width, row.height, row.mines, row.rounds, row.winner, row.collisions};
+                    return values[static_cast<std::size_t>(column)];
+                };
+            bool matched = true;
+            for (const auto &predicate : query.where)
+            {
+                matched = matched && value(predicate.column) >= predicate.min && value(predicate.column) <= predicate.max;
+            }
+            if (!matched)
+            {
+                continue;
+            }
+            std::array<std::uint64_t, columnar::kMaxGroupColumns> key{};
+            for (std::size_t c = 0; c < query.groupBy.size(); ++c)
+            {
+                key[c] = value(query.groupBy[c]);
+            }
+            columnar::Group &group = groups[key];
+            group.key = key;
+            group.rows++;
+            group.outcomes[row.winner]++;
+            group.rounds += row.rounds;
+            group.collisions += row.collisions;
+        }
+        std::vector<columnar::Group> ordered;
+        for (const auto &entry : groups)
+        {
+            ordered.push_back(entry.second);
+        }
+        return ordered;
+    }
+
+    TEST(Columnar, RunMatchesFullScan)
+    {
+        const std::string path = writeTable("minefield-columnar-run-test.mfct");
+        columnar::Table table;
+        ASSERT_TRUE(table.open(path));
+        std::filesystem::remove(path); // the mapping outlives the name
+
+        const auto query = [](std::vector<std::string> where, std::vector<columnar::Column> groupBy)
+            {
+                columnar::Query built;
+                for (const auto &text : where)
+                {
+                    columnar::Predicate predicate;
+                    EXPECT_TRUE(columnar::parsePredicate(text, predicate)) << text;
+                    built.where.push_back(predicate);
+                }
+                built.groupBy = groupBy;
+                return built;
+            };
+        using columnar::Column;
+        const columnar::Query queries[] = {
+            query({}, {}),
+            query({"mines>=3"}, {Column::Width, Column::Height}),
+            query({"rounds<5", "winner=second"}, {Column::Mines}),
+            query({"collisions>0", "width<=6"}, {Column::Width, Column::Mines, Column::Winner, Column::Collisions}),
+            query({"seed<1000000000000000000"}, {Column::Rounds}),
+            query({"width>=9"}, {Column::Width}),
+        };
+        for (std::size_t q = 0; q < std::size(queries); ++q)
+        {
+            const std::vector<columnar::Group> expected = scan(queries[q]);
+            for (unsigned int workers : {1U, 3U})
+            {
+                SCOPED_TRACE(testing::Message() << "query " << q << ", " << workers << " worker(s)");
+                columnar::Result result;
+                ASSERT_TRUE(columnar::run(table, queries[q], workers, result));
+                ASSERT_EQ(expected.size(), result.groups.size());
+                std::uint64_t matched = 0;
+                for (std::size_t g = 0; g < expected.size(); ++g)
+                {
+                    EXPECT_EQ(expected[g].key, result.groups[g].key);
+                    EXPECT_EQ(expected[g].rows, result.groups[g].rows);
+                    for (std::size_t o = 0; o < 3; ++o)
+                    {
+                        EXPECT_EQ(expected[g].outcomes[o], result.groups[g].outcomes[o]);
+                    }
+                    EXPECT_EQ(expected[g].rounds, result.groups[g].rounds);
+                    EXPECT_EQ(expected[g].collisions, result.groups[g].collisions);
+                    matched += expected[g].rows;
+                }
+                EXPECT_EQ(matched, result.rowsMatched);
+                EXPECT_EQ(2U, result.rowGroups);
+            }
+        }
+
+        // no row group holds a width of 9, so none is read
+        columnar::Result result;
+        ASSERT_TRUE(columnar::run(table, queries[5], 1, result));
+        EXPECT_EQ(2U, result.groupsSkipped);
+        EXPECT_EQ(0U, result.rowsScanned);
+
+        columnar::Query tooWide;
+        tooWide.groupBy.assign(columnar::kMaxGroupColumns + 1, Column::Width);
+        EXPECT_FALSE(columnar::run(table, tooWide, 1, result));
+    }
+
+    // opens the table after overwriting a little-endian 64-bit field at offset
+    bool openPatched(const std::string &path, std::string bytes, std::size_t offset, std::uint64_t value)
+    {
+        std::string field;
+        archive::putFixed(field, value);
+        bytes.replace(offset, field.size(), field);
+        {
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        }
+        columnar::Table table;
+        return table.open(path);
+    }
+
+    TEST(Columnar, OpenRefusesCorruptDirectories)
+    {
+        const std::string path = writeTable("minefield-columnar-test.mfct");
+        const std::string bytes = readFile(path);
+        {
+            columnar::Table table;
+            ASSERT_TRUE(table.open(path));
+            EXPECT_EQ(kRows, table.rowCount());
+            ASSERT_EQ(2U, table.groupCount());
+        }
+        const std::size_t groupsField = bytes.size() - kTrailer + sizeof(std::uint64_t);
+        const std::size_t firstEntry = bytes.size() - kTrailer - 2 * kEntry;
+        const std::string patchedPath = tablePath("minefield-columnar-test-patched.mfct");
+
+        // a group count whose directory size wraps around to the real one
+        EXPECT_FALSE(openPatched(patchedPath, bytes, groupsField, 2 + (std::uint64_t{1} << 62)));
+        EXPECT_FALSE(openPatched(patchedPath, bytes, groupsField, 3));
+        // a group offset that wraps around once the size of the group is added
+        EXPECT_FALSE(openPatched(patchedPath, bytes, firstEntry, ~std::uint64_t{0} - 63));
+        EXPECT_TRUE(openPatched(patchedPath, bytes, groupsField, 2));
+
+        std::filesystem::remove(path);
+        std::filesystem::remove(patchedPath);
+    }
+}
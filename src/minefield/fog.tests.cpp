@@ -0,0 +1,97 @@
+#include "minefield/engine/fog.h"
+#include "minefield/engine/game.h"
+#include "minefield/engine/sim.h"
+#include "minefield/engine/utils.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+// fog::Views driven alongside a full game: the spectator render must print what operator<< prints for the
+// board, each seat must own exactly its surviving mines, and the free plane must be the cells not disabled.
+namespace
+{
+    std::string printed(const Board &board)
+    {
+        std::ostringstream out;
+        out << board;
+        return out.str();
+    }
+
+    std::string spectator(const fog::Views &views)
+    {
+        std::ostringstream out;
+        views.render(out, fog::Views::kSpectator);
+        return out.str();
+    }
+
+    bool holds(const std::vector<Position> &positions, unsigned int column, unsigned int row)
+    {
+        for (const auto &position : positions)
+        {
+            if (utils::samePosition(position, {column, row}))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    TEST(FogViews, SpectatorMatchesBoardAndSeatsOwnTheirMines)
+    {
+        for (unsigned int g = 0; g < 300; ++g)
+        {
+            const sim::GameConfig config = {3 + g % 6, 2 + g % 5, 1 + g % 4};
+            Board board = sim::makeBoard(config);
+            fog::Views views(board);
+            Player p1 = makePlayer(false, "CPU 1", config.mines);
+            Player p2 = makePlayer(false, "CPU 2", config.mines);
+            const sim::Seat s1 = {CpuStrategy::Random, utils::mixSeed(g, 1), false};
+            const sim::Seat s2 = {CpuStrategy::Cautious, utils::mixSeed(g, 2), false};
+            for (unsigned int round = 1; round < 50; ++round)
+            {
+                SCOPED_TRACE(testing::Message() << "game " << g << ", round " << round);
+                ASSERT_EQ(printed(board), spectator(views));
+
+                game::clearMines(board);
+                views.beginRound();
+                sim::collectCpuPositions(s1, p1, p1.remainingMines, board, round, p1.currentMines, true);
+                views.placeMines(0, p1.currentMines);
+                sim::collectCpuPositions(s2, p2, p2.remainingMines, board, round, p2.currentMines, true);
+                views.placeMines(1, p2.currentMines);
+                const std::vector<Position> placed = p2.currentMines;
+                game::detectAndRemoveCollisions(p1, p2, board, utils::nullStream());
+                views.refresh(board, placed);
+                for (unsigned int column = 0; column < board.getWidth(); ++column)
+                {
+                    for (unsigned int row = 0; row < board.getHeight(); ++row)
+                    {
+                        ASSERT_EQ(holds(p1.currentMines, column, row), views.ownsMine(0, column, row));
+                        ASSERT_EQ(holds(p2.currentMines, column, row), views.ownsMine(1, column, row));
+                    }
+                }
+
+                sim::collectCpuPositions(s1, p1, p2.remainingMines, board, round, p1.currentGuesses, false);
+                sim::collectCpuPositions(s2, p2, p1.remainingMines, board, round, p2.currentGuesses, false);
+                game::resolveGuesses(p1, p2, board, utils::nullStream());
+                views.refresh(board, p1.currentGuesses);
+                views.refresh(board, p2.currentGuesses);
+                ASSERT_EQ(printed(board), spectator(views));
+                for (unsigned int column = 0; column < board.getWidth(); ++column)
+                {
+                    for (unsigned int row = 0; row < board.getHeight(); ++row)
+                    {
+                        const unsigned int cell = column * board.getHeight() + row;
+                        ASSERT_NE(board.isDisabled(column, row), ((views.freeCells(cell / 64) >> (cell % 64)) & 1) != 0);
+                    }
+                }
+                if (game::checkGameEnd(p1, p2, utils::nullStream()) || utils::countFreeCells(board) == 0)
+                {
+                    break;
+                }
+            }
+        }
+    }
+}
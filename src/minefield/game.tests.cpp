@@ -0,0 +1,108 @@
+#include "minefield/engine/game.h"
+#include "minefield/engine/player.h"
+#include "minefield/engine/utils.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <sstream>
+#include <vector>
+
+// game::resolveGuesses against the pairwise path it replaced: hits of both seats first, then each seat's
+// self-detonations, then the guessed cells disabled. Rounds cover duplicates, self-guesses, mines left on
+// collided cells and positions outside the board.
+namespace
+{
+    void resolvePairwise(Player &p1, Player &p2, Board &board, std::ostream &out)
+    {
+        const unsigned int hits1 = static_cast<unsigned int>(game::countHits(p2, p1.currentGuesses));
+        const unsigned int hits2 = static_cast<unsigned int>(game::countHits(p1, p2.currentGuesses));
+        p2.remainingMines = (p2.remainingMines >= hits1) ? p2.remainingMines - hits1 : 0;
+        p1.remainingMines = (p1.remainingMines >= hits2) ? p1.remainingMines - hits2 : 0;
+
+        const unsigned int selfHits1 = static_cast<unsigned int>(game::resolveSelfDetonation(p1, board, out));
+        const unsigned int selfHits2 = static_cast<unsigned int>(game::resolveSelfDetonation(p2, board, out));
+        p1.remainingMines = (p1.remainingMines >= selfHits1) ? p1.remainingMines - selfHits1 : 0;
+        p2.remainingMines = (p2.remainingMines >= selfHits2) ? p2.remainingMines - selfHits2 : 0;
+
+        game::disableGuessedPositions(p1.currentGuesses, board);
+        game::disableGuessedPositions(p2.currentGuesses, board);
+    }
+
+    // n positions drawn from seed, the first one pushed off the board when offBoard is set
+    std::vector<Position> randomPositions(std::uint64_t seed, unsigned int n, unsigned int width, unsigned int height, bool offBoard)
+    {
+        std::vector<Position> positions;
+        for (unsigned int i = 0; i < n; ++i)
+        {
+            const std::uint64_t bits = utils::mixSeed(seed, i);
+            positions.push_back({static_cast<unsigned int>(bits % width) + ((offBoard && i == 0) ? width : 0), static_cast<unsigned int>((bits >> 20) % height)});
+        }
+        return positions;
+    }
+
+    void expectSamePlayers(const Player &expected, const Player &actual)
+    {
+        EXPECT_EQ(expected.remainingMines, actual.remainingMines);
+        ASSERT_EQ(expected.currentMines.size(), actual.currentMines.size());
+        for (std::size_t i = 0; i < expected.currentMines.size(); ++i)
+        {
+            EXPECT_TRUE(utils::samePosition(expected.currentMines[i], actual.currentMines[i]));
+        }
+    }
+
+    TEST(ResolveGuesses, MatchesPairwisePath)
+    {
+        for (unsigned int t = 0; t < 20000; ++t)
+        {
+            const unsigned int width = 2 + t % 11;
+            const unsigned int height = 2 + t % 7;
+            Board board(width, height, Board::kMaxSimulationSize);
+            for (unsigned int i = 0; i < width * height / 4; ++i)
+            {
+                const std::uint64_t cell = utils::mixSeed(t, 1000 + i) % (width * height);
+                board.safeCellAccess(static_cast<unsigned int>(cell / height), static_cast<unsigned int>(cell % height), [](CellStatusFlags &status){ status |= CellStatusFlags::Disabled; });
+            }
+            Player p1 = makePlayer(false, "CPU 1", t % 6);
+            Player p2 = makePlayer(false, "CPU 2", t % 5);
+            const bool offBoard = t % 50 == 0;
+            p1.currentMines = randomPositions(4ULL * t, t % 6, width, height, offBoard);
+            p2.currentMines = randomPositions(4ULL * t + 1, t % 5, width, height, false);
+            for (const Player *player : {&p1, &p2})
+            {
+                for (const auto &mine : player->currentMines)
+                {
+                    board.safeCellAccess(mine.column, mine.row, [](CellStatusFlags &status){ status |= CellStatusFlags::HasMine; });
+                }
+            }
+            std::ostringstream collisions;
+            if (t % 3 != 0)
+            {
+                game::detectAndRemoveCollisions(p1, p2, board, collisions);
+            }
+            p1.currentGuesses = randomPositions(4ULL * t + 2, t % 7, width, height, offBoard);
+            p2.currentGuesses = randomPositions(4ULL * t + 3, t % 4, width, height, false);
+            if (t % 4 == 0 && !p1.currentMines.empty())
+            {
+                p1.currentGuesses.push_back(p1.currentMines[0]);
+            }
+
+            Board expectedBoard = board;
+            Player expected1 = p1;
+            Player expected2 = p2;
+            std::ostringstream expectedText;
+            resolvePairwise(expected1, expected2, expectedBoard, expectedText);
+            std::ostringstream text;
+            game::resolveGuesses(p1, p2, board, text);
+
+            SCOPED_TRACE(t);
+            expectSamePlayers(expected1, p1);
+            expectSamePlayers(expected2, p2);
+            EXPECT_EQ(expectedText.str(), text.str());
+            for (unsigned int cell = 0; cell < width * height; ++cell)
+            {
+                ASSERT_EQ(static_cast<unsigned int>(expectedBoard.cells()[cell]), static_cast<unsigned int>(board.cells()[cell]));
+            }
+        }
+    }
+}
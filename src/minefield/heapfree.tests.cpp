@@ -0,0 +1,56 @@
+#include "minefield/engine/sim.h"
+#include "minefield/heapfree/fixed.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+// The heap-free core against sim::playGame on the same seeds: outcome, rounds and the number of placements
+// and guesses recorded must agree for every strategy pairing, with and without replanning.
+namespace
+{
+    heapfree::EventRing<4096> events;
+
+    TEST(HeapFree, MatchesSimPlayGame)
+    {
+        const sim::GameConfig configs[] = {{4, 4, 3}, {2, 2, 1}, {3, 5, 2}, {8, 8, 5}, {6, 3, 4}, {16, 16, 8}, {5, 5, 12}};
+        for (const auto &config : configs)
+        {
+            for (std::uint64_t g = 0; g < 500; ++g)
+            {
+                for (int pairing = 0; pairing < 4; ++pairing)
+                {
+                    SCOPED_TRACE(testing::Message() << config.width << "x" << config.height << " with " << config.mines << " mines, game " << g << ", pairing " << pairing);
+                    const bool replan = (pairing & 2) != 0;
+                    const sim::Seat first = {(pairing & 1) ? CpuStrategy::Random : CpuStrategy::Cautious, utils::mixSeed(9, 2 * g), replan};
+                    const sim::Seat second = {(pairing & 1) ? CpuStrategy::Cautious : CpuStrategy::Random, utils::mixSeed(9, 2 * g + 1), replan};
+                    sim::GameReplay replay;
+                    const sim::GameResult expected = sim::playGame(config, first, second, &replay);
+                    sim::GameResult result;
+                    events.clear();
+                    ASSERT_TRUE((heapfree::playGame<16, 16, 12>(config, first, second, result, events)));
+                    ASSERT_EQ(0U, events.dropped());
+                    EXPECT_EQ(expected.outcome, result.outcome);
+                    EXPECT_EQ(expected.rounds, result.rounds);
+
+                    std::uint64_t placed = 0;
+                    std::uint64_t guessed = 0;
+                    for (std::size_t i = 0; i < events.size(); ++i)
+                    {
+                        placed += events[i].kind == heapfree::EventKind::Placed;
+                        guessed += events[i].kind == heapfree::EventKind::Guessed;
+                    }
+                    std::uint64_t expectedPlaced = 0;
+                    std::uint64_t expectedGuessed = 0;
+                    for (const auto &round : replay.rounds)
+                    {
+                        expectedPlaced += round.mines1.size() + round.mines2.size();
+                        expectedGuessed += round.guesses1.size() + round.guesses2.size();
+                    }
+                    EXPECT_EQ(expectedPlaced, placed);
+                    EXPECT_EQ(expectedGuessed, guessed);
+                }
+            }
+        }
+    }
+}
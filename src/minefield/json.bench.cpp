@@ -0,0 +1,161 @@
+#include "minefield/engine/api.h"
+#include "minefield/engine/board.h"
+#include "minefield/engine/json.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Messages per second through the JSON serializer and parser of the local API, without sockets.
+namespace
+{
+    constexpr char kRoundRequest[] = R"({"op":"round","game":1,"mines":[[[0,0],[1,1],[2,2]],[[3,3],[4,4],[5,5]]],"guesses":[[[6,6],[7,7],[0,7]],[[7,0],[1,6],[6,1]]]})";
+
+    void BM_WriteRoundReply(benchmark::State &state)
+    {
+        char buffer[512];
+        for (auto _ : state)
+        {
+            json::Writer reply(buffer, sizeof(buffer));
+            reply.beginObject().key("ok").value(true).key("game").value(std::uint64_t{1}).key("outcome").value("ongoing");
+            reply.key("remaining").beginArray().value(3U).value(2U).endArray();
+            reply.key("next").beginObject();
+            reply.key("mines").beginArray().value(3U).value(2U).endArray();
+            reply.key("guesses").beginArray().value(2U).value(3U).endArray();
+            reply.endObject();
+            reply.key("hits").beginArray().value(1U).value(0U).endArray();
+            reply.key("collisions").value(0U);
+            reply.endObject();
+            reply.finish();
+            benchmark::DoNotOptimize(reply.data());
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+    BENCHMARK(BM_WriteRoundReply);
+
+    void BM_WriteBoard(benchmark::State &state)
+    {
+        const unsigned int size = static_cast<unsigned int>(state.range(0));
+        Board board(size, size, Board::kMaxSimulationSize);
+        std::vector<char> buffer(static_cast<std::size_t>(size) * size + 128);
+        for (auto _ : state)
+        {
+            json::Writer reply(buffer.data(), buffer.size());
+            reply.beginObject().key("ok").value(true).key("game").value(std::uint64_t{1});
+            json::writeBoard(reply, board);
+            reply.endObject();
+            reply.finish();
+            benchmark::DoNotOptimize(reply.data());
+        }
+        state.SetItemsProcessed(state.iterations());
+        state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(buffer.size()));
+    }
+    BENCHMARK(BM_WriteBoard)->Arg(8)->Arg(64)->Arg(1024);
+
+    // the request is copied back every time because parsing unescapes it in place
+    void BM_ParseRoundRequest(benchmark::State &state)
+    {
+        std::vector<json::Token> tokens(256);
+        char text[sizeof(kRoundRequest)];
+        for (auto _ : state)
+        {
+            std::memcpy(text, kRoundRequest, sizeof(kRoundRequest));
+            json::Document request(tokens.data(), tokens.size());
+            benchmark::DoNotOptimize(request.parse(text, sizeof(kRoundRequest) - 1));
+            benchmark::DoNotOptimize(request.find(request.root(), "guesses"));
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+    BENCHMARK(BM_ParseRoundRequest);
+
+    // a whole request through api::Handler: parse, look up the game and write its state
+    void BM_HandleStateRequest(benchmark::State &state)
+    {
+        api::Handler handler;
+        char reply[512];
+        char create[] = R"({"op":"create","width":8,"height":8,"mines":3})";
+        json::Writer created(reply, sizeof(reply));
+        handler.handle(create, sizeof(create) - 1, created);
+
+        constexpr char kStateRequest[] = R"({"op":"state","game":1})";
+        char text[sizeof(kStateRequest)];
+        for (auto _ : state)
+        {
+            std::memcpy(text, kStateRequest, sizeof(kStateRequest));
+            json::Writer out(reply, sizeof(reply));
+            handler.handle(text, sizeof(kStateRequest) - 1, out);
+            out.finish();
+            benchmark::DoNotOptimize(out.data());
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+    BENCHMARK(BM_HandleStateRequest);
+
+    // the same round for every game of a bot: one request per game against one batched request for all of them
+    constexpr char kQuietRound[] = R"("mines":[[[0,0]],[[1,1]]],"guesses":[[],[]])";
+
+    // games get the ids 1 to games
+    void createGames(api::Handler &handler, unsigned int games)
+    {
+        std::string create = R"({"op":"create","width":8,"height":8,"mines":1,"count":)" + std::to_string(games) + "}";
+        std::vector<char> reply(static_cast<std::size_t>(games) * 128 + 64);
+        json::Writer created(reply.data(), reply.size());
+        handler.handle(create.data(), create.size(), created);
+    }
+
+    void BM_HandleRoundPerGame(benchmark::State &state)
+    {
+        const unsigned int games = static_cast<unsigned int>(state.range(0));
+        api::Handler handler;
+        createGames(handler, games);
+        std::vector<std::string> requests;
+        for (unsigned int i = 0; i < games; ++i)
+        {
+            requests.push_back(R"({"op":"round","game":)" + std::to_string(i + 1) + "," + kQuietRound + "}");
+        }
+
+        std::string text;
+        char reply[512];
+        for (auto _ : state)
+        {
+            for (const auto &request : requests)
+            {
+                text = request;
+                json::Writer out(reply, sizeof(reply));
+                handler.handle(text.data(), text.size(), out);
+                out.finish();
+                benchmark::DoNotOptimize(out.data());
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * games);
+    }
+    BENCHMARK(BM_HandleRoundPerGame)->Arg(16)->Arg(1024);
+
+    void BM_HandleRoundsBatched(benchmark::State &state)
+    {
+        const unsigned int games = static_cast<unsigned int>(state.range(0));
+        api::Handler handler;
+        createGames(handler, games);
+        std::string request = R"({"op":"rounds","rounds":[)";
+        for (unsigned int i = 0; i < games; ++i)
+        {
+            request += (i ? "," : "") + std::string(R"({"game":)") + std::to_string(i + 1) + "," + kQuietRound + "}";
+        }
+        request += "]}";
+
+        std::string text;
+        std::vector<char> reply(static_cast<std::size_t>(games) * 160 + 64);
+        for (auto _ : state)
+        {
+            text = request;
+            json::Writer out(reply.data(), reply.size());
+            handler.handle(text.data(), text.size(), out);
+            out.finish();
+            benchmark::DoNotOptimize(out.data());
+        }
+        state.SetItemsProcessed(state.iterations() * games);
+    }
+    BENCHMARK(BM_HandleRoundsBatched)->Arg(16)->Arg(1024);
+}
@@ -0,0 +1,157 @@
+#include "minefield/engine/json.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// The API's JSON: exact writer output with its escapes, strings of every byte through the writer and back
+// through the parser, queue-backed writers that drop what they had appended, and the parser's known answers
+// and refusals.
+namespace
+{
+    std::string written(json::Writer &writer)
+    {
+        return std::string(writer.data(), writer.size());
+    }
+
+    // parses a copy of text, which the document unescapes in place
+    class Parsed
+    {
+    public:
+        explicit Parsed(std::string text, std::size_t capacity = 64)
+            : text(std::move(text))
+            , tokens(capacity)
+            , document(tokens.data(), tokens.size())
+        {
+            valid = document.parse(this->text.data(), this->text.size());
+        }
+
+        std::string text;
+        std::vector<json::Token> tokens;
+        json::Document document;
+        bool valid = false;
+    };
+
+    TEST(Json, WriterOutputAndEscapes)
+    {
+        char buffer[256];
+        json::Writer writer(buffer, sizeof(buffer));
+        writer.beginObject();
+        writer.key("k\"ey").value("a\"b\\c\n\t\r\x01\x1f/\xc3\xa9");
+        writer.key("n").value(~std::uint64_t{0});
+        writer.key("t").value(true).key("f").value(false);
+        writer.key("a").beginArray().value(1U).value(std::uint64_t{2}).beginArray().endArray().endArray();
+        writer.key("o").beginObject().endObject();
+        writer.key("s").beginString();
+        writer.put("raw", 3);
+        writer.endString();
+        writer.endObject();
+        ASSERT_TRUE(writer.finish());
+        EXPECT_EQ("{\"k\\\"ey\":\"a\\\"b\\\\c\\n\\t\\r\\u0001\\u001f/\xc3\xa9\",\"n\":18446744073709551615,\"t\":true,\"f\":false,"
+                  "\"a\":[1,2,[]],\"o\":{},\"s\":\"raw\"}\n",
+            written(writer));
+
+        // a plain writer fails once its buffer is full
+        char small[8];
+        json::Writer full(small, sizeof(small));
+        full.beginArray().value("too long for eight bytes").endArray();
+        EXPECT_TRUE(full.failed());
+        EXPECT_FALSE(full.finish());
+    }
+
+    TEST(Json, StringsRoundTrip)
+    {
+        std::string every;
+        for (int ch = 1; ch < 256; ++ch)
+        {
+            every.push_back(static_cast<char>(ch));
+        }
+        const std::string strings[] = {"", "plain", every, std::string("\\\"\\\"") + "\x7f"};
+        for (const std::string &original : strings)
+        {
+            char buffer[2048];
+            json::Writer writer(buffer, sizeof(buffer));
+            writer.beginObject().key(original).value(original).endObject();
+            ASSERT_TRUE(writer.finish());
+            Parsed parsed(std::string(writer.data(), writer.size() - 1));
+            ASSERT_TRUE(parsed.valid) << parsed.text;
+            const std::uint32_t value = parsed.document.find(parsed.document.root(), original);
+            ASSERT_NE(0U, value);
+            EXPECT_EQ(original, parsed.document.string(value));
+        }
+    }
+
+    TEST(Json, QueueWriterDropsWholeMessages)
+    {
+        std::string queue;
+        char buffer[4];
+        json::Writer writer(buffer, sizeof(buffer), &queue);
+        writer.beginObject().key("first").value(1U).endObject();
+        ASSERT_TRUE(writer.finish());
+        EXPECT_EQ("{\"first\":1}\n", queue);
+
+        // appended to the queue while it was written, then dropped as a whole
+        writer.beginArray().value("a message longer than the buffer");
+        EXPECT_GT(queue.size(), 12U);
+        writer.reset();
+        EXPECT_EQ("{\"first\":1}\n", queue);
+
+        writer.beginArray().value(2U).endArray();
+        ASSERT_TRUE(writer.finish());
+        EXPECT_EQ("{\"first\":1}\n[2]\n", queue);
+    }
+
+    TEST(Json, DocumentKnownAnswers)
+    {
+        Parsed parsed(" { \"a\" : [1, -2.5e3, \"x\\u00e9\\ud83d\\ude00\\/\\n\", true, false, null, {}],\n\"b\":{\"c\":\"d\"} } ");
+        ASSERT_TRUE(parsed.valid);
+        const json::Document &document = parsed.document;
+        ASSERT_EQ(json::TokenType::Object, document.token(document.root()).type);
+        EXPECT_EQ(2U, document.token(document.root()).children);
+
+        const std::uint32_t array = document.find(document.root(), "a");
+        ASSERT_EQ(json::TokenType::Array, document.token(array).type);
+        EXPECT_EQ(7U, document.token(array).children);
+        const json::TokenType types[] = {json::TokenType::Number, json::TokenType::Number, json::TokenType::String, json::TokenType::True,
+            json::TokenType::False, json::TokenType::Null, json::TokenType::Object};
+        std::uint32_t element = document.firstChild(array);
+        for (const json::TokenType type : types)
+        {
+            EXPECT_EQ(type, document.token(element).type);
+            element = document.nextSibling(element);
+        }
+
+        std::uint64_t number = 0;
+        const std::uint32_t one = document.firstChild(array);
+        EXPECT_TRUE(document.number(one, number));
+        EXPECT_EQ(1U, number);
+        EXPECT_FALSE(document.number(document.nextSibling(one), number)); // not an unsigned integer
+        EXPECT_EQ("x\xc3\xa9\xf0\x9f\x98\x80/\n", document.string(document.nextSibling(document.nextSibling(one))));
+
+        const std::uint32_t inner = document.find(document.root(), "b");
+        EXPECT_EQ("d", document.string(document.find(inner, "c")));
+        EXPECT_EQ(0U, document.find(document.root(), "c"));
+        EXPECT_EQ(0U, document.find(array, "a"));
+    }
+
+    TEST(Json, DocumentRefusals)
+    {
+        const char *malformed[] = {"", " ", "{", "[1,]", "[1 2]", "{\"a\"}", "{\"a\":1,}", "{1:2}", "tru", "nul", "1 2", "-", "1.", "1e",
+            "\"open", "\"a\nb\"", "\"\\x\"", "\"\\u12\"", "\"\\uzzzz\"", "\"\\ud800\"", "\"\\ud800\\u0041\""};
+        for (const char *text : malformed)
+        {
+            EXPECT_FALSE(Parsed(text).valid) << text;
+        }
+
+        // 64 levels of nesting are the limit
+        EXPECT_TRUE(Parsed(std::string(64, '[') + std::string(64, ']'), 128).valid);
+        EXPECT_FALSE(Parsed(std::string(65, '[') + std::string(65, ']'), 128).valid);
+
+        // and so is the token array
+        EXPECT_TRUE(Parsed("[1,2,3]", 4).valid);
+        EXPECT_FALSE(Parsed("[1,2,3]", 3).valid);
+    }
+}
@@ -0,0 +1,93 @@
+#include "minefield/engine/board.h"
+#include "minefield/engine/game.h"
+#include "minefield/engine/memory.h"
+#include "minefield/engine/player.h"
+#include "minefield/engine/profiling.h"
+#include "minefield/engine/utils.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+// Whole-board sweeps on a 2048x2048 board with 2000 mines per player, clearMines and collision resolution,
+// with the board on 4 KiB pages and on huge pages. dTLB misses per sweep are reported where perf counters
+// are available, and the label names what actually backed the board.
+namespace
+{
+    constexpr unsigned int kSize = 2048;
+    constexpr unsigned int kMines = 2000;
+
+    struct Field
+    {
+        explicit Field(bool hugePages)
+            : board(makeBoard(hugePages, backing))
+        {
+            // scattered mines, half of the second player's on top of the first player's
+            const std::uint64_t cells = static_cast<std::uint64_t>(kSize) * kSize;
+            for (unsigned int m = 0; m < kMines; ++m)
+            {
+                const std::uint64_t cell1 = utils::mixSeed(1, 2ULL * m) % cells;
+                const std::uint64_t cell2 = utils::mixSeed(1, 2ULL * m + 1) % cells;
+                mines1.push_back({static_cast<unsigned int>(cell1 % kSize), static_cast<unsigned int>(cell1 / kSize)});
+                mines2.push_back((m % 2 == 0) ? mines1.back() : Position{static_cast<unsigned int>(cell2 % kSize), static_cast<unsigned int>(cell2 / kSize)});
+                utils::safeCellAccess(board, mines1.back().column, mines1.back().row, [](CellStatusFlags &status){ status |= CellStatusFlags::HasMine; });
+            }
+        }
+
+        static Board makeBoard(bool hugePages, const char *&backing)
+        {
+            const memory::Counters &counters = memory::counters();
+            const std::uint64_t explicitBefore = counters.explicitHuge;
+            const std::uint64_t transparentBefore = counters.transparent;
+            memory::hugePagesEnabled() = hugePages;
+            Board board(kSize, kSize, Board::kMaxSimulationSize);
+            memory::hugePagesEnabled() = false;
+            backing = counters.explicitHuge > explicitBefore ? "MAP_HUGETLB"
+                : counters.transparent > transparentBefore  ? "transparent huge pages"
+                                                            : "regular heap";
+            return board;
+        }
+
+        const char *backing = nullptr;
+        Board board;
+        std::vector<Position> mines1;
+        std::vector<Position> mines2;
+    };
+
+    template <typename SweepFnT>
+    void runSweeps(benchmark::State &state, SweepFnT sweep)
+    {
+        Field field(state.range(0) != 0);
+        profiling::TlbMissCounter counter;
+        counter.start();
+        for (auto _ : state)
+        {
+            sweep(field);
+        }
+        const std::uint64_t misses = counter.stop();
+        if (counter.valid())
+        {
+            state.counters["dTLB misses"] = benchmark::Counter(static_cast<double>(misses), benchmark::Counter::kAvgIterations);
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(kSize) * kSize);
+        state.SetLabel(field.backing);
+    }
+
+    void BM_ClearMines(benchmark::State &state)
+    {
+        runSweeps(state, [](Field &field){ game::clearMines(field.board); });
+    }
+    BENCHMARK(BM_ClearMines)->ArgName("huge")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+    void BM_Collisions(benchmark::State &state)
+    {
+        runSweeps(state, [](Field &field)
+            {
+                Player p1 = {false, "CPU 1", kMines, field.mines1, {}};
+                Player p2 = {false, "CPU 2", kMines, field.mines2, {}};
+                game::detectAndRemoveCollisions(p1, p2, field.board, utils::nullStream());
+            });
+    }
+    BENCHMARK(BM_Collisions)->ArgName("huge")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+}
@@ -0,0 +1,74 @@
+#include "minefield/engine/game.h"
+#include "minefield/engine/partition.h"
+#include "minefield/engine/player.h"
+#include "minefield/engine/utils.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+// A whole round, collisions then guesses, on a 4096x4096 board with the given number of mines and guesses per
+// seat: the pairwise scans of game::* against the tile-partitioned resolver. The board and players are copied
+// back before every round, outside the timed region.
+namespace
+{
+    constexpr unsigned int kSize = 4096;
+
+    struct Round
+    {
+        Board board{kSize, kSize, Board::kMaxSimulationSize};
+        Player p1 = makePlayer(false, "CPU 1", 0);
+        Player p2 = makePlayer(false, "CPU 2", 0);
+
+        explicit Round(unsigned int count)
+        {
+            p1.remainingMines = p2.remainingMines = count;
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                for (int seat = 0; seat < 2; ++seat)
+                {
+                    Player &player = seat ? p2 : p1;
+                    const std::uint64_t mine = utils::mixSeed(seat, i) % (kSize * kSize);
+                    const std::uint64_t guess = utils::mixSeed(seat + 2, i) % (kSize * kSize);
+                    player.currentMines.push_back({static_cast<unsigned int>(mine / kSize), static_cast<unsigned int>(mine % kSize)});
+                    player.currentGuesses.push_back({static_cast<unsigned int>(guess / kSize), static_cast<unsigned int>(guess % kSize)});
+                    board.safeCellAccess(player.currentMines.back().column, player.currentMines.back().row, [](CellStatusFlags &status){ status |= CellStatusFlags::HasMine; });
+                }
+            }
+        }
+    };
+
+    void BM_SerialRound(benchmark::State &state)
+    {
+        const Round original(static_cast<unsigned int>(state.range(0)));
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            Round round = original;
+            state.ResumeTiming();
+            game::detectAndRemoveCollisions(round.p1, round.p2, round.board, utils::nullStream());
+            game::resolveGuesses(round.p1, round.p2, round.board, utils::nullStream());
+            benchmark::DoNotOptimize(round.p1.remainingMines);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0) * 4);
+    }
+    BENCHMARK(BM_SerialRound)->Arg(4096)->Unit(benchmark::kMillisecond);
+
+    void BM_PartitionedRound(benchmark::State &state)
+    {
+        const Round original(static_cast<unsigned int>(state.range(0)));
+        sim::WorkerPool pool(static_cast<unsigned int>(state.range(1)));
+        partition::RoundResolver resolver(pool, 64);
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            Round round = original;
+            state.ResumeTiming();
+            resolver.detectAndRemoveCollisions(round.p1, round.p2, round.board);
+            benchmark::DoNotOptimize(resolver.resolveGuesses(round.p1, round.p2, round.board));
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0) * 4);
+    }
+    BENCHMARK(BM_PartitionedRound)->Args({4096, 1})->Args({1 << 20, 1})->Args({1 << 20, 4})->Unit(benchmark::kMillisecond)->UseRealTime();
+}
@@ -0,0 +1,95 @@
+#include "minefield/engine/game.h"
+#include "minefield/engine/partition.h"
+#include "minefield/engine/player.h"
+#include "minefield/engine/utils.h"
+#include "positions.tests.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+// RoundResolver against game::* on rounds well above kSerialThreshold, over several tile counts and three
+// rounds per board so disabled cells build up: players, hit totals and every cell must come out the same.
+namespace
+{
+    void placeOn(Board &board, const std::vector<Position> &mines1, const std::vector<Position> &mines2)
+    {
+        game::clearMines(board);
+        for (const auto *mines : {&mines1, &mines2})
+        {
+            for (const auto &mine : *mines)
+            {
+                board.safeCellAccess(mine.column, mine.row, [](CellStatusFlags &status){ status |= CellStatusFlags::HasMine; });
+            }
+        }
+    }
+
+    void expectSameRound(const Player &expected1, const Player &expected2, const Board &expectedBoard, const Player &p1, const Player &p2, const Board &board)
+    {
+        EXPECT_EQ(expected1.remainingMines, p1.remainingMines);
+        EXPECT_EQ(expected2.remainingMines, p2.remainingMines);
+        for (const auto &[expected, actual] : {std::pair{&expected1, &p1}, std::pair{&expected2, &p2}})
+        {
+            ASSERT_EQ(expected->currentMines.size(), actual->currentMines.size());
+            for (std::size_t i = 0; i < expected->currentMines.size(); ++i)
+            {
+                ASSERT_TRUE(utils::samePosition(expected->currentMines[i], actual->currentMines[i]));
+            }
+        }
+        const std::size_t cells = static_cast<std::size_t>(board.getWidth()) * board.getHeight();
+        for (std::size_t cell = 0; cell < cells; ++cell)
+        {
+            ASSERT_EQ(static_cast<unsigned int>(expectedBoard.cells()[cell]), static_cast<unsigned int>(board.cells()[cell]));
+        }
+    }
+
+    TEST(RoundResolver, MatchesGameFunctions)
+    {
+        sim::WorkerPool pool(4);
+        for (unsigned int t = 0; t < 40; ++t)
+        {
+            const unsigned int width = 64 + t * 7;
+            const unsigned int height = 48 + t * 5;
+            partition::RoundResolver resolver(pool, 1U << (t % 8));
+            Board expectedBoard(width, height, Board::kMaxSimulationSize);
+            Board board = expectedBoard;
+            Player expected1 = makePlayer(false, "CPU 1", 100000);
+            Player expected2 = makePlayer(false, "CPU 2", 100000);
+            Player p1 = expected1;
+            Player p2 = expected2;
+            for (unsigned int round = 0; round < 3; ++round)
+            {
+                SCOPED_TRACE(testing::Message() << "board " << t << ", round " << round);
+                const unsigned int count = 500 + t * 200;
+                const std::vector<Position> mines1 = tests::freePositions(10ULL * t + 3 * round, count, board);
+                const std::vector<Position> mines2 = tests::freePositions(10ULL * t + 3 * round + 1, count, board);
+                placeOn(expectedBoard, mines1, mines2);
+                placeOn(board, mines1, mines2);
+                expected1.currentMines = p1.currentMines = mines1;
+                expected2.currentMines = p2.currentMines = mines2;
+                game::detectAndRemoveCollisions(expected1, expected2, expectedBoard, utils::nullStream());
+                resolver.detectAndRemoveCollisions(p1, p2, board);
+                expectSameRound(expected1, expected2, expectedBoard, p1, p2, board);
+
+                // guesses include some of the first seat's own mines, possibly twice
+                std::vector<Position> guesses1 = tests::freePositions(77ULL * t + round, count, board);
+                const std::vector<Position> guesses2 = tests::freePositions(77ULL * t + round + 50, count, board);
+                for (unsigned int i = 0; i < count / 4 && i < mines1.size(); ++i)
+                {
+                    guesses1.push_back(mines1[i]);
+                }
+                expected1.currentGuesses = p1.currentGuesses = guesses1;
+                expected2.currentGuesses = p2.currentGuesses = guesses2;
+                const game::GuessTotals expected = game::resolveGuesses(expected1, expected2, expectedBoard, utils::nullStream());
+                const game::GuessTotals totals = resolver.resolveGuesses(p1, p2, board);
+                for (int seat = 0; seat < 2; ++seat)
+                {
+                    EXPECT_EQ(expected.hits[seat], totals.hits[seat]);
+                    EXPECT_EQ(expected.selfHits[seat], totals.selfHits[seat]);
+                }
+                expectSameRound(expected1, expected2, expectedBoard, p1, p2, board);
+            }
+        }
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "minefield/engine/board.h"
+#include "minefield/engine/utils.h"
+
+#include <cstdint>
+#include <set>
+#include <vector>
+
+namespace tests
+{
+    // up to n distinct cells of the board that are not disabled, drawn from seed; gives up after 10 * n draws
+    inline std::vector<Position> freePositions(std::uint64_t seed, unsigned int n, const Board &board)
+    {
+        const unsigned int height = board.getHeight();
+        const std::uint64_t cells = static_cast<std::uint64_t>(board.getWidth()) * height;
+        std::set<std::uint64_t> seen;
+        std::vector<Position> positions;
+        for (std::uint64_t i = 0; positions.size() < n && i < 10ULL * n; ++i)
+        {
+            const std::uint64_t cell = utils::mixSeed(seed, i) % cells;
+            const Position position = {static_cast<unsigned int>(cell / height), static_cast<unsigned int>(cell % height)};
+            if (!board.isDisabled(position.column, position.row) && seen.insert(cell).second)
+            {
+                positions.push_back(position);
+            }
+        }
+        return positions;
+    }
+}
@@ -0,0 +1,99 @@
+#include "minefield/engine/net.h"
+#include "minefield/engine/shard.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+// Sharded simulation: totals are the same however the games are cut into ranges and whoever plays them,
+// including a coordinator whose workers run here as threads and one of which hangs up holding a range.
+namespace
+{
+    shard::Job makeJob()
+    {
+        shard::Job job;
+        job.config = {5, 4, 3};
+        job.first = CpuStrategy::Cautious;
+        job.second = CpuStrategy::Random;
+        job.seed = 5;
+        job.games = 20000;
+        return job;
+    }
+
+    void expectSameStats(const shard::Stats &expected, const shard::Stats &actual)
+    {
+        EXPECT_EQ(expected.wins, actual.wins);
+        EXPECT_EQ(expected.draws, actual.draws);
+        EXPECT_EQ(expected.losses, actual.losses);
+        EXPECT_EQ(expected.rounds, actual.rounds);
+    }
+
+    TEST(Shard, RangesAddUpToTheWholeRun)
+    {
+        const shard::Job job = makeJob();
+        const shard::Stats whole = shard::playRange(job, 0, job.games);
+        EXPECT_EQ(job.games, whole.games());
+
+        shard::Stats merged;
+        for (std::uint64_t first = 0, size = 1; first < job.games; first += size, size = size * 3 + 1)
+        {
+            merged.merge(shard::playRange(job, first, std::min(size, job.games - first)));
+        }
+        expectSameStats(whole, merged);
+    }
+
+#ifndef _WIN32
+    TEST(Shard, CoordinatorMatchesInProcessRun)
+    {
+        const shard::Job job = makeJob();
+        const shard::Stats expected = shard::playRange(job, 0, job.games);
+        const std::string address = (std::filesystem::temp_directory_path() / ("minefield-shard-test-" + std::to_string(getpid()) + ".sock")).string();
+
+        // connects before the others, takes a range and disconnects without an answer
+        std::thread quitter([&]
+            {
+                int fd = -1;
+                for (int attempt = 0; attempt < 100 && fd < 0; ++attempt)
+                {
+                    fd = net::openSocket(address, false);
+                    if (fd < 0)
+                    {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                    }
+                }
+                std::string buffer;
+                while (fd >= 0 && buffer.find("RANGE") == std::string::npos && net::receive(fd, buffer))
+                {
+                }
+                if (fd >= 0)
+                {
+                    close(fd);
+                }
+            });
+        // one worker starts at once, the other once the quitter is gone
+        std::thread worker([&]{ EXPECT_EQ(0, shard::work(address)); });
+        std::thread late([&]
+            {
+                quitter.join();
+                EXPECT_EQ(0, shard::work(address));
+            });
+
+        shard::CoordinatorReport report;
+        EXPECT_TRUE(shard::coordinate(job, address, 0, 500, nullptr, report)); // no ASSERT: the threads are joined first
+        worker.join();
+        late.join();
+        expectSameStats(expected, report.stats);
+        EXPECT_EQ(1U, report.reissued);
+        EXPECT_EQ(0U, report.respawned);
+    }
+#endif
+}